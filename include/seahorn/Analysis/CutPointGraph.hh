@@ -3,7 +3,7 @@
 
 #include <vector>
 
-#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/IR/Function.h"
 #include "llvm/Pass.h"
@@ -39,6 +39,7 @@ public:
   const CutPoint &target() const { return m_dst; }
 
   void push_back(const BasicBlock *b) { m_bbs.push_back(b); }
+  size_t size() const { return m_bbs.size(); }
 
   typedef boost::indirect_iterator<BlockVector::iterator> iterator;
   typedef boost::indirect_iterator<BlockVector::const_iterator> const_iterator;
@@ -127,11 +128,10 @@ class CutPointGraph : public FunctionPass {
   CpVector m_cps;
   CpEdgeVector m_edges;
 
-  typedef DenseMap<const BasicBlock *, BitVector> BlockBitMap;
-  /// maps a basic block to ids of cut-points it can forward reach
-  BlockBitMap m_fwd;
-  /// maps a basic block to ids of cut-points that can reach it
-  BlockBitMap m_bwd;
+  typedef SmallVector<unsigned, 2> CpIdVector;
+  /// maps a non-cut-point basic block to the sorted ids of cut-points
+  /// that can reach it without going through another cut-point
+  DenseMap<const BasicBlock *, CpIdVector> m_bwd;
 
   DenseMap<const BasicBlock *, boost::shared_ptr<CutPoint>> m_bb;
 
@@ -157,9 +157,8 @@ class CutPointGraph : public FunctionPass {
 
   void computeCutPoints(const Function &F, const TopologicalOrder &topo);
   void orderCutPoints(const Function &F, const TopologicalOrder &topo);
-  void computeFwdReach(const Function &F, const TopologicalOrder &topo);
-  void computeBwdReach(const Function &F, const TopologicalOrder &topo);
   void computeEdges(const Function &F, const TopologicalOrder &topo);
+  size_t memoryUsage() const;
 
   CpEdge *getEdge(CutPoint &s, CutPoint &d);
   CutPoint &getCp(const BasicBlock &bb) {
@@ -178,6 +177,7 @@ public:
     m_cps.clear();
     m_edges.clear();
     m_bb.clear();
+    m_bwd.clear();
   }
 
   bool isCutPoint(const BasicBlock &bb) const { return m_bb.count(&bb) > 0; }
@@ -1,11 +1,15 @@
 #ifndef __BMC__HH_
 #define __BMC__HH_
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/IR/Function.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include "boost/logic/tribool.hpp"
 
+#include <map>
+#include <memory>
+
 #include "seahorn/Expr/Expr.hh"
 #include "seahorn/Expr/Smt/EZ3.hh"
 
@@ -28,6 +32,7 @@ void unsat_core(ZSolver<EZ3> &solver, const ExprVector &f,
 } // namespace bmc_impl
 
 class BmcTrace;
+class VCGen;
 class BmcEngine {
 protected:
   /// symbolic operational semantics
@@ -58,10 +63,18 @@ protected:
   /// path-condition for m_cps
   ExprVector m_side;
 
+  /// counter for fresh literals guarding assumptions
+  unsigned m_numAssumed;
+
+  /// asserts every condition in \p conds under a fresh literal, and adds
+  /// the literals to \p lits
+  void guardAssumptions(const ExprVector &conds, ExprVector &lits);
+
 public:
   BmcEngine(OperationalSemantics &sem, EZ3 &zctx)
       : m_sem(sem), m_efac(sem.efac()), m_result(boost::indeterminate),
-        m_cpg(nullptr), m_fn(nullptr), m_smt_solver(zctx), m_ctxState(m_efac) {
+        m_cpg(nullptr), m_fn(nullptr), m_smt_solver(zctx), m_ctxState(m_efac),
+        m_numAssumed(0) {
 
     z3n_set_param(":model_compress", false);
     // ZParams<EZ3> params(zctx);
@@ -81,6 +94,12 @@ public:
   /// checks satisfiability of the path condition
   virtual boost::tribool solve();
 
+  /// \brief checks satisfiability of the path condition and \p conds
+  ///
+  /// The conditions hold only for this check, so many properties can be
+  /// checked against one encoding
+  virtual boost::tribool solveAssuming(const ExprVector &conds);
+
   /// get model if side condition evaluated to sat.
   virtual ZModel<EZ3> getModel() {
     assert((bool)result());
@@ -114,7 +133,7 @@ public:
   ExprFactory &efac() { return m_efac; }
 
   /// reset the engine
-  void reset();
+  virtual void reset();
 
   /// get side condition
   const ExprVector &getFormula() const { return m_side; }
@@ -129,6 +148,104 @@ public:
   std::vector<SymStore> &getStates() { return m_states; }
 };
 
+/// \brief BMC engine for validating a sequence of similar cut-point traces
+///
+/// The VC of an edge is encoded over the initial values of the registers
+/// that it reads, and is cached per edge and occurrence of the edge in a
+/// trace (a trace may take a loop edge several times). The values of
+/// every cached VC are renamed apart, and the VC is asserted once, under
+/// an activation literal of its own. Validating a trace encodes only the
+/// edge occurrences that no earlier trace had, and connects the edges by
+/// glue: equalities between the registers read by an edge and their
+/// values at the end of the edges before it. The glue of a trace is
+/// asserted under another literal, and the trace is solved under the
+/// literals of its edges and glue, keeping everything the solver learned
+/// about the cached VCs.
+///
+/// The semantics context is shared by all edges and its symbolic state is
+/// replaced before every edge, so the context must not keep any other
+/// state between edges (true for the legacy semantics).
+class IncBmcEngine : public BmcEngine {
+  /// VC of one occurrence of an edge
+  struct EdgeVc {
+    /// activation literal
+    Expr m_lit;
+    /// side-conditions of the edge
+    ExprVector m_side;
+    /// registers read by the edge before being written, each followed by
+    /// its value on entry to the edge
+    ExprVector m_inputs;
+    /// registers of the symbolic state at the end of the edge, each
+    /// followed by its value
+    ExprVector m_outputs;
+    /// true if the VC is in the solver
+    bool m_asserted = false;
+  };
+  using EdgeKey = std::pair<const CpEdge *, unsigned>;
+  std::map<EdgeKey, std::unique_ptr<EdgeVc>> m_cache;
+
+  /// parent of the initial state, source of its fresh values
+  SymStore m_root;
+  /// symbolic state in which every trace starts
+  SymStore m_init;
+  /// side-conditions added by the semantics context
+  ExprVector m_ctxSide;
+  /// side-conditions of the initial state
+  ExprVector m_initSide;
+  /// true if side-conditions of the initial state are in the solver
+  bool m_initAsserted;
+
+  /// VCs of the edges of the current trace
+  SmallVector<EdgeVc *, 8> m_trace;
+  /// glue of the current trace and its activation literal
+  Expr m_glue;
+  Expr m_glueLit;
+  /// true if the glue of the current trace is in the solver
+  bool m_glueAsserted;
+  /// true if the current trace is encoded
+  bool m_encoded;
+  /// activation literals of the current trace
+  ExprVector m_lits;
+
+  /// counter for fresh activation literals
+  unsigned m_numLits;
+  /// edge occurrences that were found in the cache / were encoded
+  unsigned m_numReused;
+  unsigned m_numEncoded;
+
+  Expr mkLit(const std::string &prefix);
+  /// returns the VC of occurrence \p occ of \p edg, encoding it if needed
+  EdgeVc &getEdgeVc(VCGen &vcgen, const CpEdge &edg, unsigned occ);
+
+public:
+  IncBmcEngine(OperationalSemantics &sem, EZ3 &zctx)
+      : BmcEngine(sem, zctx), m_root(sem.efac(), false, true),
+        m_init(m_root, false), m_initAsserted(false), m_glueAsserted(false),
+        m_encoded(false), m_numLits(0), m_numReused(0), m_numEncoded(0) {}
+
+  /// \brief Replaces the current trace by \p cps
+  ///
+  /// Edges of \p cps that were part of an earlier trace are not encoded
+  /// again
+  void setTrace(llvm::ArrayRef<const CutPoint *> cps);
+
+  void encode(bool assert_formula = true) override;
+  boost::tribool solve() override;
+  boost::tribool solveAssuming(const ExprVector &conds) override;
+  void unsatCore(ExprVector &out) override;
+  void reset() override;
+
+  /// number of edges of all traces whose VC was found in the cache
+  unsigned numReusedEdges() const { return m_numReused; }
+  /// number of edges of all traces whose VC was encoded
+  unsigned numEncodedEdges() const { return m_numEncoded; }
+
+  raw_ostream &toSmtLib(raw_ostream &out) override {
+    encode();
+    return m_smt_solver.toSmtLibAssuming(out, m_lits);
+  }
+};
+
 class BmcTrace {
   BmcEngine &m_bmc;
 
@@ -2,6 +2,8 @@
 
 #include "seahorn/Analysis/CanFail.hh"
 #include "seahorn/OperationalSemantics.hh"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/ExecutionEngine/GenericValue.h"
 #include "llvm/IR/DataLayout.h"
@@ -10,6 +12,9 @@
 
 #include <boost/container/flat_set.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace llvm {
 class GetElementPtrInst;
 }
@@ -36,6 +41,32 @@ class Bv2OpSem : public OperationalSemantics {
   const TargetLibraryInfo *m_tli;
   const CanFail *m_canFail;
 
+  /// \brief Information about the instructions of a function that does not
+  /// depend on the execution context. Computed once per function.
+  struct FnTable {
+    const Function *m_fn;
+    /// filter version for which the table was computed
+    unsigned m_filterVersion;
+    /// dense numbering of the arguments and instructions of the function
+    DenseMap<const Value *, unsigned> m_index;
+    /// instructions in program order, numbered after the arguments
+    std::vector<const Instruction *> m_insts;
+    /// per number, whether the value is skipped by the semantics
+    BitVector m_skipped;
+    /// per basic block, the number of its first non-PHI instruction and of
+    /// its terminator
+    DenseMap<const BasicBlock *, std::pair<unsigned, unsigned>> m_blocks;
+  };
+  using FnTablePtr = std::unique_ptr<FnTable>;
+  mutable DenseMap<const Function *, FnTablePtr> m_fnTables;
+  /// most recently used table
+  mutable const FnTable *m_lastFnTable = nullptr;
+
+  /// \brief Returns the table of \p fn, computing it if needed
+  const FnTable &getFnTable(const Function &fn) const;
+  /// \brief Implementation of isSkipped() that does not use FnTable
+  bool computeIsSkipped(const Value &v) const;
+
 public:
   Bv2OpSem(ExprFactory &efac, Pass &pass, const DataLayout &dl,
            TrackLevel trackLvl = MEM);
@@ -67,6 +98,9 @@ public:
   /// \brief Returns symbolic representation of the global errorFlag variable
   Expr errorFlag(const BasicBlock &BB) override;
 
+  /// \brief Hash of the track level and memory model options
+  unsigned execConfig() const override;
+
   void exec(const BasicBlock &bb, OpSemContext &_ctx) override {
     exec(bb, details::ctx(_ctx));
   }
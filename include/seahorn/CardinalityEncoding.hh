@@ -0,0 +1,39 @@
+#pragma once
+/// Encodings of cardinality constraints over Boolean expressions
+
+#include "seahorn/Expr/Expr.hh"
+
+namespace seahorn {
+namespace card {
+using namespace expr;
+
+enum class Encoding {
+  /// pairwise exclusion, quadratic, no auxiliary constants
+  NAIVE,
+  /// sequential counter (Sinz 2005), linear, one auxiliary constant per
+  /// literal and per unit of the bound
+  SEQ_COUNTER,
+  /// commander encoding (Klieber and Kwon 2007), linear, about n/2
+  /// auxiliary constants
+  COMMANDER,
+  /// bit-vector sum of the literals, linear, no auxiliary constants
+  POPCOUNT
+};
+
+/// \brief At most one of \p lits is true
+///
+/// Auxiliary constants are variants of \p name, which must be unique to the
+/// call site. Literals that occur several times count once. The result is
+/// equisatisfiable with the constraint once the auxiliary constants are
+/// existentially quantified.
+Expr mkAtMostOne(const ExprVector &lits, Expr name,
+                 Encoding enc = Encoding::SEQ_COUNTER);
+
+/// \brief At most \p k of \p lits are true
+///
+/// Only SEQ_COUNTER and POPCOUNT encode bounds larger than one; the other
+/// encodings fall back to SEQ_COUNTER for them.
+Expr mkAtMostK(const ExprVector &lits, unsigned k, Expr name,
+               Encoding enc = Encoding::SEQ_COUNTER);
+} // namespace card
+} // namespace seahorn
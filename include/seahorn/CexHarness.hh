@@ -7,10 +7,13 @@
 #include "seahorn/MemSimulator.hh"
 
 namespace llvm {
+class Constant;
+class Function;
 class TargetLibraryInfo;
 class DataLayout;
 class LLVMContext;
 class Module;
+class Type;
 }
 
 namespace seahorn {
@@ -21,7 +24,8 @@ class BmcTraceWrapper;
  * createCexHarness: given a BMC trace (cex) it produces a harness
  * written in LLVM bitcode.  A harness is a LLVM module containing the
  * implementation of all external calls visited by the
- * counterexample.
+ * counterexample. Returns null if the side file of values requested by
+ * --horn-cex-values cannot be written.
  **/
 std::unique_ptr<llvm::Module> createCexHarness(BmcTraceWrapper &trace,
                                                const llvm::DataLayout &dl,
@@ -32,6 +36,15 @@ void dumpLLVMCex(BmcTraceWrapper &trace, llvm::StringRef CexFile,
 		 const llvm::DataLayout &dl, const llvm::TargetLibraryInfo &tli,
 		 llvm::LLVMContext &context);
 
+/// true if the harness provides the return values of \p F, i.e., \p F is
+/// an external function whose results come from the counterexample
+bool isCexHarnessFunction(const llvm::Function &F,
+                          const llvm::TargetLibraryInfo &tli);
+
+/// Converts a value of the counterexample to a constant of type \p ty
+llvm::Constant *exprToLlvm(llvm::Type *ty, Expr e, llvm::LLVMContext &ctx,
+                           const llvm::DataLayout &dl);
+
 } // end namespace seahorn
 
 
@@ -0,0 +1,122 @@
+#ifndef _CEX_INTERPRETER__HH_
+#define _CEX_INTERPRETER__HH_
+
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+namespace llvm {
+class BasicBlock;
+class DataLayout;
+class Function;
+class Instruction;
+class Module;
+class TargetLibraryInfo;
+} // namespace llvm
+
+namespace seahorn {
+
+class BmcTraceWrapper;
+
+/**
+ * Concrete interpreter for the subset of LLVM-IR produced by seapp.
+ *
+ * Executes a function on concrete values without an SMT solver. The
+ * return values of external functions (see isCexHarnessFunction) are
+ * taken, in order, from per-function queues filled from a
+ * counterexample; this is exactly what the harness of createCexHarness
+ * would return when the counterexample is executed natively.
+ *
+ * Memory follows the layout of the static OpSem allocator: functions
+ * whose address is taken and then globals are placed from the start of
+ * the text segment, every frame pre-allocates all of its allocas below
+ * the stack pointer, and the heap grows from the end of the data
+ * segment. Functions and globals get the addresses of the BMC model when
+ * the word size matches the one of the memory manager (setWordSize) and
+ * the semantics tracks pointers. Accesses outside of allocated memory are
+ * reported as faults.
+ */
+class CexInterpreter {
+public:
+  enum class Status {
+    /// reached verifier.error (or a failing verifier.assert)
+    Error,
+    /// returned from the entry function
+    Exit,
+    /// an assumption does not hold
+    AssumeViolated,
+    /// execution left the expected path or ran out of values
+    Diverged,
+    /// memory fault, division by zero, or unreachable code
+    Fault,
+    /// an instruction or function that is not supported
+    Unsupported,
+    /// the step limit was reached
+    StepLimit
+  };
+
+  struct Result {
+    Status status;
+    /// number of executed instructions
+    uint64_t steps;
+    /// instruction at which execution stopped, if any
+    const llvm::Instruction *inst;
+    /// human readable explanation
+    std::string msg;
+  };
+
+private:
+  const llvm::Module &m_module;
+  const llvm::DataLayout &m_dl;
+  const llvm::TargetLibraryInfo &m_tli;
+
+  /// return values of external functions, in order
+  llvm::DenseMap<const llvm::Function *, std::vector<llvm::APInt>> m_values;
+  /// expected sequence of blocks of the entry function, empty if unknown
+  std::vector<const llvm::BasicBlock *> m_path;
+  /// maximal number of instructions to execute
+  uint64_t m_maxSteps;
+  /// word size of the memory of the BMC model, in bytes
+  unsigned m_wordSz;
+
+public:
+  CexInterpreter(const llvm::Module &m, const llvm::DataLayout &dl,
+                 const llvm::TargetLibraryInfo &tli)
+      : m_module(m), m_dl(dl), m_tli(tli), m_maxSteps(10000000),
+        m_wordSz(4) {}
+
+  /// \brief Appends \p v to the values returned by calls to \p fn
+  void addValue(const llvm::Function &fn, const llvm::APInt &v) {
+    m_values[&fn].push_back(v);
+  }
+
+  /// \brief Sets the blocks the entry function is expected to visit
+  void setPath(llvm::ArrayRef<const llvm::BasicBlock *> path) {
+    m_path.assign(path.begin(), path.end());
+  }
+
+  void setMaxSteps(uint64_t steps) { m_maxSteps = steps; }
+
+  /// \brief Sets the word size of the memory of the BMC model, which
+  /// aligns functions and globals (4 by default, as --horn-bv2-word-size)
+  void setWordSize(unsigned bytes) { m_wordSz = bytes; }
+
+  /// \brief Loads the values and the path of a counterexample
+  void loadTrace(BmcTraceWrapper &trace);
+
+  /// \brief Executes \p fn from its entry block
+  Result run(const llvm::Function &fn);
+
+  static const char *statusName(Status s);
+};
+
+llvm::raw_ostream &operator<<(llvm::raw_ostream &o,
+                              const CexInterpreter::Result &r);
+
+} // namespace seahorn
+
+#endif
@@ -44,6 +44,14 @@ public:
   
   /* assert a formula */
   virtual bool add(expr::Expr exp) = 0;
+
+  /* assert a set of formulas */
+  virtual bool add(const expr::ExprVector &exps) {
+    for (expr::Expr e : exps)
+      if (!add(e))
+        return false;
+    return true;
+  }
   
   /** Check for satisfiability */
   virtual SolverResult check() = 0;
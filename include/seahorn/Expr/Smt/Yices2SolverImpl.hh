@@ -4,6 +4,7 @@
 #include "yices.h"
 #include "seahorn/Expr/Smt/Solver.hh"
 #include <map>
+#include <unordered_map>
 
 namespace llvm {
 class raw_ostream;
@@ -27,7 +28,7 @@ public:
   
   using model_ref = typename Solver::model_ref;
   
-  using ycache_t = std::map<expr::Expr, term_t>;
+  using ycache_t = std::unordered_map<expr::Expr, term_t>;
 
   using solver_options = std::map<std::string, std::string>;
   
@@ -56,6 +57,9 @@ public:
   SolverKind get_kind() const { return SolverKind::YICES2;}
   
   bool add(expr::Expr exp);
+
+  /** Assert all formulas of \p exps at once */
+  bool add(const expr::ExprVector &exps);
   
   /** Check for satisfiability */
   SolverResult check();
@@ -617,10 +617,13 @@ private:
   ExprVector m_vars;
   ExprVector m_rules;
   ExprVector m_queries;
+  /// the query, translated by prepareQuery()
+  z3::ast m_zquery;
 
 public:
   ZFixedPoint(Z &z)
-      : z3(z), ctx(z.get_ctx()), fp(z.get_ctx()), efac(z.get_efac()) {}
+      : z3(z), ctx(z.get_ctx()), fp(z.get_ctx()), efac(z.get_efac()),
+        m_zquery(z.get_ctx()) {}
 
   Z &getContext() { return z3; }
 
@@ -671,18 +674,35 @@ public:
   }
 
   boost::tribool query(Expr q = Expr()) {
+    prepareQuery(q);
+    return solve();
+  }
+
+  /**
+   * Translates the query to z3. Once the query is prepared, solve()
+   * does not touch any expression and can run in a thread of its own.
+   */
+  void prepareQuery(Expr q = Expr()) {
     if (q)
       m_queries.push_back(q);
 
     assert(m_queries.size() == 1);
     assert(bind::isBoolConst(m_queries.at(0)) || isOp<TRUE>(m_queries.at(0)) ||
            isOp<FALSE>(m_queries.at(0)));
-    z3::ast ast = z3::ast(z3.toAst(m_queries.at(0)));
-    tribool res = z3l_to_tribool(Z3_fixedpoint_query(ctx, fp, ast));
+    m_zquery = z3::ast(z3.toAst(m_queries.at(0)));
+  }
+
+  /// Solves the prepared query
+  boost::tribool solve() {
+    assert(m_zquery);
+    tribool res = z3l_to_tribool(Z3_fixedpoint_query(ctx, fp, m_zquery));
     ctx.check_error();
     return res;
   }
 
+  /// Interrupts a running solve(). Can be called from any thread
+  void interrupt() { Z3_interrupt(ctx); }
+
   std::string toString(Expr query = Expr()) {
     if (query)
       m_queries.push_back(query);
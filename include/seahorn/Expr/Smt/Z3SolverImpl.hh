@@ -33,6 +33,7 @@ public:
   
   ZSolver<EZ3>& get_solver() { return *m_solver;}
   
+  using Solver::add;
   virtual bool add(expr::Expr exp) override {
     m_solver->assertExpr(exp);
     return true;
@@ -0,0 +1,100 @@
+#ifndef HORN_SIMPLIFY__HH_
+#define HORN_SIMPLIFY__HH_
+/// Simplification of a HornClauseDB before it is given to a CHC solver
+
+#include "seahorn/HornClauseDB.hh"
+#include "seahorn/HornDbModel.hh"
+#include "seahorn/HornModelConverter.hh"
+
+#include "seahorn/Expr/Expr.hh"
+#include "seahorn/Expr/Smt/EZ3.hh"
+
+#include <map>
+#include <vector>
+
+namespace seahorn {
+
+/**
+ * Maps answers about a simplified HornClauseDB back to the original one.
+ *
+ * The simplifier records every transformation as a step. A model of the
+ * simplified db is converted by undoing the steps in reverse order, so
+ * that each step sees a model of the db as it was right after the step.
+ *
+ * Every rule of the simplified db remembers the original rules it was
+ * built from, which is how a counterexample is mapped back.
+ */
+class HornSimplifyModelConverter : public HornModelConverter {
+  friend class HornSimplifier;
+
+  /// Defines m_rel as the disjunction of its m_defs. Each definition is
+  /// a formula over m_args, existentially quantified over the first
+  /// component. Relation applications in a definition stand for their
+  /// own definitions in the model.
+  struct Step {
+    Expr m_rel;
+    ExprVector m_args;
+    std::vector<std::pair<ExprVector, Expr>> m_defs;
+  };
+
+  EZ3 &m_zctx;
+  std::vector<Step> m_steps;
+  /// relations of the original db
+  ExprVector m_rels;
+  /// rules of the original db
+  ExprVector m_rules;
+  /// relations of the original db, of the simplified db, and of every
+  /// db in between
+  ExprSet m_allRels;
+
+  /// head and body relations of a rule of the simplified db
+  typedef std::pair<Expr, ExprVector> signature_type;
+  /// original rules of each rule of the simplified db
+  std::map<signature_type, std::vector<unsigned>> m_traces;
+
+  Expr applyModel(HornDbModel &model, Expr e);
+
+public:
+  HornSimplifyModelConverter(EZ3 &zctx) : m_zctx(zctx) {}
+
+  /// Converts a model of the simplified db into a model of the original
+  /// db. Returns false if a quantifier could not be eliminated.
+  bool convert(HornDbModel &in, HornDbModel &out) override;
+
+  /// Maps the rules along a counterexample of the simplified db (as
+  /// returned by ZFixedPoint::getCexRules) to rules of the original db.
+  /// The trace is mapped at the level of relations: the values of the
+  /// arguments are lost. Returns false if a rule is unknown.
+  bool convertCex(const ExprVector &in, ExprVector &out);
+};
+
+/// Before/after statistics of simplifyHornClauseDB
+struct HornSimplifyStats {
+  unsigned m_rulesBefore = 0;
+  unsigned m_rulesAfter = 0;
+  unsigned m_relsBefore = 0;
+  unsigned m_relsAfter = 0;
+  unsigned m_argsBefore = 0;
+  unsigned m_argsAfter = 0;
+};
+
+/**
+ * Simplifies \p db into the empty db \p tdb:
+ *  - removes relations outside the cone of influence of the queries, and
+ *    relations that cannot be derived,
+ *  - inlines relations that are used exactly once,
+ *  - removes arguments that are never used, or always take the same
+ *    constant value,
+ *  - removes arguments that are only passed along to other removed
+ *    arguments, and arguments that always equal another argument,
+ *  - removes rules that are subsumed by other rules.
+ *
+ * Relations with constraints or invariants are neither inlined nor
+ * sliced. \p mc records how to map answers about \p tdb back to \p db.
+ */
+HornSimplifyStats simplifyHornClauseDB(HornClauseDB &db, HornClauseDB &tdb,
+                                       HornSimplifyModelConverter &mc);
+
+} // namespace seahorn
+
+#endif
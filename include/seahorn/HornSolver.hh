@@ -5,6 +5,7 @@
 #include "llvm/IR/Module.h"
 #include "boost/logic/tribool.hpp"
 #include "seahorn/HornDbModel.hh"
+#include "seahorn/HornSimplify.hh"
 
 #include "seahorn/Expr/Smt/EZ3.hh"
 
@@ -15,8 +16,18 @@ namespace seahorn
   class HornSolver : public llvm::ModulePass
   {
     boost::tribool m_result;
+    /// context of m_fp when it is not the context of HornifyModule
+    std::unique_ptr<EZ3> m_zctx;
     std::unique_ptr<ZFixedPoint <EZ3> >  m_fp;
-    
+    /// simplified clauses solved by m_fp, and how to map answers back
+    std::unique_ptr<HornClauseDB> m_sdb;
+    std::unique_ptr<HornSimplifyModelConverter> m_mc;
+
+    void setParams (ZParams<EZ3> &params);
+    void solve (HornClauseDB &db);
+    boost::tribool runPortfolio (HornClauseDB &db);
+    void reportResult (Module &M);
+
     void printCex ();
     void estimateSizeInvars (Module &M);
 
@@ -35,7 +46,18 @@ namespace seahorn
     ZFixedPoint<EZ3>& getZFixedPoint () {return *m_fp;}
     
     boost::tribool getResult () {return m_result;}
-    void releaseMemory () {m_fp.reset (nullptr);}
+
+    /// model of the clauses of HornifyModule
+    void getModel (HornDbModel &model);
+    /// rules of the clauses of HornifyModule along the counterexample
+    void getCexRules (ExprVector &rules);
+
+    void releaseMemory () {
+      m_fp.reset (nullptr);
+      m_zctx.reset (nullptr);
+      m_mc.reset (nullptr);
+      m_sdb.reset (nullptr);
+    }
     
   };
 
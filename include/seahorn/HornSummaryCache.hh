@@ -0,0 +1,74 @@
+#ifndef HORN_SUMMARY_CACHE__HH_
+#define HORN_SUMMARY_CACHE__HH_
+/// Persistent cache of proved function invariants across verification runs
+
+#include "seahorn/HornClauseDB.hh"
+#include "seahorn/HornDbModel.hh"
+#include "seahorn/HornifyModule.hh"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace seahorn {
+
+/**
+ * On-disk cache of the invariants of the summary and basic block
+ * predicates of a function.
+ *
+ * An entry is keyed by a hash of the IR of the function and of all the
+ * functions it transitively calls, of the global variables they refer to,
+ * of the encoding options of the run and of the version of seahorn. The
+ * predicates of a function only depend on the code of the function and of
+ * its callees, so an invariant that was proved in one run holds in every
+ * run with the same key, whatever the caller.
+ *
+ * Functions that make indirect calls are not cached.
+ *
+ * Every entry records what the arguments of its predicate stand for
+ * (function arguments, instructions by position in the function, global
+ * variables), and is ignored if the predicate of the run has different
+ * arguments.
+ */
+class HornSummaryCache {
+  std::string m_dir;
+  HornifyModule &m_hm;
+  llvm::DenseMap<const llvm::Function *, std::string> m_keys;
+
+  /// hash of \p F, or the empty string if \p F cannot be cached
+  const std::string &key(const llvm::Function &F);
+  /// predicates of \p F, named independently of the module
+  std::vector<std::pair<std::string, Expr>> relations(const llvm::Function &F);
+  /// what the arguments of \p rel, a predicate of \p F, stand for. The
+  /// order of the arguments depends on the order in which expressions were
+  /// created, so an entry is only loaded into a predicate of the same
+  /// signature
+  std::string signature(const llvm::Function &F, Expr rel);
+  std::string path(const std::string &key) const;
+
+public:
+  HornSummaryCache(llvm::StringRef dir, HornifyModule &hm)
+      : m_dir(dir), m_hm(hm) {}
+
+  /// Adds the cached invariants of the functions of \p M to \p db.
+  /// Returns the number of functions found in the cache.
+  unsigned load(llvm::Module &M, HornClauseDB &db);
+
+  /// Stores the invariants of the functions of \p M in \p model, which
+  /// must be a model of the clauses of HornifyModule. Returns the number
+  /// of functions stored.
+  unsigned store(llvm::Module &M, HornDbModel &model);
+};
+
+/// Records the options of the run that select the encoding, i.e., the
+/// options named horn-*. They are part of the key of every entry.
+void setHornSummaryCacheOptions(int argc, char **argv);
+
+} // namespace seahorn
+
+#endif
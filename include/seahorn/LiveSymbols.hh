@@ -1,6 +1,7 @@
 #ifndef __LIVE_SYMBOLS__HH_
 #define __LIVE_SYMBOLS__HH_
 
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/IR/Function.h"
 
@@ -8,38 +9,43 @@
 #include "seahorn/SymStore.hh"
 #include "seahorn/Expr/Expr.hh"
 
+#include <unordered_map>
+
 namespace seahorn {
 using namespace llvm;
 using namespace expr;
 
+/// Live symbols of a basic block. Symbols are represented by their
+/// index in the symbol table of the enclosing LiveSymbols.
 class LiveInfo {
-  ExprVector m_live;
-  ExprVector m_defs;
-  llvm::SmallVector<ExprVector, 16> m_edgeDefs;
+  llvm::BitVector m_live;
+  llvm::BitVector m_defs;
+  llvm::SmallVector<llvm::BitVector, 2> m_edgeDefs;
+
+  /// m_live as a sorted vector of symbols. Computed on demand
+  mutable ExprVector m_liveSyms;
+  mutable bool m_liveSymsValid = false;
 
 public:
   LiveInfo() {}
-  LiveInfo(const LiveInfo &o)
-      : m_live(o.m_live), m_defs(o.m_defs), m_edgeDefs(o.m_edgeDefs) {}
-
-  LiveInfo &operator=(LiveInfo o) {
-    std::swap(m_live, o.m_live);
-    std::swap(m_defs, o.m_defs);
-    std::swap(m_edgeDefs, o.m_edgeDefs);
-    return *this;
-  }
 
-  void setLive(const ExprVector &l);
-  void setDefs(const ExprVector &d);
-  void addEdgeDef(const ExprVector &d);
-  /// add live variables. These should not be already live
-  void addLive(ExprVector &v);
-  /// like addLive but v can contain variables already live
-  void unionLive(ExprVector &v);
-
-  const ExprVector &live() const { return m_live; }
-  const ExprVector &defs() const { return m_defs; }
-  const ExprVector &edge_defs(unsigned i) const { return m_edgeDefs[i]; }
+  void setLive(llvm::BitVector l) {
+    m_live = std::move(l);
+    m_liveSymsValid = false;
+  }
+  void setDefs(llvm::BitVector d) { m_defs = std::move(d); }
+  void addEdgeDef(llvm::BitVector d) { m_edgeDefs.push_back(std::move(d)); }
+  /// add live variables. Returns true if any of them was not already live
+  bool addLive(const llvm::BitVector &v);
+  /// grow all sets to hold \p sz symbols
+  void resize(unsigned sz);
+
+  const llvm::BitVector &live() const { return m_live; }
+  const llvm::BitVector &defs() const { return m_defs; }
+  const llvm::BitVector &edge_defs(unsigned i) const { return m_edgeDefs[i]; }
+
+  /// live symbols as a sorted vector, given the symbol table \p symbols
+  const ExprVector &liveSymbols(const ExprVector &symbols) const;
 };
 
 /// Computes the set of live symbols (variables) at every BasicBlock
@@ -57,6 +63,15 @@ class LiveSymbols {
   DenseMap<const BasicBlock *, LiveInfo> m_liveInfo;
   Expr trueE;
 
+  /// symbols of the function, numbered densely in order of discovery
+  ExprVector m_symbols;
+  std::unordered_map<Expr, unsigned> m_symbolIds;
+
+  /// returns the index of \p v in the symbol table. Adds it if needed
+  unsigned symbolId(Expr v);
+  /// returns \p vec as a set of symbol indexes
+  llvm::BitVector toBits(const ExprVector &vec);
+
   void symExec(OpSemContext &ctx, const BasicBlock &bb);
   void symExecPhi(OpSemContext &ctx, const BasicBlock &bb,
                   const BasicBlock &from);
@@ -77,7 +92,7 @@ public:
   LiveSymbols(const LiveSymbols &o)
       : m_f(o.m_f), m_efac(o.m_efac), m_sem(o.m_sem), m_side(),
         m_rtopo(o.m_rtopo), m_gstore(o.m_gstore), m_liveInfo(o.m_liveInfo),
-        trueE(o.trueE) {}
+        trueE(o.trueE), m_symbols(o.m_symbols), m_symbolIds(o.m_symbolIds) {}
 
   void run();
   void operator()() { run(); }
@@ -169,6 +169,27 @@ struct FunctionInfo {
   FunctionInfo() = default;
 };
 
+/// \brief Symbolic summary of executing a basic block
+///
+/// Obtained by executing a block once over placeholder values for its
+/// inputs. Used to re-execute the block by substituting actual values
+/// for the placeholders.
+struct BbSummary {
+  /// Placeholder for the path condition
+  Expr pathCond;
+  /// Registers read by the block and placeholders for their initial values
+  ExprVector inRegs;
+  ExprVector inVals;
+  /// Registers havoced by the block and the fresh values they received
+  ExprVector freshRegs;
+  ExprVector freshVals;
+  /// Registers written by the block and their final values
+  ExprVector outRegs;
+  ExprVector outVals;
+  /// Side condition contributed by the block
+  ExprVector side;
+};
+
 class OperationalSemantics {
 protected:
   ExprFactory &m_efac;
@@ -179,6 +200,14 @@ protected:
   using FuncInfoMap = llvm::DenseMap<const llvm::Function *, FunctionInfo>;
   FuncInfoMap m_fmap;
 
+  /// maps llvm::BasicBlock to its symbolic summary
+  using BbSummaryMap = llvm::DenseMap<const llvm::BasicBlock *, BbSummary>;
+  BbSummaryMap m_bbSummaries;
+  /// configuration under which the summaries were computed
+  unsigned m_bbSummaryCfg = 0;
+  /// incremented whenever the filter changes
+  unsigned m_filterVersion = 0;
+
   Expr trueE;
   Expr falseE;
   Expr m_errorFlag;
@@ -197,11 +226,42 @@ public:
   ExprFactory &getExprFactory() const { return m_efac; }
   ExprFactory &efac() const { return m_efac; }
 
-  void resetFilter() {m_filter.clear();}
-  void addToFilter(const llvm::Value& v) {m_filter.insert(&v);}
+  void resetFilter() {
+    m_filter.clear();
+    m_bbSummaries.clear();
+    ++m_filterVersion;
+  }
+  void addToFilter(const llvm::Value &v) {
+    m_filter.insert(&v);
+    m_bbSummaries.clear();
+    ++m_filterVersion;
+  }
   template <typename Iterator>
   void addToFilter(Iterator begin, Iterator end) {
     m_filter.insert(begin, end);
+    m_bbSummaries.clear();
+    ++m_filterVersion;
+  }
+
+  /// \brief Identifies the configuration (e.g., track level and memory
+  /// model) that determines the result of exec()
+  ///
+  /// Summaries of basic blocks are discarded whenever it changes
+  virtual unsigned execConfig() const { return 0; }
+
+  /// \brief Returns a cached summary of \p bb, or nullptr if there is none
+  const BbSummary *getBbSummary(const llvm::BasicBlock &bb) {
+    unsigned cfg = execConfig();
+    if (cfg != m_bbSummaryCfg) {
+      m_bbSummaries.clear();
+      m_bbSummaryCfg = cfg;
+    }
+    auto it = m_bbSummaries.find(&bb);
+    return it == m_bbSummaries.end() ? nullptr : &it->second;
+  }
+  /// \brief Caches summary \p sum of \p bb
+  const BbSummary &addBbSummary(const llvm::BasicBlock &bb, BbSummary sum) {
+    return m_bbSummaries[&bb] = std::move(sum);
   }
 
   /// \brief Create context/state for OpSem using given symstore and side
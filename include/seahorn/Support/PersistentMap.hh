@@ -0,0 +1,338 @@
+#ifndef __PERSISTENT_MAP__HH_
+#define __PERSISTENT_MAP__HH_
+/**
+ * A persistent hash map implemented as a hash array mapped trie.
+ *
+ * Copying a map is O(1): the copy shares all nodes with the original.
+ * A node is copied only when it is shared and about to be modified, so
+ * updating a map that is not shared happens in place, and updating a
+ * copy copies only the nodes on the path to the updated key.
+ *
+ * Every node has 32 slots indexed by 5 bits of the hash of a key. A
+ * slot holds either an entry or a child. Entries and children are kept
+ * in dense arrays, ordered by slot, allocated together with the node.
+ * Keys whose hashes agree on all 64 bits end up in a node below the
+ * last level, which keeps a plain list of entries.
+ */
+#include "boost/intrusive_ptr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace seahorn {
+
+template <typename K, typename V, typename Hash = std::hash<K>>
+class PersistentMap {
+public:
+  typedef std::pair<K, V> value_type;
+
+private:
+  static const unsigned BITS = 5;
+  static const unsigned HASH_BITS = 64;
+
+  struct Node;
+  typedef boost::intrusive_ptr<Node> NodePtr;
+
+  /// A node and, in the same allocation, its entries followed by its
+  /// children
+  struct Node {
+    unsigned m_refs;
+    /// slots holding an entry and slots holding a child
+    uint32_t m_dataMap;
+    uint32_t m_nodeMap;
+    unsigned m_numData;
+    unsigned m_numKids;
+
+    static size_t dataOffset() {
+      return alignUp(sizeof(Node), alignof(value_type));
+    }
+    static size_t kidsOffset(unsigned numData) {
+      return alignUp(dataOffset() + numData * sizeof(value_type),
+                     alignof(NodePtr));
+    }
+
+    value_type *data() {
+      return reinterpret_cast<value_type *>(reinterpret_cast<char *>(this) +
+                                            dataOffset());
+    }
+    const value_type *data() const {
+      return const_cast<Node *>(this)->data();
+    }
+    NodePtr *kids() {
+      return reinterpret_cast<NodePtr *>(reinterpret_cast<char *>(this) +
+                                         kidsOffset(m_numData));
+    }
+    const NodePtr *kids() const { return const_cast<Node *>(this)->kids(); }
+
+    /// Allocates a node. The caller constructs the entries and children
+    static Node *alloc(uint32_t dataMap, uint32_t nodeMap, unsigned numData,
+                       unsigned numKids) {
+      void *mem =
+          ::operator new(kidsOffset(numData) + numKids * sizeof(NodePtr));
+      Node *n = static_cast<Node *>(mem);
+      n->m_refs = 0;
+      n->m_dataMap = dataMap;
+      n->m_nodeMap = nodeMap;
+      n->m_numData = numData;
+      n->m_numKids = numKids;
+      return n;
+    }
+
+    friend void intrusive_ptr_add_ref(Node *n) { ++n->m_refs; }
+    friend void intrusive_ptr_release(Node *n) {
+      if (--n->m_refs > 0)
+        return;
+      for (unsigned i = 0; i < n->m_numData; ++i)
+        n->data()[i].~value_type();
+      for (unsigned i = 0; i < n->m_numKids; ++i)
+        n->kids()[i].~NodePtr();
+      ::operator delete(n);
+    }
+  };
+
+  NodePtr m_root;
+  size_t m_size;
+
+  static size_t alignUp(size_t sz, size_t align) {
+    return (sz + align - 1) / align * align;
+  }
+
+  /// The hash is used as is: keys with consecutive hashes (e.g., ids)
+  /// fill the trie densely and keep it shallow
+  static uint64_t hash(const K &k) { return Hash()(k); }
+  static uint32_t bit(uint64_t h, unsigned shift) {
+    return uint32_t(1) << ((h >> shift) & 31);
+  }
+  /// position of \p bit among the bits of \p map
+  static unsigned index(uint32_t map, uint32_t bit) {
+    // -- __builtin_popcount is a library call unless the target is known
+    // -- to have a popcount instruction
+    uint32_t v = map & (bit - 1);
+    v = v - ((v >> 1) & 0x55555555);
+    v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+    return (((v + (v >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+  }
+
+  /// Moves \p src to \p dst if \p move is set, and copies it otherwise
+  template <typename T> static void transfer(bool move, T &src, T *dst) {
+    if (move)
+      new (dst) T(std::move(src));
+    else
+      new (dst) T(src);
+  }
+
+  /// Returns \p n ready to be modified in place, copying it if it is
+  /// shared
+  static Node *own(NodePtr &n) {
+    if (n->m_refs == 1)
+      return n.get();
+    Node *c =
+        Node::alloc(n->m_dataMap, n->m_nodeMap, n->m_numData, n->m_numKids);
+    for (unsigned i = 0; i < n->m_numData; ++i)
+      new (c->data() + i) value_type(n->data()[i]);
+    for (unsigned i = 0; i < n->m_numKids; ++i)
+      new (c->kids() + i) NodePtr(n->kids()[i]);
+    n = c;
+    return c;
+  }
+
+  /// Replaces \p n by a copy of it with entry \p e at position \p i
+  static void insertData(NodePtr &n, uint32_t dataMap, unsigned i,
+                         const value_type &e) {
+    bool move = n->m_refs == 1;
+    Node *c = Node::alloc(dataMap, n->m_nodeMap, n->m_numData + 1,
+                          n->m_numKids);
+    for (unsigned k = 0; k < n->m_numData; ++k)
+      transfer(move, n->data()[k], c->data() + (k < i ? k : k + 1));
+    new (c->data() + i) value_type(e);
+    for (unsigned k = 0; k < n->m_numKids; ++k)
+      transfer(move, n->kids()[k], c->kids() + k);
+    n = c;
+  }
+
+  /// Replaces \p n by a copy of it in which the entry at position \p i,
+  /// in slot \p b, is moved to a new child at level \p shift. Returns
+  /// the new child.
+  static NodePtr &pushDown(NodePtr &n, uint32_t b, unsigned i,
+                           unsigned shift) {
+    bool move = n->m_refs == 1;
+    value_type &e = n->data()[i];
+    Node *kid = Node::alloc(shift < HASH_BITS ? bit(hash(e.first), shift) : 0,
+                            0, 1, 0);
+    transfer(move, e, kid->data());
+
+    uint32_t nodeMap = n->m_nodeMap | b;
+    unsigned j = index(nodeMap, b);
+    Node *c = Node::alloc(n->m_dataMap & ~b, nodeMap, n->m_numData - 1,
+                          n->m_numKids + 1);
+    for (unsigned k = 0; k < n->m_numData; ++k)
+      if (k != i)
+        transfer(move, n->data()[k], c->data() + (k < i ? k : k - 1));
+    for (unsigned k = 0; k < n->m_numKids; ++k)
+      transfer(move, n->kids()[k], c->kids() + (k < j ? k : k + 1));
+    new (c->kids() + j) NodePtr(kid);
+    n = c;
+    return c->kids()[j];
+  }
+
+public:
+  class const_iterator {
+    /// path to the current entry: a node and a position in it. The
+    /// positions of a node enumerate its entries and then its children
+    std::vector<std::pair<const Node *, unsigned>> m_stack;
+
+    /// moves to the next entry, starting at the current position
+    void settle() {
+      while (!m_stack.empty()) {
+        const Node *n = m_stack.back().first;
+        unsigned pos = m_stack.back().second;
+        if (pos < n->m_numData)
+          return;
+        pos -= n->m_numData;
+        if (pos < n->m_numKids) {
+          ++m_stack.back().second;
+          m_stack.push_back({n->kids()[pos].get(), 0});
+          continue;
+        }
+        m_stack.pop_back();
+      }
+    }
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef const typename PersistentMap::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef value_type *pointer;
+    typedef value_type &reference;
+
+    const_iterator() {}
+    explicit const_iterator(const Node *root) {
+      if (root) {
+        m_stack.push_back({root, 0});
+        settle();
+      }
+    }
+
+    reference operator*() const {
+      return m_stack.back().first->data()[m_stack.back().second];
+    }
+    pointer operator->() const { return &**this; }
+
+    const_iterator &operator++() {
+      ++m_stack.back().second;
+      settle();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator res = *this;
+      ++*this;
+      return res;
+    }
+
+    bool operator==(const const_iterator &o) const {
+      return m_stack == o.m_stack;
+    }
+    bool operator!=(const const_iterator &o) const { return !(*this == o); }
+  };
+  typedef const_iterator iterator;
+
+  PersistentMap() : m_size(0) {}
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  void clear() {
+    m_root.reset();
+    m_size = 0;
+  }
+
+  void swap(PersistentMap &o) {
+    m_root.swap(o.m_root);
+    std::swap(m_size, o.m_size);
+  }
+
+  /// Returns the value of \p k, or null if \p k is not in the map
+  const V *lookup(const K &k) const {
+    uint64_t h = hash(k);
+    const Node *n = m_root.get();
+    for (unsigned shift = 0; n; shift += BITS) {
+      if (shift >= HASH_BITS) {
+        for (unsigned i = 0; i < n->m_numData; ++i)
+          if (n->data()[i].first == k)
+            return &n->data()[i].second;
+        return nullptr;
+      }
+      uint32_t b = bit(h, shift);
+      if (n->m_dataMap & b) {
+        const value_type &e = n->data()[index(n->m_dataMap, b)];
+        return e.first == k ? &e.second : nullptr;
+      }
+      if (!(n->m_nodeMap & b))
+        return nullptr;
+      n = n->kids()[index(n->m_nodeMap, b)].get();
+    }
+    return nullptr;
+  }
+
+  size_t count(const K &k) const { return lookup(k) ? 1 : 0; }
+
+  /// Maps \p k to \p v. Returns true if \p k was not in the map
+  bool insert_or_assign(const K &k, const V &v) {
+    uint64_t h = hash(k);
+    if (!m_root)
+      m_root = Node::alloc(0, 0, 0, 0);
+
+    NodePtr *np = &m_root;
+    for (unsigned shift = 0;; shift += BITS) {
+      Node *n = np->get();
+
+      if (shift >= HASH_BITS) {
+        for (unsigned i = 0; i < n->m_numData; ++i)
+          if (n->data()[i].first == k) {
+            n = own(*np);
+            n->data()[i].second = v;
+            return false;
+          }
+        insertData(*np, 0, n->m_numData, value_type(k, v));
+        ++m_size;
+        return true;
+      }
+
+      uint32_t b = bit(h, shift);
+      if (n->m_nodeMap & b) {
+        unsigned j = index(n->m_nodeMap, b);
+        n = own(*np);
+        np = &n->kids()[j];
+        continue;
+      }
+
+      unsigned i = index(n->m_dataMap, b);
+      if (!(n->m_dataMap & b)) {
+        insertData(*np, n->m_dataMap | b, i, value_type(k, v));
+        ++m_size;
+        return true;
+      }
+
+      if (n->data()[i].first == k) {
+        n = own(*np);
+        n->data()[i].second = v;
+        return false;
+      }
+
+      // -- k and the entry in its slot go one level down
+      np = &pushDown(*np, b, i, shift + BITS);
+    }
+  }
+
+  const_iterator begin() const { return const_iterator(m_root.get()); }
+  const_iterator end() const { return const_iterator(); }
+};
+
+} // namespace seahorn
+
+#endif
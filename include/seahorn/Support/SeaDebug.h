@@ -1,25 +1,50 @@
 #ifndef __SEA__DEBUG__HPP_
 #define __SEA__DEBUG__HPP_
 #include "SeaAssert.h"
+#include <atomic>
 #include <set>
 #include <string>
 
 namespace seahorn {
 
 #ifndef NSEALOG
+/// LOG(TAG, CODE) executes CODE if the log tag TAG is enabled.
+///
+/// When no tag is enabled, the cost is a single branch. Otherwise, every
+/// call site looks its tag up once and then only reads the flag of the
+/// tag, so tags can be enabled and disabled at any time.
 #define LOG(TAG, CODE)                                                         \
   do {                                                                         \
-    if (::seahorn::SeaLogFlag && ::seahorn::SeaLog.count(TAG) > 0) {                   \
-      CODE;                                                                    \
+    if (::seahorn::SeaLogFlag.load(std::memory_order_relaxed)) {               \
+      static const ::seahorn::SeaLogSite _sea_log_site_(TAG);                  \
+      if (_sea_log_site_.enabled()) {                                          \
+        CODE;                                                                  \
+      }                                                                        \
     }                                                                          \
   } while (0)
 
-extern bool SeaLogFlag;
-extern std::set<std::string> SeaLog;
+/// true if at least one log tag is enabled
+extern std::atomic<bool> SeaLogFlag;
+
+/// \brief Returns the flag of a log tag, registering the tag if needed
+///
+/// The flag of a tag stays at the same address for the whole run
+const std::atomic<bool> &SeaLogTagFlag(const std::string &tag);
+
+/// \brief A LOG call site: the flag of its tag, looked up once
+class SeaLogSite {
+  const std::atomic<bool> &m_enabled;
+
+public:
+  explicit SeaLogSite(const char *tag) : m_enabled(SeaLogTagFlag(tag)) {}
+  bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+};
 
 void SeaEnableLog(std::string x);
+void SeaDisableLog(std::string x);
 #else
 #define SeaEnableLog(X)
+#define SeaDisableLog(X)
 #define LOG(TAG, CODE)                                                         \
   do {                                                                         \
   } while (0)
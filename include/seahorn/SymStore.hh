@@ -1,14 +1,18 @@
 #ifndef __SYM_STORE_HH_
 #define __SYM_STORE_HH_
 /// A symbolic store is a map from symbolic registers to symbolic values.
+///
+/// The map is persistent: copying a store (e.g., to keep a snapshot of
+/// it at a cut-point) shares the map with the copy and takes constant
+/// time. Only the parts of the map that are later written are copied.
 
 #include "seahorn/Expr/Expr.hh"
 #include "seahorn/Expr/ExprVisitor.hh"
+#include "seahorn/Support/PersistentMap.hh"
 
 #include "llvm/Support/raw_ostream.h"
 #include <map>
 #include <memory>
-#include <unordered_map>
 
 namespace seahorn {
 using namespace expr;
@@ -39,7 +43,7 @@ class SymStore : public std::unary_function<Expr, Expr> {
 
 public:
   typedef std::shared_ptr<SymStore> SymStorePtr;
-  typedef std::unordered_map<Expr, Expr> ExprExprMap;
+  typedef PersistentMap<Expr, Expr> ExprExprMap;
 
 protected:
   /// Parent store, if any
@@ -57,6 +61,8 @@ protected:
   ExprVector m_uses;
   ExprVector m_defs;
   size_t m_defs_sz;
+  /// Fresh values created by havoc, as a flat list of key/value pairs
+  ExprVector m_havocs;
 
   detail::SymStoreEvalVisitor m_evalVisitor;
 
@@ -87,7 +93,7 @@ public:
         m_Store(other.m_Store), m_efac(other.m_efac),
         m_trackUse(other.m_trackUse), m_uses(other.m_uses),
         m_defs(other.m_defs), m_defs_sz(other.m_defs_sz),
-        m_evalVisitor(*this) // create new m_evalVisitor
+        m_havocs(other.m_havocs), m_evalVisitor(*this) // create new m_evalVisitor
   {}
 
   SymStore &operator=(SymStore other) {
@@ -104,18 +110,16 @@ public:
   bool isDefined(Expr key) const { return m_Store.count(key) > 0; }
 
   Expr at(Expr key) const {
-    if (isDefined(key))
-      return m_Store.at(key);
-    return Expr(0);
+    const Expr *val = m_Store.lookup(key);
+    return val ? *val : Expr(0);
   }
 
   Expr eval(Expr exp) { return expr::dagVisit(m_evalVisitor, exp); }
   Expr operator()(Expr exp) { return eval(exp); }
 
-  typedef ExprExprMap::iterator iterator;
+  /// the store is modified only through write()
+  typedef ExprExprMap::const_iterator iterator;
   typedef ExprExprMap::const_iterator const_iterator;
-  iterator begin() { return m_Store.begin(); }
-  iterator end() { return m_Store.end(); }
   const_iterator begin() const { return m_Store.begin(); }
   const_iterator end() const { return m_Store.end(); }
 
@@ -125,6 +129,7 @@ public:
     m_uses.clear();
     m_defs.clear();
     m_defs_sz = 0;
+    m_havocs.clear();
     // if (m_ownedParent) m_ownedParent.reset (new SymStore (efac, false,
     // true));
     if (m_ownedParent)
@@ -136,6 +141,11 @@ public:
   }
   const ExprVector &uses() const { return m_uses; }
   const ExprVector &defs();
+  /// \brief Fresh values created by havoc() while tracking uses
+  ///
+  /// Only records values created by this store (i.e., not by a parent).
+  /// The vector is a flat list of pairs: key followed by its new value.
+  const ExprVector &havocs() const { return m_havocs; }
 
   void write(Expr key, Expr val);
   Expr havoc(Expr key);
@@ -35,6 +35,14 @@ AliasSetId typeAliasId(llvm::CallSite &CS);
 
 enum class CallSiteResolverKind { RESOLVER_TYPES, RESOLVER_CHA, RESOLVER_SEA_DSA };
 
+/* How a bounce function selects the callee */
+enum class BounceLoweringKind {
+  /* a chain of comparisons, one basic block per target */
+  CHAIN,
+  /* a dense function id computed by selects and a single switch */
+  SWITCH
+};
+
 /*
  * Generic class API for resolving indirect calls
  */
@@ -185,6 +193,9 @@ private:
   // allow creating of indirect calls during devirtualization
   // (required for soundness)
   bool m_allowIndirectCalls;
+
+  // how bounce functions dispatch to their targets
+  BounceLoweringKind m_bounceLowering;
   
   /// turn the indirect call-site into a direct one
   void mkDirectCall(llvm::CallSite CS, CallSiteResolver *CSR);
@@ -193,7 +204,9 @@ private:
   llvm::Function *mkBounceFn(llvm::CallSite &CS, CallSiteResolver *CSR);
 
 public:
-  DevirtualizeFunctions(llvm::CallGraph *cg, bool allowIndirectCalls);
+  DevirtualizeFunctions(
+      llvm::CallGraph *cg, bool allowIndirectCalls,
+      BounceLoweringKind bounceLowering = BounceLoweringKind::CHAIN);
 
   ~DevirtualizeFunctions();
   
@@ -1,6 +1,7 @@
 #pragma once
 #include "seahorn/OperationalSemantics.hh"
 #include "seahorn/Expr/Smt/EZ3.hh"
+#include "seahorn/Expr/Smt/Solver.hh"
 
 namespace seahorn {
 class CpEdge;
@@ -21,35 +22,50 @@ class VCGen {
   void genVcForBasicBlockOnEdge(OpSemContext &ctx, const CpEdge &edge,
                                 const BasicBlock &bb, bool last = false);
 
-  /// \brief Initialize SMT solver for eager VC checking
-  void initSmt(std::unique_ptr<EZ3> &zctx,
-               std::unique_ptr<ZSolver<EZ3>> &smt);
+  /// \brief Executes all instructions (except PHINode) of \p bb
+  ///
+  /// Reuses a cached summary of \p bb when block caching is enabled
+  void execBb(const BasicBlock &bb, OpSemContext &ctx);
+
+  /// \brief Computes a summary of \p bb by executing it in a fork of \p ctx
+  BbSummary mkBbSummary(const BasicBlock &bb, OpSemContext &ctx);
+
+  /// \brief Instantiates summary \p sum in the context \p ctx
+  void applyBbSummary(const BbSummary &sum, OpSemContext &ctx);
+
+  /// \brief SMT solver for eager VC checking, shared by all edges
+  std::unique_ptr<solver::Solver> m_smt;
+  /// \brief Number of edges checked with m_smt
+  unsigned m_smtEdges;
 
-  /// \brief Check consistency of side-condition up-to a given basic block
+  /// \brief Initialize SMT solver for eager VC checking
   ///
-  /// If the side-condition is unsat, the negation of the block
-  /// variable is added to the condition
-  /// \param head
-  /// \param side the side condition
-  /// \param pathCond the path condition for \p bb
-  /// \param smt an smt solver to use for the check
-  /// \param edg the cut-point edge
-  /// \param bb the basic block at which side-condition is checked
-  void checkSideAtBb(unsigned &head, ExprVector &side, Expr pathCond,
-                     ZSolver<EZ3> &smt, const CpEdge &edg,
-                     const BasicBlock &bb);
+  /// The solver is created on the first call. Returns a fresh activation
+  /// literal for the side condition of the next edge, or null if eager
+  /// checking is disabled
+  Expr initSmt();
 
-  /// \brief Check consistency of side condition at the last block
+  /// \brief Asserts the side condition from \p head on, guarded by \p act
+  void assertSide(unsigned &head, ExprVector &side, Expr act);
+
+  /// \brief Check consistency of the side condition of an edge
   ///
-  /// If the side-condition is unsat, FALSE is added to the
-  /// side-condition
-  void checkSideAtEnd(unsigned &head, ExprVector &side,
-                      ZSolver<EZ3> &smt);
+  /// If the side-condition is unsat, FALSE is added to it. Otherwise, the
+  /// negation of every block variable in \p bbVs that is false in all
+  /// models of the side condition is added to it. Block variables are
+  /// checked together, by asking for models that execute one of the blocks
+  /// not executed so far.
+  /// \param head first element of \p side not asserted yet
+  /// \param side the side condition
+  /// \param act the activation literal of the edge
+  /// \param bbVs the block variables of the edge
+  /// \param edge the cut-point edge
+  void reduceSide(unsigned &head, ExprVector &side, Expr act,
+                  const ExprVector &bbVs, const CpEdge &edge);
 
 public:
-  VCGen(OperationalSemantics &sem) : m_sem(sem) {
-    trueE = mk<TRUE>(m_sem.getExprFactory());
-  }
+  VCGen(OperationalSemantics &sem);
+  virtual ~VCGen();
 
   /// \brief Generate VC for a given edge in the CutPoint graph
   ///
@@ -2,6 +2,7 @@
 
 #include "seahorn/Support/SeaDebug.h"
 #include "seahorn/Support/SeaLog.hh"
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
@@ -14,6 +15,7 @@
 #include <boost/algorithm/string/find.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <cxxabi.h>
+#include <limits>
 
 /*
    #Background about virtual calls in LLVM#
@@ -244,6 +246,14 @@ private:
   Module &m_module;
   // -- class hierarchy graph (CHG)
   graph_t m_graph;
+  // -- CHG nodes and their indexes in the bitsets below
+  std::vector<const StructType *> m_nodes;
+  DenseMap<const StructType *, unsigned> m_node_ids;
+  // -- strongly connected component of every CHG node
+  std::vector<unsigned> m_scc_of;
+  // -- m_reach[c] is the set of nodes reachable in one or more steps
+  // -- from the nodes of the strongly connected component c
+  std::vector<BitVector> m_reach;
   // -- vtables
   vtable_map_t m_vtables;
   // -- remember resolved callsites that look like virtual calls
@@ -279,6 +289,10 @@ private:
   bool hasCHGEdge(const StructType *src, const StructType *dest,
                   graph_t &graph) const;
 
+  // return the set of nodes reachable from ty in the closed CHG, or
+  // null if ty is not in the CHG
+  const BitVector *getReachable(const StructType *ty) const;
+
   void addCandidateFunction(const StructType *type, unsigned vtable_index,
                             const FunctionType *callsite_type,
                             SmallSet<Function *, 16> &out) const;
@@ -356,65 +370,138 @@ int ClassHierarchyAnalysis_Impl::getVtableIndex(const ImmutableCallSite &CS) {
   return -1;
 }
 
-// Simple floyd-warshall implementation.
+const BitVector *
+ClassHierarchyAnalysis_Impl::getReachable(const StructType *ty) const {
+  auto it = m_node_ids.find(ty);
+  if (it == m_node_ids.end()) {
+    return nullptr;
+  }
+  return &m_reach[m_scc_of[it->second]];
+}
+
+// Transitive closure of the CHG. The graph is first condensed into
+// its strongly connected components (Tarjan's algorithm). Components
+// are found in reverse topological order so the set of nodes
+// reachable from a component is the union of the sets of its
+// successors, computed one machine word at a time with bitsets.
 void ClassHierarchyAnalysis_Impl::closureCHG(void) {
-  size_t num_nodes = m_graph.size();
-
-  // the boolean adjacency matrix
-  std::vector<std::vector<bool>> m(num_nodes);
-
-  // 1. forall i,j:: m[i][j] = true iff exists an edge from node_i to node_j
-  unsigned i = 0;
-  for (auto &kv_i : m_graph) {
-    m[i].reserve(num_nodes);
-    for (auto &kv_j : m_graph) {
-      if (hasCHGEdge(kv_i.first, kv_j.first, m_graph)) {
-        m[i].push_back(true);
-      } else {
-        m[i].push_back(false);
-      }
+  const unsigned undef = std::numeric_limits<unsigned>::max();
+
+  // 1. number the nodes and compute successors by number
+  m_nodes.clear();
+  m_node_ids.clear();
+  m_nodes.reserve(m_graph.size());
+  for (auto &kv : m_graph) {
+    m_node_ids.insert({kv.first, m_nodes.size()});
+    m_nodes.push_back(kv.first);
+  }
+  unsigned num_nodes = m_nodes.size();
+
+  std::vector<SmallVector<unsigned, 4>> succs(num_nodes);
+  for (unsigned i = 0; i < num_nodes; ++i) {
+    for (const StructType *dest : m_graph[m_nodes[i]]) {
+      auto it = m_node_ids.find(dest);
+      assert(it != m_node_ids.end());
+      succs[i].push_back(it->second);
     }
-    ++i;
   }
 
-  LOG("cha-closure", errs() << "Boolean adjacency matrix before closure\n";
-      for (unsigned i = 0; i < num_nodes; ++i) {
-        for (unsigned j = 0; j < num_nodes; ++j) {
-          errs() << "(" << i << "," << j << ")=" << m[i][j] << " ";
+  // 2. iterative Tarjan's algorithm
+  std::vector<unsigned> index(num_nodes, undef), low(num_nodes, 0);
+  std::vector<bool> on_stack(num_nodes, false);
+  std::vector<unsigned> stack;
+  // -- dfs stack of (node, index of the next successor to visit)
+  std::vector<std::pair<unsigned, unsigned>> dfs;
+  std::vector<SmallVector<unsigned, 1>> members;
+  m_scc_of.assign(num_nodes, undef);
+  unsigned next_index = 0;
+
+  auto discover = [&](unsigned v) {
+    index[v] = low[v] = next_index++;
+    stack.push_back(v);
+    on_stack[v] = true;
+    dfs.push_back({v, 0});
+  };
+
+  for (unsigned root = 0; root < num_nodes; ++root) {
+    if (index[root] != undef) {
+      continue;
+    }
+    discover(root);
+    while (!dfs.empty()) {
+      unsigned v = dfs.back().first;
+      if (dfs.back().second < succs[v].size()) {
+        unsigned w = succs[v][dfs.back().second++];
+        if (index[w] == undef) {
+          discover(w);
+        } else if (on_stack[w]) {
+          low[v] = std::min(low[v], index[w]);
         }
-        errs() << "\n";
-      });
+        continue;
+      }
+      dfs.pop_back();
+      if (!dfs.empty()) {
+        unsigned u = dfs.back().first;
+        low[u] = std::min(low[u], low[v]);
+      }
+      if (low[v] == index[v]) {
+        unsigned c = members.size();
+        members.emplace_back();
+        unsigned w;
+        do {
+          w = stack.back();
+          stack.pop_back();
+          on_stack[w] = false;
+          m_scc_of[w] = c;
+          members[c].push_back(w);
+        } while (w != v);
+      }
+    }
+  }
 
-  // 2. forall i,j,k:: m[i][j] = m[i][j] | (m[i][k] & m[k][j])
-  for (unsigned k = 0; k < num_nodes; ++k) {
-    for (unsigned i = 0; i < num_nodes; ++i) {
-      for (unsigned j = 0; j < num_nodes; ++j) {
-        m[i][j] = m[i][j] | (m[i][k] & m[k][j]);
+  // 3. closure over the condensed graph. All successors of a
+  // component have smaller numbers and are already closed.
+  unsigned num_sccs = members.size();
+  m_reach.assign(num_sccs, BitVector(num_nodes));
+  std::vector<unsigned> last_merged(num_sccs, undef);
+  for (unsigned c = 0; c < num_sccs; ++c) {
+    BitVector &reach = m_reach[c];
+    for (unsigned v : members[c]) {
+      for (unsigned w : succs[v]) {
+        unsigned d = m_scc_of[w];
+        if (d == c) {
+          // -- c is cyclic: every member reaches every member
+          for (unsigned u : members[c]) {
+            reach.set(u);
+          }
+        } else {
+          reach.set(w);
+          if (last_merged[d] != c) {
+            reach |= m_reach[d];
+            last_merged[d] = c;
+          }
+        }
       }
     }
   }
 
-  LOG("cha-closure", errs() << "Boolean adjacency matrix after closure\n";
+  m_num_graph_closed_edges = 0;
+  for (unsigned i = 0; i < num_nodes; ++i) {
+    m_num_graph_closed_edges += m_reach[m_scc_of[i]].count();
+  }
+
+  LOG("cha-closure",
+      errs() << "CHG closure: " << num_nodes << " nodes, " << num_sccs
+             << " strongly connected components, " << m_num_graph_closed_edges
+             << " closed edges\n";
       for (unsigned i = 0; i < num_nodes; ++i) {
-        for (unsigned j = 0; j < num_nodes; ++j) {
-          errs() << "(" << i << "," << j << ")=" << m[i][j] << " ";
+        errs() << i << " (scc " << m_scc_of[i] << ") -->";
+        const BitVector &reach = m_reach[m_scc_of[i]];
+        for (int j = reach.find_first(); j != -1; j = reach.find_next(j)) {
+          errs() << " " << j;
         }
         errs() << "\n";
       });
-
-  // Closed m_graph
-  graph_t closed_g;
-  auto it = m_graph.begin();
-  for (unsigned i = 0; i < num_nodes; ++i, ++it) {
-    auto jt = m_graph.begin();
-    for (unsigned j = 0; j < num_nodes; ++j, ++jt) {
-      if (m[i][j]) {
-        addCHGEdge((*it).first, (*jt).first, closed_g);
-        m_num_graph_closed_edges++;
-      }
-    }
-  }
-  std::swap(m_graph, closed_g);
 }
 
 void ClassHierarchyAnalysis_Impl::buildCHG(void) {
@@ -692,13 +779,12 @@ bool ClassHierarchyAnalysis_Impl::resolveVirtualCall(
       // use a set to avoid duplicates. The same function can be in
       // multiple vtables.
       SmallSet<Function *, 16> out_set;
-      auto it = m_graph.find(this_type);
-      if (it != m_graph.end()) {
+      if (const BitVector *reachable_types = getReachable(this_type)) {
         // Add all possible candidates from reachable types in the
-        // class hierarchy graph.
-        auto &reachable_types = it->second;
-        for (const StructType *type : reachable_types) {
-          addCandidateFunction(type, vtable_index, CS_type, out_set);
+        // closed class hierarchy graph.
+        for (int i = reachable_types->find_first(); i != -1;
+             i = reachable_types->find_next(i)) {
+          addCandidateFunction(m_nodes[i], vtable_index, CS_type, out_set);
         }
       }
 
@@ -739,15 +825,14 @@ void ClassHierarchyAnalysis_Impl::printVtables(raw_ostream &o) const {
 }
 
 void ClassHierarchyAnalysis_Impl::printClassHierarchy(raw_ostream &o) const {
-  for (auto &kv : m_graph) {
-    const StructType *node = kv.first;
-    auto const &succs = kv.second;
+  for (const StructType *node : m_nodes) {
+    const BitVector *succs = getReachable(node);
     o << cxx_demangle(node->getName().str()) << " --> "
       << "{";
-    for (auto it = succs.begin(), et = succs.end(); it != et;) {
-      o << cxx_demangle(((*it)->getName().str()));
-      it++;
-      if (it != et) {
+    for (int i = succs->find_first(); i != -1;) {
+      o << cxx_demangle(m_nodes[i]->getName().str());
+      i = succs->find_next(i);
+      if (i != -1) {
         o << ",";
       }
     }
@@ -1,4 +1,6 @@
 #include "seahorn/Analysis/CutPointGraph.hh"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/IR/CFG.h"
 #include "llvm/IR/Instructions.h"
@@ -8,6 +10,9 @@
 
 #include "boost/range.hpp"
 #include "seahorn/Support/SeaDebug.h"
+#include "seahorn/Support/Stats.hh"
+
+#include <algorithm>
 
 enum ExtraCpHeuristics { H0, H1, H2};
 static llvm::cl::opt<ExtraCpHeuristics>
@@ -38,15 +43,24 @@ namespace seahorn
 
     const TopologicalOrder &topo = getAnalysis<TopologicalOrder> ();
 
+    Stats::resume ("CutPointGraph");
     computeCutPoints (F, topo);
-    computeFwdReach (F, topo);
-    computeBwdReach (F, topo);
     computeEdges (F, topo);
+    Stats::stop ("CutPointGraph");
+
+    // -- report the largest graph constructed so far
+    size_t mem = memoryUsage ();
+    if (mem > Stats::get ("cpg.max.bytes")) {
+      Stats::uset ("cpg.max.bytes", mem);
+      Stats::uset ("cpg.max.nodes", m_cps.size ());
+      Stats::uset ("cpg.max.edges", m_edges.size ());
+    }
 
     LOG ("cpg", 
          errs () << "Size of the CPG: " 
                  << m_cps.size ()  << " nodes and " 
-                 << m_edges.size() << " edges.\n");
+                 << m_edges.size() << " edges ("
+                 << mem << " bytes).\n");
 
     LOG ("cpg", print (errs (), F.getParent ()));
 
@@ -118,9 +132,7 @@ namespace seahorn
     
     if (ExtraCp == H2) {
       // -- compute for a basic block cutpoint's ids it can forward reach.
-      // XXX: We cannot use m_fwd since it has not been computed
-      // yet. We could compute m_fwd while we add cutpoints but I
-      // prefer not to do it for now.
+      // -- The ids are those of cp_map, the cutpoints chosen so far
       BlockBitMap fwd;
       for (auto it = topo.rbegin (), end = topo.rend (); it != end; ++it) {
         const BasicBlock *BB = *it;
@@ -168,85 +180,97 @@ namespace seahorn
     }
   }
   
-  void CutPointGraph::computeFwdReach (const Function &F, const TopologicalOrder &topo)
+  /// Computes the edges of the graph by a forward search from every
+  /// cut-point that stops at other cut-points. Since every back-edge
+  /// targets a cut-point, the blocks visited by the search form a DAG
+  /// and the blocks of an edge are those that reach its target
+  /// backwards. The cost is proportional to the size of the resulting
+  /// edges rather than to (#cut-points)^2 per block.
+  void CutPointGraph::computeEdges (const Function &F, const TopologicalOrder &topo)
   {
-    for (auto it = topo.rbegin (), end = topo.rend (); it != end; ++it)
-    {
-      const BasicBlock *bb = *it;
+    DenseMap<const BasicBlock*, unsigned> topoIdx;
+    unsigned idx = 0;
+    for (const BasicBlock *bb : topo) topoIdx [bb] = idx++;
 
-      BitVector &r = m_fwd [bb];
-      for (const BasicBlock *succ : succs (*bb))
-      {
-        if (isCutPoint (*succ))
-          setbit (r, getCp (*succ).id ());
-        else
-          r |= m_fwd [succ];
-      }
-    }
+    auto topoLess = [&topoIdx] (const BasicBlock *a, const BasicBlock *b)
+      { return topoIdx.lookup (a) < topoIdx.lookup (b); };
 
-  }
+    SmallPtrSet<const BasicBlock*, 32> region;
+    SmallPtrSet<const BasicBlock*, 32> onEdge;
+    SmallVector<const BasicBlock*, 32> stack;
+    SmallVector<const BasicBlock*, 32> edgeBbs;
+    SmallVector<unsigned, 8> targets;
 
-  void CutPointGraph::computeBwdReach (const Function &F, const TopologicalOrder &topo)
-  {
-    for (const BasicBlock *bb : topo)
+    for (const CutPointPtr &cpp : m_cps)
     {
-      BitVector &r = m_bwd [bb];
-      
-      const BasicBlock &BB = *bb;
-      for (const BasicBlock *pred :
-             boost::make_iterator_range (pred_begin (bb), pred_end (bb)))
+      CutPoint &cp = *cpp;
+      const BasicBlock *src = &cp.bb ();
+
+      // -- forward search through non-cut-point blocks
+      region.clear ();
+      targets.clear ();
+      stack.push_back (src);
+      while (!stack.empty ())
       {
-        if (topo.isBackEdge (*pred, BB)) continue;
-        if (isCutPoint (*pred))
-          setbit (r, getCp (*pred).id ());
-        else
-          r |= m_bwd [pred];
+        const BasicBlock *bb = stack.pop_back_val ();
+        for (const BasicBlock *succ : succs (*bb))
+        {
+          if (isCutPoint (*succ))
+            targets.push_back (getCp (*succ).id ());
+          else if (region.insert (succ).second)
+          {
+            // -- cut-points are visited in order of ids, so the
+            //    vectors stay sorted
+            m_bwd [succ].push_back (cp.id ());
+            stack.push_back (succ);
+          }
+        }
       }
-    }
 
-    for (const CutPoint &cp : boost::make_iterator_range (begin (), end ()))
-    {
-      const BasicBlock *bb = &cp.bb ();
-      BitVector &r = m_bwd [bb];
-
-      for (const BasicBlock *pred :
-             boost::make_iterator_range (pred_begin (bb), pred_end (bb)))
-      {
-        if (! topo.isBackEdge (*pred, *bb)) continue;
-        if (isCutPoint (*pred))
-          setbit (r, getCp (*pred).id ());
-        else
-          r |= m_bwd [pred];
-      }
-    }
-  }
+      std::sort (targets.begin (), targets.end ());
+      targets.erase (std::unique (targets.begin (), targets.end ()),
+                     targets.end ());
 
-  void CutPointGraph::computeEdges (const Function &F, const TopologicalOrder &topo)
-  {
-    for (const BasicBlock *bb : topo)
-    {
-      if (isCutPoint (*bb))
+      // -- blocks of an edge are the blocks of the region that reach
+      //    its target
+      for (unsigned id : targets)
       {
-        BitVector &r = m_fwd [bb];
-        CutPoint &cp = getCp (*bb);
-        for (int i = r.find_first (); i >= 0; i = r.find_next (i))
+        const BasicBlock *dst = &m_cps [id]->bb ();
+        onEdge.clear ();
+        edgeBbs.clear ();
+        stack.push_back (dst);
+        while (!stack.empty ())
         {
-          CpEdge &edg = newEdge (cp, *m_cps [i]);
-          edg.push_back (bb);
+          const BasicBlock *bb = stack.pop_back_val ();
+          for (const BasicBlock *pred :
+                 boost::make_iterator_range (pred_begin (bb), pred_end (bb)))
+            if (region.count (pred) && onEdge.insert (pred).second)
+            {
+              edgeBbs.push_back (pred);
+              stack.push_back (pred);
+            }
         }
-      }
-      else
-      {
-        BitVector &b = m_bwd[bb];
-        BitVector &f = m_fwd[bb];
+        std::sort (edgeBbs.begin (), edgeBbs.end (), topoLess);
 
-        for (int i = b.find_first (); i >= 0; i = b.find_next (i))
-          for (int j = f.find_first (); j >= 0; j = f.find_next (j))
-            getEdge (*m_cps [i], *m_cps [j])->push_back (bb);
+        CpEdge &edg = newEdge (cp, *m_cps [id]);
+        edg.m_bbs.reserve (edgeBbs.size () + 1);
+        edg.push_back (src);
+        for (const BasicBlock *bb : edgeBbs) edg.push_back (bb);
       }
-
     }
+  }
 
+  size_t CutPointGraph::memoryUsage () const
+  {
+    size_t res = m_cps.size () * sizeof (CutPoint) +
+      m_edges.size () * sizeof (CpEdge) + m_bb.getMemorySize () +
+      m_bwd.getMemorySize ();
+    for (auto &edg : m_edges)
+      res += edg->m_bbs.capacity () * sizeof (const BasicBlock*);
+    // -- approximate: inline storage of small vectors is counted twice
+    for (auto &kv : m_bwd)
+      res += kv.second.capacity_in_bytes ();
+    return res;
   }
 
   CpEdge* CutPointGraph::getEdge (CutPoint &s, CutPoint &d)
@@ -298,12 +322,10 @@ namespace seahorn
     if (isCutPoint (bb)) return false;
 
     auto it = m_bwd.find (&bb);
-    assert (it != m_bwd.end ());
+    if (it == m_bwd.end ()) return false;
 
-    unsigned sz = it->second.size ();
-    unsigned id = cp.id ();
-    if (sz == 0 || id >= sz) return false;
-    return (it->second)[id];
+    const CpIdVector &ids = it->second;
+    return std::binary_search (ids.begin (), ids.end (), cp.id ());
   }
 
 }
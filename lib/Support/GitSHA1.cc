@@ -0,0 +1,2 @@
+#define GIT_SHA1 "7b1cc579"
+extern const char g_GIT_SHA1[] = GIT_SHA1;
@@ -1,8 +1,13 @@
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/CommandLine.h"
 
 #include "seahorn/Support/SeaDebug.h"
 
-#include <set>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
 #include <string>
 
 #ifndef NSEALOG
@@ -13,19 +18,67 @@ extern void SeaDsaEnableLog(std::string x);
 
 using namespace seahorn;
 
-bool seahorn::SeaLogFlag = false;
-std::set<std::string> seahorn::SeaLog;
+std::atomic<bool> seahorn::SeaLogFlag(false);
+
+namespace {
+/// Log tags, interned into dense ids
+struct SeaLogRegistry {
+  std::mutex m_mutex;
+  llvm::StringMap<unsigned> m_ids;
+  /// per id, whether the tag is enabled. A deque keeps existing flags in
+  /// place when new tags are added
+  std::deque<std::atomic<bool>> m_enabled;
+  /// number of enabled tags
+  unsigned m_numEnabled = 0;
+
+  std::atomic<bool> &flag(llvm::StringRef tag) {
+    auto res = m_ids.insert(std::make_pair(tag, m_enabled.size()));
+    if (res.second)
+      m_enabled.emplace_back(false);
+    return m_enabled[res.first->second];
+  }
+
+  void set(llvm::StringRef tag, bool v) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::atomic<bool> &f = flag(tag);
+    if (f.exchange(v) == v)
+      return;
+    if (v)
+      ++m_numEnabled;
+    else
+      --m_numEnabled;
+    SeaLogFlag = m_numEnabled > 0;
+  }
+};
+
+/// function-local to be usable from other static initializers
+SeaLogRegistry &registry() {
+  static SeaLogRegistry r;
+  return r;
+}
+} // namespace
+
+const std::atomic<bool> &seahorn::SeaLogTagFlag(const std::string &tag) {
+  SeaLogRegistry &r = registry();
+  std::lock_guard<std::mutex> lock(r.m_mutex);
+  return r.flag(tag);
+}
 
 void seahorn::SeaEnableLog(std::string x) {
   if (x.empty())
     return;
-  SeaLogFlag = true;
-  SeaLog.insert(x);
+  registry().set(x, true);
 
   // Enable logging in sea_dsa in case it uses the same tags.
   sea_dsa::SeaDsaEnableLog(x);
 }
 
+void seahorn::SeaDisableLog(std::string x) {
+  if (x.empty())
+    return;
+  registry().set(x, false);
+}
+
 namespace seahorn {
 struct LogOpt {
   void operator=(const std::string &tag) const { seahorn::SeaEnableLog(tag); }
@@ -39,5 +92,24 @@ static llvm::cl::opt<seahorn::LogOpt, true, llvm::cl::parser<std::string>>
                 llvm::cl::location(seahorn::loc), llvm::cl::value_desc("string"),
                 llvm::cl::ValueRequired, llvm::cl::ZeroOrMore);
 
+namespace {
+/// Enables the comma-separated tags in the SEAHORN_LOG environment
+/// variable. The tags are not forwarded to sea_dsa, whose state might not
+/// be initialized yet.
+struct SeaLogEnv {
+  SeaLogEnv() {
+    const char *env = std::getenv("SEAHORN_LOG");
+    if (!env)
+      return;
+    llvm::SmallVector<llvm::StringRef, 8> tags;
+    llvm::StringRef(env).split(tags, ',', -1, false);
+    for (llvm::StringRef tag : tags)
+      if (!tag.trim().empty())
+        registry().set(tag.trim(), true);
+  }
+};
+SeaLogEnv envLog;
+} // namespace
+
 #else
 #endif
@@ -12,6 +12,7 @@
 #include "llvm/Pass.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/Local.h"
@@ -60,6 +61,17 @@ static llvm::cl::opt<unsigned> AllocToInstrumentID(
     llvm::cl::desc("Id of the allocation site to instrument"),
     llvm::cl::init(0));
 
+static llvm::cl::opt<bool> SMCBatch(
+    "smc-batch",
+    llvm::cl::desc("Instrument all allocation sites of all checks at once, "
+                   "selected by a nondeterministic site id"),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<std::string> SMCBatchReport(
+    "smc-batch-report",
+    llvm::cl::desc("Write the table of sites instrumented in batch mode"),
+    llvm::cl::init(""), llvm::cl::value_desc("filename"));
+
 namespace seahorn {
 
 struct PtrOrigin {
@@ -290,6 +302,21 @@ private:
   void emitMemoryInstInstrumentation(CheckContext &Candidate);
   void emitAllocSiteInstrumentation(CheckContext &Candidate, size_t AllocId);
 
+  /// Site ids of a batch: a pair of a check and one of its interesting
+  /// allocation sites. Sites of a check are consecutive.
+  struct BatchSite {
+    size_t CheckId;
+    size_t AllocId;
+  };
+  using SiteIdVector = SmallVector<unsigned, 4>;
+  Value *m_siteId;
+
+  void emitBatchInstrumentation(std::vector<CheckContext> &Checks);
+  Value *emitSiteIn(IRBuilder<> &IRB, Value *Site, SiteIdVector Ids);
+  void printBatchSites(llvm::raw_ostream &OS,
+                       std::vector<CheckContext> &Checks,
+                       const std::vector<BatchSite> &Sites);
+
   Function *createNewNDFn(Type *Ty, Twine Prefix = "");
   CallInst *getNDVal(size_t IntBitWidth, Function *F, IRBuilder<> &IRB,
                      Twine Name = "");
@@ -924,6 +951,294 @@ void SimpleMemoryCheck::emitAllocSiteInstrumentation(CheckContext &Candidate,
     InstrumentRemainingSite(AV);
 }
 
+/**
+ * Returns (Site in Ids). Consecutive ids are compared as ranges since
+ * the sites of a single check are numbered consecutively.
+ */
+Value *SimpleMemoryCheck::emitSiteIn(IRBuilder<> &IRB, Value *Site,
+                                     SiteIdVector Ids) {
+  std::sort(Ids.begin(), Ids.end());
+  Ids.erase(std::unique(Ids.begin(), Ids.end()), Ids.end());
+
+  auto *Ty = Site->getType();
+  Value *Res = nullptr;
+  for (size_t i = 0, e = Ids.size(); i < e;) {
+    size_t j = i + 1;
+    while (j < e && Ids[j] == Ids[j - 1] + 1)
+      ++j;
+
+    Value *In;
+    if (j == i + 1)
+      In = IRB.CreateICmpEQ(Site, CreateIntCnst(Ty, Ids[i]));
+    else
+      In = IRB.CreateAnd(
+          IRB.CreateICmpUGE(Site, CreateIntCnst(Ty, Ids[i])),
+          IRB.CreateICmpULE(Site, CreateIntCnst(Ty, Ids[j - 1])));
+    Res = Res ? IRB.CreateOr(Res, In) : In;
+    i = j;
+  }
+
+  return Res ? Res : ConstantInt::getFalse(*m_Ctx);
+}
+
+/**
+ * Instruments every interesting allocation site of every check at once.
+ * A site is a pair of a check and one of its interesting allocation
+ * sites. The site being checked is selected by smc_site, a global
+ * initialized to a nondeterministic value in [0, #sites):
+ *
+ *   - for a site of a global variable gv, in main:
+ *       verifier.assume(smc_site != site ||
+ *                       (&gv == tracked_begin && &gv + sz == tracked_end))
+ *   - a malloc/alloca starts tracking nondeterministically only if it is
+ *     the allocation of the selected site, and is assumed to be above
+ *     tracked_end if the selected site belongs to a check it aliases
+ *   - a load/store errs only if the selected site belongs to its check
+ *
+ * Restricted to a fixed smc_site this is the instrumentation emitted by
+ * emitGlobalInstrumentation, emitMemoryInstInstrumentation and
+ * emitAllocSiteInstrumentation for that site, so every site is its own
+ * property: error is reachable with smc_site == site. The call that
+ * selects the site is marked with !smc.site metadata holding #sites, so
+ * that the BMC engine checks every property of one encoding separately.
+ */
+void SimpleMemoryCheck::emitBatchInstrumentation(
+    std::vector<CheckContext> &Checks) {
+  std::vector<BatchSite> Sites;
+  // -- [first, last) site ids of every check
+  std::vector<std::pair<unsigned, unsigned>> CheckSites;
+  // -- sites that track a given allocation
+  DenseMap<Value *, SiteIdVector> Tracked;
+  // -- sites of the checks that an allocation may alias with
+  DenseMap<Value *, SiteIdVector> Related;
+  // -- allocations in the order they are instrumented
+  SmallVector<Value *, 32> Allocs;
+
+  for (size_t CheckId = 0; CheckId < Checks.size(); ++CheckId) {
+    CheckContext &Check = Checks[CheckId];
+    unsigned First = Sites.size();
+    for (size_t AllocId = 0; AllocId < Check.InterestingAllocSites.size();
+         ++AllocId) {
+      Tracked[Check.InterestingAllocSites[AllocId]].push_back(Sites.size());
+      Sites.push_back({CheckId, AllocId});
+    }
+    unsigned Last = Sites.size();
+    CheckSites.push_back({First, Last});
+
+    auto AddRelated = [&](Value *AV) {
+      SiteIdVector &R = Related[AV];
+      if (R.empty())
+        Allocs.push_back(AV);
+      for (unsigned Id = First; Id < Last; ++Id)
+        R.push_back(Id);
+    };
+    for (auto *AV : Check.InterestingAllocSites)
+      AddRelated(AV);
+    for (auto *AV : Check.OtherAllocSites)
+      AddRelated(AV);
+  }
+
+  SMC_LOG(errs() << "Emitting batch instrumentation for " << Checks.size()
+                 << " checks and " << Sites.size() << " sites\n");
+
+  if (!SMCBatchReport.empty()) {
+    std::error_code EC;
+    raw_fd_ostream Report(SMCBatchReport, EC, sys::fs::F_Text);
+    if (EC)
+      ERR << "Cannot open " << SMCBatchReport << ": " << EC.message();
+    else
+      printBatchSites(Report, Checks, Sites);
+  }
+
+  m_trackedBegin = CreateGlobalPtr(*m_M, "tracked_begin");
+  m_trackedEnd = CreateGlobalPtr(*m_M, "tracked_end");
+  m_trackingEnabled = CreateGlobalBool(*m_M, 0, "tracking_enabled");
+  auto *SiteTy = IntegerType::getInt32Ty(*m_Ctx);
+  m_siteId = new GlobalVariable(*m_M, SiteTy, false,
+                                GlobalValue::InternalLinkage,
+                                ConstantInt::get(SiteTy, 0), "smc_site");
+
+  Function *Main = m_M->getFunction("main");
+  assert(Main);
+
+  // -- main: select a site and set up tracking of global variables
+  IRBuilder<> IRB(*m_Ctx);
+  IRB.SetInsertPoint(&*(Main->getEntryBlock().getFirstInsertionPt()));
+  CallInst *NDSite = getNDVal(32, Main, IRB, "nd_site");
+  NDSite->setMetadata(
+      "smc.site",
+      MDNode::get(*m_Ctx, ConstantAsMetadata::get(
+                              ConstantInt::get(SiteTy, Sites.size()))));
+  createAssume(
+      IRB.CreateICmpULT(NDSite, CreateIntCnst(SiteTy, Sites.size())), Main,
+      IRB);
+  CreateStore(IRB, NDSite, m_siteId, m_DL);
+
+  CallInst *NDPtrBegin = getNDPtr(Main, IRB, "nd_ptr_begin");
+  auto *Cmp1 = IRB.CreateICmpSGT(
+      NDPtrBegin,
+      IRB.CreateBitOrPointerCast(CreateNullptr(*m_Ctx), NDPtrBegin->getType()));
+  createAssume(Cmp1, Main, IRB);
+  CreateStore(IRB, NDPtrBegin, m_trackedBegin, m_DL);
+
+  CallInst *NDPtrEnd = getNDPtr(Main, IRB, "nd_ptr_end");
+  auto *Cmp2 = IRB.CreateICmpSGT(NDPtrEnd, NDPtrBegin);
+  createAssume(Cmp2, Main, IRB);
+  CreateStore(IRB, NDPtrEnd, m_trackedEnd, m_DL);
+
+  Value *GlobalTracked = ConstantInt::getFalse(*m_Ctx);
+  for (auto *AV : Allocs) {
+    auto *GV = dyn_cast<GlobalVariable>(AV);
+    if (!GV)
+      continue;
+
+    auto *I8GV = IRB.CreateBitOrPointerCast(GV, GetI8PtrTy(*m_Ctx),
+                                            GV->getName() + ".i8");
+    Value *IsTracked = ConstantInt::getFalse(*m_Ctx);
+    auto TIt = Tracked.find(GV);
+    if (TIt != Tracked.end()) {
+      assert(!GV->isDeclaration());
+      IsTracked = emitSiteIn(IRB, NDSite, TIt->second);
+
+      Optional<size_t> AllocSize = getAllocSize(GV);
+      assert(AllocSize);
+      auto *GlobalIsBegin =
+          IRB.CreateICmpEQ(I8GV, NDPtrBegin, "global.is.begin");
+      auto *GlobalEnd = IRB.CreateGEP(
+          I8GV,
+          CreateIntCnst(IntegerType::getInt32Ty(*m_Ctx), int64_t(*AllocSize)),
+          "global_end_ptr");
+      auto *EndEq = IRB.CreateICmpEQ(GlobalEnd, NDPtrEnd);
+      createAssume(IRB.CreateOr(IRB.CreateNot(IsTracked),
+                                IRB.CreateAnd(GlobalIsBegin, EndEq)),
+                   Main, IRB);
+      GlobalTracked = IRB.CreateOr(GlobalTracked, IsTracked);
+    }
+
+    // -- not tracked, but aliasing with the selected check
+    auto *IsOther = IRB.CreateAnd(emitSiteIn(IRB, NDSite, Related[GV]),
+                                  IRB.CreateNot(IsTracked));
+    auto *CmpGV = IRB.CreateICmpSGT(I8GV, NDPtrEnd);
+    createAssume(IRB.CreateOr(IRB.CreateNot(IsOther), CmpGV), Main, IRB);
+  }
+  CreateStore(IRB, GlobalTracked, m_trackingEnabled, m_DL);
+
+  // -- memory instructions
+  for (size_t CheckId = 0; CheckId < Checks.size(); ++CheckId) {
+    CheckContext &Check = Checks[CheckId];
+    assert(isa<LoadInst>(Check.MI) || isa<StoreInst>(Check.MI));
+    IRB.SetInsertPoint(Check.MI);
+
+    auto *BeginCandiate = IRB.CreateBitOrPointerCast(
+        Check.Barrier, GetI8PtrTy(*m_Ctx), "begin_candidate");
+    auto *TrackedBegin =
+        CreateLoad(IRB, m_trackedBegin, m_DL, "tracked_begin");
+    auto *Cmp = IRB.CreateICmpEQ(TrackedBegin, BeginCandiate);
+    auto *Active = IRB.CreateLoad(m_trackingEnabled, "active_tracking");
+    auto *Site = CreateLoad(IRB, m_siteId, m_DL, "smc_site");
+    SiteIdVector Ids;
+    for (unsigned Id = CheckSites[CheckId].first;
+         Id < CheckSites[CheckId].second; ++Id)
+      Ids.push_back(Id);
+    auto *Selected = emitSiteIn(IRB, Site, Ids);
+    auto *And = IRB.CreateAnd(IRB.CreateAnd(Active, Cmp), Selected,
+                              "unsafe_condition");
+    auto *Term = SplitBlockAndInsertIfThen(And, Check.MI, true);
+    IRB.SetInsertPoint(Term);
+    IRB.CreateCall(m_errorFn);
+  }
+
+  // -- mallocs and allocas
+  for (auto *AV : Allocs) {
+    if (isa<GlobalVariable>(AV))
+      continue;
+
+    assert(isa<CallInst>(AV) || isa<AllocaInst>(AV));
+    auto *AI = cast<Instruction>(AV);
+    auto *CSFn = AI->getFunction();
+    assert(CSFn);
+
+    IRB.SetInsertPoint(GetNextInst(AI));
+    auto *AllocI8 = IRB.CreateBitCast(AI, GetI8PtrTy(*m_Ctx), "alloc.i8");
+    auto *Site = CreateLoad(IRB, m_siteId, m_DL, "smc_site");
+    auto *TrackedEnd = CreateLoad(IRB, m_trackedEnd, m_DL, "loaded_end");
+    auto *IsRelated = emitSiteIn(IRB, Site, Related[AV]);
+
+    auto TIt = Tracked.find(AV);
+    if (TIt == Tracked.end()) {
+      auto *GT = IRB.CreateICmpSGT(AllocI8, TrackedEnd);
+      createAssume(IRB.CreateOr(IRB.CreateNot(IsRelated), GT), CSFn, IRB);
+      continue;
+    }
+
+    auto *IsTracked = emitSiteIn(IRB, Site, TIt->second);
+    auto *Active = IRB.CreateLoad(m_trackingEnabled, "active_tracking");
+    auto *NotActive = IRB.CreateICmpEQ(Active, ConstantInt::getFalse(*m_Ctx),
+                                       "inactive_tracking");
+    auto *NDVal = getNDVal(32, CSFn, IRB);
+    auto *NDBool = IRB.CreateICmpEQ(NDVal, CreateIntCnst(NDVal->getType(), 0));
+    auto *And = dyn_cast<Instruction>(
+        IRB.CreateAnd(IsTracked, IRB.CreateAnd(NotActive, NDBool)));
+    assert(And);
+
+    TerminatorInst *ThenTerm;
+    TerminatorInst *ElseTerm;
+    SplitBlockAndInsertIfThenElse(And, GetNextInst(And), &ThenTerm, &ElseTerm);
+
+    auto *ThenBB = ThenTerm->getParent();
+    ThenBB->setName("start_tracking");
+    auto *ElseBB = ElseTerm->getParent();
+    ElseBB->setName("not_tracking");
+
+    IRB.SetInsertPoint(ElseBB->getFirstNonPHI());
+    auto *GT = IRB.CreateICmpSGT(AllocI8, TrackedEnd);
+    createAssume(IRB.CreateOr(IRB.CreateNot(IsRelated), GT), CSFn, IRB);
+
+    IRB.SetInsertPoint(ThenBB->getFirstNonPHI());
+    CreateStore(IRB, ConstantInt::getTrue(*m_Ctx), m_trackingEnabled, m_DL);
+    auto *TrackedBegin = CreateLoad(IRB, m_trackedBegin, m_DL, "loaded_begin");
+    auto *AllocIsBegin =
+        IRB.CreateICmpEQ(AllocI8, TrackedBegin, "alloc.is.begin");
+    createAssume(AllocIsBegin, CSFn, IRB);
+
+    Optional<size_t> AllocSize = getAllocSize(AI);
+    assert(AllocSize);
+    auto *End = IRB.CreateGEP(
+        AllocI8,
+        CreateIntCnst(IntegerType::getInt32Ty(*m_Ctx), int64_t(*AllocSize)),
+        "end_ptr");
+    auto *EndEq = IRB.CreateICmpEQ(End, TrackedEnd);
+    createAssume(EndEq, CSFn, IRB);
+  }
+}
+
+void SimpleMemoryCheck::printBatchSites(llvm::raw_ostream &OS,
+                                        std::vector<CheckContext> &Checks,
+                                        const std::vector<BatchSite> &Sites) {
+  auto PrintValue = [&OS](Value *V) {
+    if (V->hasName())
+      OS << V->getName();
+    else
+      V->printAsOperand(OS, false);
+  };
+
+  OS << "site,check,alloc,function,access,alloc_function,alloc_site\n";
+  for (size_t Id = 0; Id < Sites.size(); ++Id) {
+    const BatchSite &S = Sites[Id];
+    CheckContext &Check = Checks[S.CheckId];
+    Value *AV = Check.InterestingAllocSites[S.AllocId];
+    OS << Id << "," << S.CheckId << "," << S.AllocId << ","
+       << Check.F->getName() << ",";
+    PrintValue(Check.MI);
+    OS << ",";
+    if (auto *I = dyn_cast<Instruction>(AV))
+      OS << I->getFunction()->getName();
+    OS << ",";
+    PrintValue(AV);
+    OS << "\n";
+  }
+}
+
 bool SimpleMemoryCheck::runOnModule(llvm::Module &M) {
   if (M.begin() == M.end())
     return false;
@@ -1052,6 +1367,19 @@ bool SimpleMemoryCheck::runOnModule(llvm::Module &M) {
     return false;
   }
 
+  if (SMCBatch) {
+    std::vector<CheckContext> BatchChecks;
+    for (auto &Check : CheckCandidates)
+      if (!Check.InterestingAllocSites.empty())
+        BatchChecks.push_back(Check);
+    if (BatchChecks.empty()) {
+      SMC_LOG(errs() << "No check candidates with interesting sites!\n");
+      return false;
+    }
+    emitBatchInstrumentation(BatchChecks);
+    return true;
+  }
+
   size_t CheckId = CheckToInstrumentID;
   size_t AllocSiteId = AllocToInstrumentID;
 
@@ -311,8 +311,10 @@ void CallSiteResolverByCHA::cacheBounceFunction(CallSite&CS, Function* bounce) {
 
 
 DevirtualizeFunctions::DevirtualizeFunctions(llvm::CallGraph *cg,
-					     bool allowIndirectCalls)
-  : m_cg(cg), m_allowIndirectCalls(allowIndirectCalls) {}
+					     bool allowIndirectCalls,
+					     BounceLoweringKind bounceLowering)
+  : m_cg(cg), m_allowIndirectCalls(allowIndirectCalls),
+    m_bounceLowering(bounceLowering) {}
 
 DevirtualizeFunctions::~DevirtualizeFunctions() {} 
 
@@ -477,36 +479,79 @@ Function *DevirtualizeFunctions::mkBounceFn(CallSite &CS, CallSiteResolver *CSR)
   // basic block.  We'll change the basic block to which it branches later.
   BranchInst *InsertPt = BranchInst::Create(defaultBB, entryBB);
 
-  // Create basic blocks which will test the value of the incoming function
-  // pointer and branch to the appropriate basic block to call the function.
   Type *VoidPtrType = getVoidPtrType(M->getContext());
   Value *FArg = castTo(&*(F->arg_begin()), VoidPtrType, "", InsertPt);
-  BasicBlock *tailBB = defaultBB;
-  for (const Function *FL : *Targets) {
 
-    // Cast the function pointer to an integer.  This can go in the entry
-    // block.
-    Value *TargetInt =
-        castTo(const_cast<Function *>(FL), VoidPtrType, "", InsertPt);
-
-    // Create a new basic block that compares the function pointer to the
-    // function target.  If the function pointer matches, we'll branch to the
-    // basic block performing the direct call for that function; otherwise,
-    // we'll branch to the next function call target.
-    BasicBlock *TB = targets[FL];
-    BasicBlock *newB =
-        BasicBlock::Create(M->getContext(), "test." + FL->getName(), F);
-    CmpInst *setcc = CmpInst::Create(Instruction::ICmp, CmpInst::ICMP_EQ,
-                                     TargetInt, FArg, "sc", newB);
-    BranchInst::Create(TB, tailBB, setcc, newB);
-
-    // Make this newly created basic block the next block that will be reached
-    // when the next comparison will need to be done.
-    tailBB = newB;
-  }
+  if (m_bounceLowering == BounceLoweringKind::SWITCH) {
+    // Give every target a dense id starting at 1 (0 is the default
+    // case).  Case values of a switch must be integer constants, so
+    // the incoming pointer is still compared against every target,
+    // but each comparison only contributes its own id (or 0) and the
+    // ids are combined once by a balanced tree of disjoint ors.  The
+    // index is thus a flat term instead of an N-deep chain of
+    // selects, and -lower-switch turns the switch on it into a
+    // decision tree of depth log(N).
+    IntegerType *IdTy = Type::getInt32Ty(M->getContext());
+    Constant *Zero = ConstantInt::get(IdTy, 0);
+    SmallVector<Value *, 16> ids;
+    unsigned id = 0;
+    for (const Function *FL : *Targets) {
+      Value *TargetInt =
+          castTo(const_cast<Function *>(FL), VoidPtrType, "", InsertPt);
+      CmpInst *setcc = CmpInst::Create(Instruction::ICmp, CmpInst::ICMP_EQ,
+                                       TargetInt, FArg, "sc", InsertPt);
+      ids.push_back(SelectInst::Create(setcc, ConstantInt::get(IdTy, ++id),
+                                       Zero, "id", InsertPt));
+    }
+    // -- at most one comparison holds, so or-ing the ids selects it
+    while (ids.size() > 1) {
+      SmallVector<Value *, 16> next;
+      for (unsigned i = 0, sz = ids.size(); i + 1 < sz; i += 2)
+        next.push_back(BinaryOperator::Create(Instruction::Or, ids[i],
+                                              ids[i + 1], "fid", InsertPt));
+      if (ids.size() % 2)
+        next.push_back(ids.back());
+      ids.swap(next);
+    }
+    Value *FId = ids.empty() ? Zero : ids.front();
 
-  // Make the entry basic block branch to the first comparison basic block.
-  InsertPt->setSuccessor(0, tailBB);
+    SwitchInst *SI =
+        SwitchInst::Create(FId, defaultBB, Targets->size(), InsertPt);
+    id = 0;
+    for (const Function *FL : *Targets) {
+      SI->addCase(ConstantInt::get(IdTy, ++id), targets[FL]);
+    }
+    InsertPt->eraseFromParent();
+  } else {
+    // Create basic blocks which will test the value of the incoming function
+    // pointer and branch to the appropriate basic block to call the function.
+    BasicBlock *tailBB = defaultBB;
+    for (const Function *FL : *Targets) {
+
+      // Cast the function pointer to an integer.  This can go in the entry
+      // block.
+      Value *TargetInt =
+          castTo(const_cast<Function *>(FL), VoidPtrType, "", InsertPt);
+
+      // Create a new basic block that compares the function pointer to the
+      // function target.  If the function pointer matches, we'll branch to the
+      // basic block performing the direct call for that function; otherwise,
+      // we'll branch to the next function call target.
+      BasicBlock *TB = targets[FL];
+      BasicBlock *newB =
+          BasicBlock::Create(M->getContext(), "test." + FL->getName(), F);
+      CmpInst *setcc = CmpInst::Create(Instruction::ICmp, CmpInst::ICMP_EQ,
+                                       TargetInt, FArg, "sc", newB);
+      BranchInst::Create(TB, tailBB, setcc, newB);
+
+      // Make this newly created basic block the next block that will be reached
+      // when the next comparison will need to be done.
+      tailBB = newB;
+    }
+
+    // Make the entry basic block branch to the first comparison basic block.
+    InsertPt->setSuccessor(0, tailBB);
+  }
 
   // -- cache the newly created function
   CSR->cacheBounceFunction(CS, F);
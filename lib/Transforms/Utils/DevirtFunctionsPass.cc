@@ -43,6 +43,16 @@ AllowIndirectCalls("devirt-functions-allow-indirect-calls",
       llvm::cl::Hidden,
       llvm::cl::init(false));
 
+static llvm::cl::opt<seahorn::BounceLoweringKind>
+BounceLowering("devirt-functions-bounce",
+      llvm::cl::desc("Lowering of the dispatch in bounce functions"),
+      llvm::cl::values
+       (clEnumValN(seahorn::BounceLoweringKind::CHAIN, "chain",
+		  "A chain of comparisons, one block per target"),
+       clEnumValN(seahorn::BounceLoweringKind::SWITCH, "switch",
+		  "A single switch over a dense function id")),
+      llvm::cl::init(seahorn::BounceLoweringKind::CHAIN));
+
 static llvm::cl::opt<bool>
 AllowIncompleteDsaNodes("devirt-functions-allow-incomplete",
       llvm::cl::desc("Allow the use of incomplete dsa nodes to resolve calls. "
@@ -64,7 +74,7 @@ public:
   virtual bool runOnModule(Module &M) {
     // -- Get the call graph to update
     CallGraph &cg = getAnalysis<CallGraphWrapperPass>().getCallGraph();
-    DevirtualizeFunctions DF(&cg, AllowIndirectCalls);
+    DevirtualizeFunctions DF(&cg, AllowIndirectCalls, BounceLowering);
     bool res = false;
 
     if (UseCHA) {
@@ -1,12 +1,14 @@
 #include "seahorn/Bmc.hh"
 #include "seahorn/Transforms/Instrumentation/ShadowMemDsa.hh"
 #include "seahorn/UfoOpSem.hh"
+#include "seahorn/VCGen.hh"
 
 #include "llvm/IR/DebugInfo.h"
 #include "llvm/IR/DebugLoc.h"
 
 #include "boost/container/flat_set.hpp"
 #include "seahorn/Support/SeaDebug.h"
+#include "seahorn/Support/Stats.hh"
 #include "seahorn/Expr/ExprLlvm.hh"
 
 
@@ -27,6 +29,25 @@ boost::tribool BmcEngine::solve() {
   return m_result;
 }
 
+void BmcEngine::guardAssumptions(const ExprVector &conds, ExprVector &lits) {
+  for (Expr c : conds) {
+    Expr lit = bind::boolConst(mkTerm<std::string>(
+        "bmc.assume!" + std::to_string(m_numAssumed++), m_efac));
+    m_smt_solver.assertExpr(mk<IMPL>(lit, c));
+    lits.push_back(lit);
+  }
+}
+
+boost::tribool BmcEngine::solveAssuming(const ExprVector &conds) {
+  if (conds.empty())
+    return solve();
+  encode();
+  ExprVector lits;
+  guardAssumptions(conds, lits);
+  m_result = m_smt_solver.solveAssuming(lits);
+  return m_result;
+}
+
 void BmcEngine::encode(bool assert_formula) {
 
   // -- only run the encoding once
@@ -69,7 +90,10 @@ void BmcEngine::reset() {
   m_cpg = nullptr;
   m_fn = nullptr;
   m_smt_solver.reset();
+  m_result = boost::indeterminate;
 
+  m_semCtx.reset();
+  m_ctxState.reset();
   m_side.clear();
   m_states.clear();
   m_edges.clear();
@@ -80,6 +104,213 @@ void BmcEngine::unsatCore(ExprVector &out) {
   bmc_impl::unsat_core(m_smt_solver, m_side, simplify, out);
 }
 
+namespace {
+/// \brief Initial value of a register that is read before being written
+///
+/// Same as the value SymStore::read() creates in a store without a parent
+Expr initialValue(Expr reg) {
+  Expr fdecl = bind::fname(reg);
+  Expr fname = variant::variant(0, bind::fname(fdecl));
+  return bind::reapp(reg, bind::rename(fdecl, fname));
+}
+
+/// Tags every constant named by a variant, i.e., every value created by a
+/// symbolic store
+struct TagVariants : public std::unary_function<Expr, VisitAction> {
+  Expr m_tag;
+  TagVariants(Expr tag) : m_tag(tag) {}
+  VisitAction operator()(Expr exp) const {
+    if (!bind::isFapp(exp) || exp->arity() != 1)
+      return VisitAction::doKids();
+    Expr fdecl = bind::fname(exp);
+    if (!isOpX<VARIANT>(bind::fname(fdecl)))
+      return VisitAction::skipKids();
+    return VisitAction::changeTo(bind::reapp(
+        exp, bind::rename(fdecl, variant::tag(bind::fname(fdecl), m_tag))));
+  }
+};
+} // namespace
+
+Expr IncBmcEngine::mkLit(const std::string &prefix) {
+  return bind::boolConst(
+      mkTerm<std::string>(prefix + std::to_string(m_numLits++), m_efac));
+}
+
+IncBmcEngine::EdgeVc &IncBmcEngine::getEdgeVc(VCGen &vcgen,
+                                              const CpEdge &edg,
+                                              unsigned occ) {
+  std::unique_ptr<EdgeVc> &res = m_cache[std::make_pair(&edg, occ)];
+  if (res) {
+    ++m_numReused;
+    Stats::count("bmc.inc.reused_edges");
+    return *res;
+  }
+  res.reset(new EdgeVc());
+  ++m_numEncoded;
+  Stats::count("bmc.inc.encoded_edges");
+
+  // -- execute the edge in a parent-less store that tracks reads. Every
+  // -- register read before being written gets its initial value
+  m_ctxState = SymStore(m_efac, true /* trackUse */, true /* globalParent */);
+  m_ctxSide.clear();
+  vcgen.genVcForCpEdge(*m_semCtx, edg);
+
+  // -- all edges name their values alike, rename them apart
+  res->m_lit = mkLit("bmc.edge!");
+  TagVariants tv(bind::fname(bind::fname(res->m_lit)));
+  DagVisit<TagVariants> dv(tv);
+  for (Expr reg : m_ctxState.uses()) {
+    res->m_inputs.push_back(reg);
+    res->m_inputs.push_back(dv(initialValue(reg)));
+  }
+  for (auto &kv : m_ctxState) {
+    res->m_outputs.push_back(kv.first);
+    res->m_outputs.push_back(dv(kv.second));
+  }
+  for (Expr e : m_ctxSide)
+    res->m_side.push_back(dv(e));
+  return *res;
+}
+
+void IncBmcEngine::setTrace(llvm::ArrayRef<const CutPoint *> cps) {
+  assert(!cps.empty());
+  if (!m_cpg) {
+    m_cpg = &cps.front()->parent();
+    m_fn = cps.front()->bb().getParent();
+  }
+  assert(m_cpg == &cps.front()->parent());
+
+  m_cps.assign(cps.begin(), cps.end());
+  m_edges.clear();
+  m_states.clear();
+  m_side.clear();
+  m_trace.clear();
+  m_lits.clear();
+  m_glue = Expr();
+  m_glueLit = Expr();
+  m_glueAsserted = false;
+  m_encoded = false;
+  m_result = boost::indeterminate;
+}
+
+void IncBmcEngine::encode(bool assert_formula) {
+  assert(m_cpg);
+  assert(m_fn);
+
+  if (!m_semCtx) {
+    m_ctxState = m_init;
+    m_semCtx = m_sem.mkContext(m_ctxState, m_ctxSide);
+    m_init = m_ctxState;
+    m_initSide.assign(m_ctxSide.begin(), m_ctxSide.end());
+  }
+
+  if (!m_encoded) {
+    VCGen vcgen(m_sem);
+    m_states.push_back(m_init);
+    m_side.assign(m_initSide.begin(), m_initSide.end());
+
+    ExprVector glue;
+    std::map<const CpEdge *, unsigned> occs;
+    for (unsigned i = 1; i < m_cps.size(); ++i) {
+      const CpEdge *edg = m_cpg->getEdge(*m_cps[i - 1], *m_cps[i]);
+      assert(edg);
+      m_edges.push_back(edg);
+      EdgeVc &vc = getEdgeVc(vcgen, *edg, occs[edg]++);
+      m_trace.push_back(&vc);
+      m_lits.push_back(vc.m_lit);
+      m_side.insert(m_side.end(), vc.m_side.begin(), vc.m_side.end());
+
+      // -- connect the inputs of the edge to the state before it
+      SymStore st(m_states.back());
+      for (unsigned j = 0, sz = vc.m_inputs.size(); j < sz; j += 2) {
+        Expr reg = vc.m_inputs[j];
+        Expr val = vc.m_inputs[j + 1];
+        if (st.isDefined(reg))
+          glue.push_back(mk<EQ>(val, st.at(reg)));
+        else
+          st.write(reg, val);
+      }
+      for (unsigned j = 0, sz = vc.m_outputs.size(); j < sz; j += 2)
+        st.write(vc.m_outputs[j], vc.m_outputs[j + 1]);
+      m_states.push_back(st);
+    }
+
+    if (!glue.empty()) {
+      m_side.insert(m_side.end(), glue.begin(), glue.end());
+      m_glue = mknary<AND>(mk<TRUE>(m_efac), glue);
+      m_glueLit = mkLit("bmc.glue!");
+      m_lits.push_back(m_glueLit);
+    }
+    m_encoded = true;
+  }
+
+  if (!assert_formula)
+    return;
+
+  // -- side-conditions of the initial state are not guarded
+  if (!m_initAsserted) {
+    for (Expr e : m_initSide)
+      m_smt_solver.assertExpr(e);
+    m_initAsserted = true;
+  }
+
+  Expr trueE = mk<TRUE>(m_efac);
+  for (EdgeVc *vc : m_trace) {
+    if (vc->m_asserted)
+      continue;
+    m_smt_solver.assertExpr(
+        mk<IMPL>(vc->m_lit, mknary<AND>(trueE, vc->m_side)));
+    vc->m_asserted = true;
+  }
+  if (m_glue && !m_glueAsserted) {
+    m_smt_solver.assertExpr(mk<IMPL>(m_glueLit, m_glue));
+    m_glueAsserted = true;
+  }
+}
+
+boost::tribool IncBmcEngine::solve() {
+  encode();
+  m_result = m_lits.empty() ? m_smt_solver.solve()
+                            : m_smt_solver.solveAssuming(m_lits);
+  return m_result;
+}
+
+boost::tribool IncBmcEngine::solveAssuming(const ExprVector &conds) {
+  encode();
+  ExprVector lits(m_lits);
+  guardAssumptions(conds, lits);
+  m_result = lits.empty() ? m_smt_solver.solve()
+                          : m_smt_solver.solveAssuming(lits);
+  return m_result;
+}
+
+void IncBmcEngine::unsatCore(ExprVector &out) {
+  encode(false);
+  BmcEngine::unsatCore(out);
+  // -- computing the core resets the solver
+  m_initAsserted = false;
+  m_glueAsserted = false;
+  for (auto &kv : m_cache)
+    kv.second->m_asserted = false;
+}
+
+void IncBmcEngine::reset() {
+  BmcEngine::reset();
+  m_cache.clear();
+  m_init = SymStore(m_root, false);
+  m_ctxSide.clear();
+  m_initSide.clear();
+  m_initAsserted = false;
+  m_trace.clear();
+  m_glue = Expr();
+  m_glueLit = Expr();
+  m_glueAsserted = false;
+  m_encoded = false;
+  m_lits.clear();
+  m_numReused = 0;
+  m_numEncoded = 0;
+}
+
 BmcTrace BmcEngine::getTrace() {
   assert((bool)m_result);
   auto model = m_smt_solver.getModel();
@@ -114,6 +114,44 @@ public:
     AU.setPreservesAll();
   }
 
+  /// \brief Returns the call that selects the site checked by a batch of
+  /// SimpleMemoryCheck, and the number of sites, if \p F has one
+  const Instruction *getSmcSiteSelector(Function &F, unsigned &numSites) {
+    for (const Instruction &I : instructions(F)) {
+      if (MDNode *md = I.getMetadata("smc.site")) {
+        numSites =
+            mdconst::extract<ConstantInt>(md->getOperand(0))->getZExtValue();
+        return &I;
+      }
+    }
+    return nullptr;
+  }
+
+  /// \brief Checks every site of a batch on its own, against the same
+  /// encoding, and reports the result of each
+  void checkSmcSites(BmcEngine &bmc, const Instruction &selector,
+                     unsigned numSites) {
+    Expr reg = bmc.getSymbReg(selector);
+    if (!reg || bmc.getStates().empty())
+      return;
+    Expr site = bmc.getStates().back().eval(reg);
+    unsigned width = selector.getType()->getIntegerBitWidth();
+    for (unsigned k = 0; k < numSites; ++k) {
+      Stats::count("bmc.smc.sites");
+      auto res = bmc.solveAssuming(
+          {mk<EQ>(site, bv::bvnum(k, width, bmc.efac()))});
+      outs() << "smc site " << k << ": ";
+      if (res) {
+        Stats::count("bmc.smc.sites_unsafe");
+        outs() << "sat";
+      } else if (!res)
+        outs() << "unsat";
+      else
+        outs() << "unknown";
+      outs() << "\n";
+    }
+  }
+
   bool runOnFunction(Function &F) {
     LOG("bmc-pass", errs() << "Starting BMC on " << F.getName() << "\n";);
     LOG("bmc.dumpf", errs() << F << "\n");
@@ -224,6 +262,10 @@ public:
         return false;
       }
 
+      unsigned numSites = 0;
+      if (const Instruction *selector = getSmcSiteSelector(F, numSites))
+        checkSmcSites(bmc, *selector, numSites);
+
       auto res = bmc.solve();
       Stats::stop("BMC");
 
@@ -1,5 +1,6 @@
 #include "seahorn/BvOpSem2.hh"
 
+#include "llvm/ADT/Hashing.h"
 #include "llvm/CodeGen/IntrinsicLowering.h"
 #include "llvm/IR/GetElementPtrTypeIterator.h"
 #include "llvm/Support/CommandLine.h"
@@ -36,6 +37,11 @@ static llvm::cl::opt<bool> UseFatMemory(
         "Use fat-memory model with fat pointers and fat memory locations"),
     cl::init(false));
 
+static llvm::cl::opt<bool> UseSplitMemory(
+    "horn-bv2-split-mem",
+    llvm::cl::desc("Use a separate array for every global allocation site"),
+    cl::init(false));
+
 static llvm::cl::opt<unsigned>
     WordSize("horn-bv2-word-size",
              llvm::cl::desc("Word size in bytes: 1, 4, 8"), cl::init(4));
@@ -1692,6 +1698,8 @@ Bv2OpSemContext::Bv2OpSemContext(Bv2OpSem &sem, SymStore &values,
   OpSemMemManager *mem = nullptr;
   if (UseFatMemory)
     mem = mkFatMemManager(m_sem, *this, PtrSize, WordSize, UseLambdas);
+  else if (UseSplitMemory)
+    mem = mkSplitMemManager(m_sem, *this, PtrSize, WordSize, UseLambdas);
   else
     mem = mkRawMemManager(m_sem, *this, PtrSize, WordSize, UseLambdas);
   assert(mem);
@@ -2079,6 +2087,14 @@ Bv2OpSem::Bv2OpSem(const Bv2OpSem &o)
     : OperationalSemantics(o), m_pass(o.m_pass), m_trackLvl(o.m_trackLvl),
       m_td(o.m_td), m_canFail(o.m_canFail) {}
 
+unsigned Bv2OpSem::execConfig() const {
+  return static_cast<unsigned>(llvm::hash_combine(
+      static_cast<unsigned>(m_trackLvl), (bool)UseLambdas, (bool)UseFatMemory,
+      (bool)UseSplitMemory, (unsigned)WordSize, (unsigned)PtrSize,
+      (bool)EnableUniqueScalars2, (bool)InferMemSafety2, (bool)IgnoreCalloc2,
+      (bool)EnableModelExternalCalls2, (bool)SimplifyOnWrite));
+}
+
 Expr Bv2OpSem::errorFlag(const BasicBlock &BB) {
   // -- if BB belongs to a function that cannot fail, errorFlag is always false
   if (m_canFail && !m_canFail->canFail(BB.getParent()))
@@ -2088,16 +2104,49 @@ Expr Bv2OpSem::errorFlag(const BasicBlock &BB) {
 
 void Bv2OpSem::exec(const BasicBlock &bb,
                     seahorn::details::Bv2OpSemContext &ctx) {
+  ScopedStats _st_("opsem");
   ctx.onBasicBlockEntry(bb);
 
+  const FnTable &table = getFnTable(*bb.getParent());
+  assert(table.m_blocks.count(&bb));
+  auto range = table.m_blocks.lookup(&bb);
+  assert(table.m_insts[range.second] == bb.getTerminator() &&
+         "basic block changed after its function table was computed");
+
   seahorn::details::OpSemVisitor v(ctx, *this);
   v.visitBasicBlock(const_cast<BasicBlock &>(bb));
   // skip PHI instructions
-  for (; isa<PHINode>(ctx.getCurrentInst()); ++ctx)
-    ;
+  ctx.setInstruction(*table.m_insts[range.first]);
+
+  // -- same as calling intraStep() until it returns false, but with the
+  // -- information about instructions taken from the table
+  for (unsigned i = range.first; i <= range.second; ++i) {
+    const Instruction &inst = *table.m_insts[i];
+    bool isTerm = i == range.second;
+    // -- non-branch terminators are executed elsewhere
+    if (isTerm && !isa<BranchInst>(&inst))
+      break;
+
+    unsigned idx = i + bb.getParent()->arg_size();
+    if (table.m_skipped[idx]) {
+      skipInst(inst, ctx);
+    } else {
+      LOG("opsem.verbose", errs() << "Executing: " << inst << "\n";);
+      v.visit(const_cast<Instruction &>(inst));
+      if (&ctx.getCurrentInst() != &inst) {
+        // -- the instruction was lowered in place (e.g., bswap). The
+        // -- table is stale, execute the rest of the block without it
+        m_fnTables.erase(bb.getParent());
+        m_lastFnTable = nullptr;
+        ++ctx;
+        while (intraStep(ctx))
+          /* do nothing */;
+        return;
+      }
+    }
 
-  while (intraStep(ctx)) {
-    /* do nothing */;
+    if (!isTerm)
+      ++ctx;
   }
 }
 
@@ -2238,7 +2287,58 @@ const Value &Bv2OpSem::conc(Expr v) const {
   return *getTerm<const Value *>(v);
 }
 
+const Bv2OpSem::FnTable &Bv2OpSem::getFnTable(const Function &fn) const {
+  if (m_lastFnTable && m_lastFnTable->m_fn == &fn &&
+      m_lastFnTable->m_filterVersion == m_filterVersion)
+    return *m_lastFnTable;
+
+  FnTablePtr &table = m_fnTables[&fn];
+  if (!table || table->m_filterVersion != m_filterVersion) {
+    Stats::count("opsem.fn_tables");
+    table.reset(new FnTable());
+    table->m_fn = &fn;
+    table->m_filterVersion = m_filterVersion;
+
+    unsigned idx = 0;
+    for (const Argument &arg : fn.args()) {
+      table->m_index[&arg] = idx++;
+      table->m_skipped.push_back(computeIsSkipped(arg));
+    }
+    for (const BasicBlock &bb : fn) {
+      unsigned first = table->m_insts.size();
+      for (const Instruction &inst : bb) {
+        if (isa<PHINode>(&inst))
+          ++first;
+        table->m_index[&inst] = idx++;
+        table->m_insts.push_back(&inst);
+        table->m_skipped.push_back(computeIsSkipped(inst));
+      }
+      table->m_blocks[&bb] = {first, table->m_insts.size() - 1};
+    }
+  }
+
+  m_lastFnTable = table.get();
+  return *table;
+}
+
 bool Bv2OpSem::isSkipped(const Value &v) const {
+  const Function *fn = nullptr;
+  if (auto *inst = dyn_cast<Instruction>(&v))
+    fn = inst->getParent() ? inst->getParent()->getParent() : nullptr;
+  else if (auto *arg = dyn_cast<Argument>(&v))
+    fn = arg->getParent();
+  if (!fn)
+    return computeIsSkipped(v);
+
+  const FnTable &table = getFnTable(*fn);
+  auto it = table.m_index.find(&v);
+  // -- the function was modified after the table was computed
+  if (it == table.m_index.end())
+    return computeIsSkipped(v);
+  return table.m_skipped[it->second];
+}
+
+bool Bv2OpSem::computeIsSkipped(const Value &v) const {
   if (!OperationalSemantics::isTracked(v))
     return true;
   // skip shadow.mem instructions if memory is not a unique scalar
@@ -2256,11 +2356,8 @@ bool Bv2OpSem::isSkipped(const Value &v) const {
     // -- beginning of the function. Perhaps there is a better
     // -- solution. For now, we just do not track anything that came
     // -- that way.
-    if (v.hasOneUse())
-      if (const CallInst *ci = dyn_cast<const CallInst>(*v.user_begin()))
-        if (const Function *fn = ci->getCalledFunction())
-          if (fn->getName().startswith("shadow.mem"))
-            return true;
+    if (details::isShadowMemName(v))
+      return true;
     return m_trackLvl < PTR;
   }
 
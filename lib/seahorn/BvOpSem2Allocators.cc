@@ -95,18 +95,17 @@ AddrInterval OpSemAllocator::galloc(const GlobalVariable &gv, uint64_t bytes,
           ? m_globals.back().m_end
           : (m_funcs.empty() ? TEXT_SEGMENT_START : m_funcs.back().m_end);
 
-  start = llvm::alignTo(start, align);
-  unsigned end = llvm::alignTo(start + bytes, align);
-  m_globals.emplace_back(gv, start, end, bytes);
-  return std::make_pair(start, end);
+  AddrInterval range = globalInterval(start, bytes, align);
+  m_globals.emplace_back(gv, range.first, range.second, bytes);
+  return range;
 }
 
 AddrInterval OpSemAllocator::falloc(const Function &fn, unsigned alignment) {
   assert(m_globals.empty() && "Cannot allocate functions after globals");
   unsigned start = m_funcs.empty() ? TEXT_SEGMENT_START : m_funcs.back().m_end;
-  unsigned end = llvm::alignTo(start + 4, alignment);
-  m_funcs.emplace_back(fn, start, end);
-  return std::make_pair(start, end);
+  AddrInterval range = functionInterval(start, alignment);
+  m_funcs.emplace_back(fn, range.first, range.second);
+  return range;
 }
 
 /// \brief Returns an address at which a given function resides
@@ -214,24 +213,13 @@ public:
     // TODO: pre-allocate all globals of M
 
     for (const Function &fn : M.functions()) {
-      if (fn.hasAddressTaken()) {
-        // XXX hard-coded. should be based on use
-        // XXX some functions have their address taken for llvm.used
-        if (fn.getName().equals("verifier.error") ||
-            fn.getName().startswith("verifier.assume") ||
-            fn.getName().equals("seahorn.fail") ||
-            fn.getName().startswith("shadow.mem"))
-          continue;
+      if (isStaticallyAllocated(fn))
         OpSemAllocator::falloc(fn, m_mem.getAlignment(fn));
-      }
     }
 
     for (const GlobalVariable &gv : M.globals()) {
-      if (m_sem.isSkipped(gv))
-        continue;
-      if (gv.getSection().equals("llvm.metadata")) {
+      if (!isStaticallyAllocated(gv, m_sem.isSkipped(gv)))
         continue;
-      }
       uint64_t bytes = m_sem.getTD().getTypeAllocSize(gv.getValueType());
       OpSemAllocator::galloc(gv, bytes, m_mem.getAlignment(gv));
     }
@@ -277,7 +265,7 @@ public:
       preAlloc(inst, memSz, true);
     } else {
       // -- allocate 4K for dynamically sized allocations
-      preAlloc(inst, 4 * 1024, false);
+      preAlloc(inst, DYN_ALLOC_SIZE, false);
     }
   }
 
@@ -310,7 +298,8 @@ public:
         if (ai.m_inst == alloca) {
           Expr inRange;
           // TODO: figure proper bit-width
-          inRange = mk<BULE>(bytes, bv::bvnum(4 * 1024UL, 32, bytes->efac()));
+          inRange = mk<BULE>(bytes,
+                             bv::bvnum(DYN_ALLOC_SIZE, 32, bytes->efac()));
           LOG("opsem", errs()
                            << "Adding range condition: " << *inRange << "\n";);
           m_ctx.addScopedRely(inRange);
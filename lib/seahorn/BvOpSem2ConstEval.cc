@@ -359,6 +359,13 @@ Optional<GenericValue> ConstantExprEvaluator::evaluate(const Constant *C) {
     if (isa<ConstantPointerNull>(C))
       Result.PointerVal = nullptr;
     else if (const Function *F = dyn_cast<Function>(C)) {
+      if (m_addrs) {
+        auto it = m_addrs->find(F);
+        if (it != m_addrs->end()) {
+          Result = PTOGV((void *)it->second);
+          break;
+        }
+      }
       if (m_ctx) {
         Expr reg = m_ctx->getRegister(*F);
         if (reg) {
@@ -381,6 +388,13 @@ Optional<GenericValue> ConstantExprEvaluator::evaluate(const Constant *C) {
            << "\n";
       return llvm::None;
     } else if (const GlobalVariable *GV = dyn_cast<GlobalVariable>(C)) {
+      if (m_addrs) {
+        auto it = m_addrs->find(GV);
+        if (it != m_addrs->end()) {
+          Result = PTOGV((void *)it->second);
+          break;
+        }
+      }
       if (m_ctx) {
         Expr reg = m_ctx->getRegister(*GV);
         if (reg) {
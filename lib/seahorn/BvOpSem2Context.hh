@@ -1,5 +1,7 @@
 #pragma once
 
+#include "BvOpSem2MemLayout.hh"
+
 #include "seahorn/BvOpSem2.hh"
 #include "seahorn/Support/SeaDebug.h"
 #include "seahorn/Support/SeaLog.hh"
@@ -377,11 +379,6 @@ protected:
   /// \brief All known global allocations
   std::vector<GlobalAllocInfo> m_globals;
 
-  // TODO: turn into user-controlled parameters
-  unsigned MAX_STACK_ADDR = 0xC0000000;
-  unsigned MIN_STACK_ADDR = (MAX_STACK_ADDR - 9437184);
-  unsigned TEXT_SEGMENT_START = 0x08048000;
-
 public:
   using AddrInterval = std::pair<unsigned, unsigned>;
   OpSemAllocator(OpSemMemManager &mem);
@@ -676,6 +673,17 @@ OpSemMemManager *mkFatMemManager(Bv2OpSem &sem, Bv2OpSemContext &ctx,
                                  unsigned ptrSz, unsigned wordSz,
                                  bool useLambdas = false);
 
+OpSemMemManager *mkSplitMemManager(Bv2OpSem &sem, Bv2OpSemContext &ctx,
+                                   unsigned ptrSz, unsigned wordSz,
+                                   bool useLambdas = false);
+
+/// \brief Splits \p ptr into a symbolic base and a numeric offset
+///
+/// Only sums and differences with numerals are peeled off. The base is null
+/// if \p ptr is a numeral. Offsets are computed modulo 2^64 which is enough
+/// for all supported pointer sizes.
+std::pair<Expr, uint64_t> splitPtrBaseOffset(Expr ptr);
+
 /// \Brief Base class for memory representation
 class OpSemMemRepr {
 protected:
@@ -754,14 +762,27 @@ public:
 
 private:
   Expr coerceArrayToLambda(Expr arrVal);
+  /// \brief Builds an ITE that maps \p addr to \p vals[i] if it matches
+  /// \p ptrKeys[i], and to \p fallback otherwise. The earliest matching key
+  /// wins. The shape of the term is controlled by --horn-bv2-lambda-ite
+  Expr makeITE(Expr addr, const ExprVector &ptrKeys, const ExprVector &vals,
+               Expr fallback);
   Expr makeLinearITE(Expr addr, const ExprVector &ptrKeys,
                      const ExprVector &vals, Expr fallback);
+  /// \brief Binary decision tree over keys grouped by their symbolic base
+  Expr makeTreeITE(Expr addr, const ExprVector &ptrKeys,
+                   const ExprVector &vals, Expr fallback);
+  Expr makeTreeITE(Expr key,
+                   const std::vector<std::pair<uint64_t, Expr>> &entries,
+                   size_t lo, size_t hi, Expr fallback);
 };
 
 /// Evaluates constant expressions
 class ConstantExprEvaluator {
   const DataLayout &m_td;
   Bv2OpSemContext *m_ctx;
+  /// \brief Addresses of globals and functions when there is no context
+  const DenseMap<const GlobalValue *, uint64_t> *m_addrs;
 
   const DataLayout &getDataLayout() const { return m_td; }
 
@@ -775,8 +796,16 @@ class ConstantExprEvaluator {
   void storeValueToMemory(const GenericValue &Val, GenericValue *Ptr, Type *Ty);
 
 public:
-  ConstantExprEvaluator(const DataLayout &td) : m_td(td), m_ctx(nullptr) {}
+  ConstantExprEvaluator(const DataLayout &td)
+      : m_td(td), m_ctx(nullptr), m_addrs(nullptr) {}
   void setContext(Bv2OpSemContext &ctx) { m_ctx = &ctx; }
+  /// \brief Resolve addresses of globals and functions using \p addrs
+  ///
+  /// Used to evaluate constants on a concrete memory layout, i.e.,
+  /// without a symbolic context
+  void setGlobalAddrs(const DenseMap<const GlobalValue *, uint64_t> &addrs) {
+    m_addrs = &addrs;
+  }
 
   /// \brief Evaluate a constant expression
   Optional<GenericValue> evaluate(const Constant *C);
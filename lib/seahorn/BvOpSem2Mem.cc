@@ -61,11 +61,11 @@ void ConstantExprEvaluator::storeValueToMemory(const GenericValue &Val,
     memcpy(Ptr, Val.IntVal.getRawData(), 10);
     break;
   case Type::PointerTyID:
-    // Ensure 64 bit target pointers are fully initialized on 32 bit hosts.
-    if (StoreBytes != sizeof(PointerTy))
-      memset(&(Ptr->PointerVal), 0, StoreBytes);
-
-    *((PointerTy *)Ptr) = Val.PointerVal;
+    // Target pointers may be narrower than host pointers (e.g., 32 bit
+    // targets on 64 bit hosts). Store only the bytes of the target pointer.
+    StoreIntToMemory(APInt(std::max(StoreBytes, 8U) * 8,
+                           (uint64_t)(uintptr_t)Val.PointerVal),
+                     (uint8_t *)Ptr, StoreBytes);
     break;
   case Type::VectorTyID:
     for (unsigned i = 0; i < Val.AggregateVal.size(); ++i) {
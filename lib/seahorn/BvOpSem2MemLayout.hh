@@ -0,0 +1,73 @@
+#pragma once
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <utility>
+
+namespace seahorn {
+namespace details {
+
+// -- layout of the virtual memory used by OpSemAllocator. Shared with the
+// -- concrete interpreter of counterexamples. Both place functions and
+// -- globals with the helpers below, so they agree on their addresses as
+// -- long as they use the same alignment (the word size of the memory
+// -- manager) and skip the same globals
+// TODO: turn into user-controlled parameters
+
+/// \brief Start of the code segment
+constexpr unsigned TEXT_SEGMENT_START = 0x08048000;
+/// \brief Top of the stack
+constexpr unsigned MAX_STACK_ADDR = 0xC0000000;
+/// \brief Lowest address of the stack
+constexpr unsigned MIN_STACK_ADDR = MAX_STACK_ADDR - 9437184;
+/// \brief Size reserved for a dynamically sized stack allocation
+constexpr unsigned DYN_ALLOC_SIZE = 4 * 1024;
+
+/// \brief True if the only use of \p v is to name a shadow memory region
+///
+/// shadow.mem generates bitcode that refers to registers defined later in
+/// the function, and to globals, only to name regions
+inline bool isShadowMemName(const llvm::Value &v) {
+  if (!v.getType()->isPointerTy() || !v.hasOneUse())
+    return false;
+  if (auto *ci = llvm::dyn_cast<const llvm::CallInst>(*v.user_begin()))
+    if (const llvm::Function *fn = ci->getCalledFunction())
+      return fn->getName().startswith("shadow.mem");
+  return false;
+}
+
+/// \brief True if the static allocator places \p fn in the code segment
+inline bool isStaticallyAllocated(const llvm::Function &fn) {
+  // XXX hard-coded. should be based on use
+  // XXX some functions have their address taken for llvm.used
+  return fn.hasAddressTaken() && !(fn.getName().equals("verifier.error") ||
+                                   fn.getName().startswith("verifier.assume") ||
+                                   fn.getName().equals("seahorn.fail") ||
+                                   fn.getName().startswith("shadow.mem"));
+}
+
+/// \brief True if the static allocator places \p gv in the data segment.
+/// \p skipped tells whether the semantics ignores \p gv
+inline bool isStaticallyAllocated(const llvm::GlobalVariable &gv,
+                                  bool skipped) {
+  return !skipped && !gv.getSection().equals("llvm.metadata");
+}
+
+/// \brief Memory of a function placed at \p start
+inline std::pair<unsigned, unsigned> functionInterval(unsigned start,
+                                                      unsigned align) {
+  return std::make_pair(start, (unsigned)llvm::alignTo(start + 4, align));
+}
+
+/// \brief Memory of a global of \p bytes bytes placed at or after \p start
+inline std::pair<unsigned, unsigned>
+globalInterval(unsigned start, uint64_t bytes, unsigned align) {
+  start = llvm::alignTo(start, align);
+  return std::make_pair(start, (unsigned)llvm::alignTo(start + bytes, align));
+}
+
+} // namespace details
+} // namespace seahorn
@@ -1,5 +1,27 @@
 #include "BvOpSem2Context.hh"
 #include "seahorn/Expr/ExprOpBinder.hh"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <algorithm>
+
+namespace seahorn {
+namespace details {
+enum class LambdaIteKind { LINEAR, TREE };
+}
+} // namespace seahorn
+
+static llvm::cl::opt<enum seahorn::details::LambdaIteKind> LambdaIteOpt(
+    "horn-bv2-lambda-ite",
+    llvm::cl::desc("Construction of ITE terms over known writes in lambda "
+                   "memory"),
+    llvm::cl::values(
+        clEnumValN(seahorn::details::LambdaIteKind::LINEAR, "linear",
+                   "Linear chain of equality tests"),
+        clEnumValN(seahorn::details::LambdaIteKind::TREE, "tree",
+                   "Binary decision tree over numerically ordered keys")),
+    llvm::cl::init(seahorn::details::LambdaIteKind::LINEAR));
+
 namespace {
 template <typename T, typename... Rest>
 auto as_std_array(const T &t, const Rest &... rest) ->
@@ -182,6 +204,104 @@ Expr OpSemMemLambdaRepr::makeLinearITE(Expr addr, const ExprVector &ptrKeys,
   return res;
 }
 
+std::pair<Expr, uint64_t> splitPtrBaseOffset(Expr ptr) {
+  uint64_t offset = 0;
+  Expr base = ptr;
+  while (base) {
+    if (bv::isBvNum(base)) {
+      offset += bv::toMpz(base).get_ui();
+      base = Expr();
+    } else if (isOpX<BADD>(base) && base->arity() == 2 &&
+               bv::isBvNum(base->arg(1))) {
+      offset += bv::toMpz(base->arg(1)).get_ui();
+      base = base->arg(0);
+    } else if (isOpX<BADD>(base) && base->arity() == 2 &&
+               bv::isBvNum(base->arg(0))) {
+      offset += bv::toMpz(base->arg(0)).get_ui();
+      base = base->arg(1);
+    } else if (isOpX<BSUB>(base) && base->arity() == 2 &&
+               bv::isBvNum(base->arg(1))) {
+      offset -= bv::toMpz(base->arg(1)).get_ui();
+      base = base->arg(0);
+    } else
+      break;
+  }
+  return {base, offset};
+}
+
+Expr OpSemMemLambdaRepr::makeITE(Expr addr, const ExprVector &ptrKeys,
+                                 const ExprVector &vals, Expr fallback) {
+  if (LambdaIteOpt == LambdaIteKind::TREE)
+    return makeTreeITE(addr, ptrKeys, vals, fallback);
+  return makeLinearITE(addr, ptrKeys, vals, fallback);
+}
+
+Expr OpSemMemLambdaRepr::makeTreeITE(Expr addr, const ExprVector &ptrKeys,
+                                     const ExprVector &vals, Expr fallback) {
+  assert(ptrKeys.size() == vals.size());
+
+  // -- keys are grouped into maximal runs with the same symbolic base (null
+  // -- base for numeric keys). A run only tests (addr - base) against
+  // -- numerals, so it can be resolved by a binary search. Runs are chained
+  // -- in order, which preserves the first-match priority of the linear ITE.
+  struct Group {
+    Expr base;
+    std::vector<std::pair<uint64_t, Expr>> entries;
+  };
+  std::vector<Group> groups;
+  for (size_t i = 0, sz = ptrKeys.size(); i < sz; ++i) {
+    auto bo = splitPtrBaseOffset(ptrKeys[i]);
+    if (groups.empty() || groups.back().base != bo.first)
+      groups.push_back(Group{bo.first, {}});
+    groups.back().entries.emplace_back(bo.second, vals[i]);
+  }
+
+  const unsigned ptrBits = m_memManager.ptrSzInBits();
+  const uint64_t mask =
+      ptrBits >= 64 ? ~uint64_t(0) : ((uint64_t(1) << ptrBits) - 1);
+
+  Expr res = fallback;
+  for (auto it = groups.rbegin(), end = groups.rend(); it != end; ++it) {
+    auto &entries = it->entries;
+    for (auto &e : entries)
+      e.first &= mask;
+    // -- stable sort + unique keeps the first (highest priority) write
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const std::pair<uint64_t, Expr> &a,
+                        const std::pair<uint64_t, Expr> &b) {
+                       return a.first < b.first;
+                     });
+    entries.erase(std::unique(entries.begin(), entries.end(),
+                              [](const std::pair<uint64_t, Expr> &a,
+                                 const std::pair<uint64_t, Expr> &b) {
+                                return a.first == b.first;
+                              }),
+                  entries.end());
+
+    Expr key = it->base ? m_memManager.ptrSub(addr, it->base) : addr;
+    res = makeTreeITE(key, entries, 0, entries.size(), res);
+  }
+  return res;
+}
+
+Expr OpSemMemLambdaRepr::makeTreeITE(
+    Expr key, const std::vector<std::pair<uint64_t, Expr>> &entries,
+    size_t lo, size_t hi, Expr fallback) {
+  assert(lo < hi);
+  const unsigned ptrBits = m_memManager.ptrSzInBits();
+  if (hi - lo == 1) {
+    Expr k = m_ctx.alu().si(entries[lo].first, ptrBits);
+    return boolop::lite(m_memManager.ptrEq(key, k), entries[lo].second,
+                        fallback);
+  }
+
+  size_t mid = lo + (hi - lo) / 2;
+  Expr pivot = m_ctx.alu().si(entries[mid].first, ptrBits);
+  return boolop::lite(m_memManager.ptrUlt(key, pivot),
+                      makeTreeITE(key, entries, lo, mid, fallback),
+                      makeTreeITE(key, entries, mid, hi, fallback));
+}
+
 Expr OpSemMemLambdaRepr::MemFill(Expr dPtr, char *sPtr, unsigned len, Expr mem,
                                  unsigned wordSzInBytes, Expr ptrSort,
                                  uint32_t align) {
@@ -210,7 +330,7 @@ Expr OpSemMemLambdaRepr::MemFill(Expr dPtr, char *sPtr, unsigned len, Expr mem,
 
   Expr b0 = bind::bvar(0, ptrSort);
   Expr fallback = loadAlignedWordFromMem(b0, initial);
-  Expr ite = makeLinearITE(b0, ptrs, vals, fallback);
+  Expr ite = makeITE(b0, ptrs, vals, fallback);
   Expr addr = bind::mkConst(mkTerm<std::string>("addr", m_efac), ptrSort);
   Expr decl = bind::fname(addr);
   Expr res = mk<LAMBDA>(decl, ite);
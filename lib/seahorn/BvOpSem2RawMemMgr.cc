@@ -7,6 +7,7 @@
 #include "seahorn/Expr/ExprLlvm.hh"
 #include "seahorn/Support/SeaDebug.h"
 #include "seahorn/Support/SeaLog.hh"
+#include "seahorn/Support/Stats.hh"
 
 namespace seahorn {
 namespace details {
@@ -30,6 +31,24 @@ static llvm::cl::opt<bool> IgnoreAlignmentOpt(
                    "operations are word aligned"),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> ConcreteMemCacheOpt(
+    "horn-bv2-concrete-mem-cache",
+    llvm::cl::desc("Resolve loads and stores at known addresses against "
+                   "earlier writes during symbolic execution"),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<unsigned> ConcreteMemCacheDepth(
+    "horn-bv2-concrete-mem-cache-depth",
+    llvm::cl::desc("Maximal number of writes inspected by the concrete "
+                   "memory cache"),
+    llvm::cl::init(256), llvm::cl::Hidden);
+
+static llvm::cl::opt<bool> WideUnalignedOpt(
+    "horn-bv2-wide-unaligned",
+    llvm::cl::desc("Encode unaligned accesses by a single shift over the "
+                   "words that cover the access instead of byte by byte"),
+    llvm::cl::init(false));
+
 namespace seahorn {
 namespace details {
 
@@ -44,7 +63,8 @@ using PtrTy = RawMemManager::PtrTy;
 RawMemManager::RawMemManager(Bv2OpSem &sem, Bv2OpSemContext &ctx,
                              unsigned ptrSz, unsigned wordSz, bool useLambdas)
     : OpSemMemManager(sem, ctx, ptrSz, wordSz),
-      m_freshPtrName(mkTerm<std::string>("sea.ptr", m_efac)), m_id(0) {
+      m_freshPtrName(mkTerm<std::string>("sea.ptr", m_efac)), m_id(0),
+      m_useLambdas(useLambdas) {
   if (MemAllocatorOpt == MemAllocatorKind::NORMAL_ALLOCATOR)
     m_allocator = mkNormalOpSemAllocator(*this);
   else if (MemAllocatorOpt == MemAllocatorKind::STATIC_ALLOCATOR)
@@ -287,6 +307,91 @@ Expr RawMemManager::extractUnalignedByte(Expr mem, PtrTy address,
   return bv::extract(7, 0, mk<BLSHR>(alignedWord, bitOffset));
 }
 
+namespace {
+/// \brief Address with a symbolic base and a numeric offset
+///
+/// Two addresses with the same base are equal iff their offsets are equal.
+/// Nothing is known about addresses with different bases.
+struct KnownAddr {
+  Expr m_base;
+  uint64_t m_offset;
+
+  KnownAddr(Expr ptr, unsigned ptrSzInBits) {
+    std::tie(m_base, m_offset) = splitPtrBaseOffset(ptr);
+    if (ptrSzInBits < 64)
+      m_offset &= (uint64_t(1) << ptrSzInBits) - 1;
+  }
+};
+} // namespace
+
+Expr RawMemManager::loadAlignedWord(PtrTy ptr, MemValTy mem) {
+  if (!ConcreteMemCacheOpt || m_useLambdas)
+    return m_memRepr->loadAlignedWordFromMem(ptr, mem);
+
+  KnownAddr addr(ptr, ptrSzInBits());
+  Expr cur = mem;
+  for (unsigned d = 0; d < ConcreteMemCacheDepth; ++d) {
+    unsigned width;
+    if (isOpX<CONST_ARRAY>(cur) && bv::isBvNum(cur->arg(1), width) &&
+        width == wordSzInBits()) {
+      Stats::count("opsem.mem.cache.select.elim");
+      return cur->arg(1);
+    }
+    if (!isOpX<STORE>(cur))
+      break;
+    KnownAddr k(cur->arg(1), ptrSzInBits());
+    // -- cannot tell whether the addresses alias
+    if (k.m_base != addr.m_base)
+      break;
+    if (k.m_offset == addr.m_offset) {
+      Stats::count("opsem.mem.cache.select.elim");
+      return cur->arg(2);
+    }
+    cur = cur->arg(0);
+  }
+  if (cur != mem)
+    Stats::count("opsem.mem.cache.select.short");
+  return m_memRepr->loadAlignedWordFromMem(ptr, cur);
+}
+
+Expr RawMemManager::storeAlignedWord(Expr val, PtrTy ptr, MemValTy mem) {
+  if (!ConcreteMemCacheOpt || m_useLambdas)
+    return m_memRepr->storeAlignedWordToMem(val, ptr, ptrSort(), mem);
+
+  // -- writes on top of the last write with an unrelated base are kept
+  // -- unique per address, i.e., they form a sparse map that is only
+  // -- materialized as a chain of stores
+  KnownAddr addr(ptr, ptrSzInBits());
+  SmallVector<Expr, 16> run;
+  Expr cur = mem;
+  for (unsigned d = 0; d < ConcreteMemCacheDepth; ++d) {
+    if (isOpX<CONST_ARRAY>(cur) && cur->arg(1) == val) {
+      Stats::count("opsem.mem.cache.store.elim");
+      return mem;
+    }
+    if (!isOpX<STORE>(cur))
+      break;
+    KnownAddr k(cur->arg(1), ptrSzInBits());
+    if (k.m_base != addr.m_base)
+      break;
+    if (k.m_offset == addr.m_offset) {
+      Stats::count("opsem.mem.cache.store.elim");
+      // -- same value is already there
+      if (cur->arg(2) == val)
+        return mem;
+      // -- drop the overwritten store and rebuild the run above it
+      Expr res = cur->arg(0);
+      for (auto it = run.rbegin(), end = run.rend(); it != end; ++it)
+        res = m_memRepr->storeAlignedWordToMem((*it)->arg(2), (*it)->arg(1),
+                                               ptrSort(), res);
+      return m_memRepr->storeAlignedWordToMem(val, ptr, ptrSort(), res);
+    }
+    run.push_back(cur);
+    cur = cur->arg(0);
+  }
+  return m_memRepr->storeAlignedWordToMem(val, ptr, ptrSort(), mem);
+}
+
 /// \brief Loads an integer of a given size from memory register
 ///
 /// \param[in] ptr pointer being accessed
@@ -299,6 +404,8 @@ Expr RawMemManager::loadIntFromMem(PtrTy ptr, MemValTy mem, unsigned byteSz,
   SmallVector<Expr, 16> words;
   unsigned offsetBits = getByteAlignmentBits();
   if (!IgnoreAlignmentOpt && offsetBits != 0 && align % wordSzInBytes() != 0) {
+    if (WideUnalignedOpt)
+      return loadUnalignedIntFromMem(ptr, mem, byteSz, offsetBits);
     for (unsigned i = 0; i < byteSz; i++) {
       Expr byteOfWord = extractUnalignedByte(mem, ptrAdd(ptr, i), offsetBits);
       words.push_back(byteOfWord);
@@ -306,7 +413,7 @@ Expr RawMemManager::loadIntFromMem(PtrTy ptr, MemValTy mem, unsigned byteSz,
   } else {
     // -- read all words
     for (unsigned i = 0; i < byteSz; i += wordSzInBytes()) {
-      words.push_back(m_memRepr->loadAlignedWordFromMem(ptrAdd(ptr, i), mem));
+      words.push_back(loadAlignedWord(ptrAdd(ptr, i), mem));
     }
   }
 
@@ -325,6 +432,34 @@ Expr RawMemManager::loadIntFromMem(PtrTy ptr, MemValTy mem, unsigned byteSz,
   return res;
 }
 
+/// \brief Loads an integer from an address that is not word aligned by
+/// reading all words covering the access and shifting them once
+Expr RawMemManager::loadUnalignedIntFromMem(PtrTy ptr, MemValTy mem,
+                                            unsigned byteSz,
+                                            unsigned offsetBits) {
+  // -- the access starts somewhere in the first word and might spill over
+  // -- into the word after the last one that is fully covered
+  unsigned numWords = (byteSz + wordSzInBytes() - 1) / wordSzInBytes() + 1;
+  unsigned wideSz = numWords * wordSzInBits();
+
+  PtrTy wordAddress = bv::extract(ptrSzInBits() - 1, offsetBits, ptr);
+  PtrTy alignedPtr =
+      bv::concat(wordAddress, bv::bvnum(0L, offsetBits, ptr->efac()));
+
+  Expr wide;
+  for (unsigned i = 0; i < numWords; ++i) {
+    Expr w = loadAlignedWord(ptrAdd(alignedPtr, i * wordSzInBytes()), mem);
+    wide = wide ? bv::concat(w, wide) : w;
+  }
+
+  // (x << 3) to get bit offset; zero extend to the width of the wide word
+  PtrTy byteOffset = bv::extract(offsetBits - 1, 0, ptr);
+  PtrTy bitOffset = bv::concat(bv::zext(byteOffset, wideSz - 3),
+                               bv::bvnum(0U, 3, ptr->efac()));
+
+  return bv::extract(byteSz * 8 - 1, 0, mk<BLSHR>(wide, bitOffset));
+}
+
 /// \brief Loads a pointer stored in memory
 /// \sa loadIntFromMem
 PtrTy RawMemManager::loadPtrFromMem(PtrTy ptr, MemValTy mem, unsigned byteSz,
@@ -362,6 +497,8 @@ Expr RawMemManager::storeIntToMem(Expr _val, PtrTy ptr, MemValTy mem,
   unsigned offsetBits = getByteAlignmentBits();
   bool wordAligned = offsetBits == 0 || align % wordSzInBytes() == 0;
   if (!IgnoreAlignmentOpt && !wordAligned) {
+    if (WideUnalignedOpt)
+      return storeUnalignedWideIntToMem(val, ptr, mem, byteSz);
     return storeUnalignedIntToMem(val, ptr, mem, byteSz);
   }
 
@@ -381,8 +518,7 @@ Expr RawMemManager::storeIntToMem(Expr _val, PtrTy ptr, MemValTy mem,
 
   Expr res;
   for (unsigned i = 0; i < words.size(); ++i) {
-    res = m_memRepr->storeAlignedWordToMem(
-        words[i], ptrAdd(ptr, i * wordSzInBytes()), ptrSort(), mem);
+    res = storeAlignedWord(words[i], ptrAdd(ptr, i * wordSzInBytes()), mem);
     mem = res;
   }
 
@@ -421,6 +557,52 @@ Expr RawMemManager::storeUnalignedIntToMem(Expr val, PtrTy ptr, MemValTy mem,
   return res;
 }
 
+/// \brief stores integer into memory, address is not word aligned. All words
+/// covering the access are updated with a single shift and mask
+///
+/// \sa storeUnalignedIntToMem
+Expr RawMemManager::storeUnalignedWideIntToMem(Expr val, PtrTy ptr,
+                                               MemValTy mem, unsigned byteSz) {
+  unsigned offsetBits = getByteAlignmentBits();
+  assert(offsetBits != 0);
+
+  unsigned numWords = (byteSz + wordSzInBytes() - 1) / wordSzInBytes() + 1;
+  unsigned wideSz = numWords * wordSzInBits();
+
+  PtrTy wordAddress = bv::extract(ptrSzInBits() - 1, offsetBits, ptr);
+  PtrTy alignedPtr =
+      bv::concat(wordAddress, bv::bvnum(0L, offsetBits, ptr->efac()));
+
+  SmallVector<PtrTy, 4> wordPtrs;
+  Expr wide;
+  for (unsigned i = 0; i < numWords; ++i) {
+    wordPtrs.push_back(ptrAdd(alignedPtr, i * wordSzInBytes()));
+    Expr w = loadAlignedWord(wordPtrs.back(), mem);
+    wide = wide ? bv::concat(w, wide) : w;
+  }
+
+  PtrTy byteOffset = bv::extract(offsetBits - 1, 0, ptr);
+  PtrTy bitOffset = bv::concat(bv::zext(byteOffset, wideSz - 3),
+                               bv::bvnum(0U, 3, ptr->efac()));
+
+  // -- clear the bytes being written and or-in the shifted value
+  Expr ones = bv::zext(bv::bvnum(expr::mpz_class(std::string(byteSz * 2, 'f'),
+                                                 16),
+                                 byteSz * 8, m_efac),
+                       wideSz);
+  Expr mask = mk<BNOT>(mk<BSHL>(ones, bitOffset));
+  Expr shiftedVal = mk<BSHL>(bv::zext(val, wideSz), bitOffset);
+  wide = mk<BOR>(mk<BAND>(wide, mask), shiftedVal);
+
+  Expr res = mem;
+  for (unsigned i = 0; i < numWords; ++i) {
+    unsigned lowBit = i * wordSzInBits();
+    Expr w = bv::extract(lowBit + wordSzInBits() - 1, lowBit, wide);
+    res = storeAlignedWord(w, wordPtrs[i], res);
+  }
+  return res;
+}
+
 /// \brief Given a word, updates a byte
 ///
 /// \param word existing word
@@ -30,6 +30,17 @@ class RawMemManager : public OpSemMemManager {
   /// \brief A null pointer expression (cache)
   Expr m_nullPtr;
 
+  /// \brief True if memory is represented by lambdas
+  bool m_useLambdas;
+
+  /// \brief Loads an aligned word, resolving the load against known writes
+  /// to the same address when possible
+  Expr loadAlignedWord(PtrTy ptr, MemValTy mem);
+
+  /// \brief Stores an aligned word, replacing an earlier write to the same
+  /// address when possible
+  Expr storeAlignedWord(Expr val, PtrTy ptr, MemValTy mem);
+
 public:
   RawMemManager(Bv2OpSem &sem, Bv2OpSemContext &ctx, unsigned ptrSz,
                 unsigned wordSz, bool useLambdas = false);
@@ -55,6 +66,11 @@ public:
   /// \brief Pointer to start of the heap
   PtrTy brk0Ptr() override;
 
+  /// \brief Maximal legal range of the stack pointer
+  OpSemAllocator::AddrInterval getStackRange() const {
+    return m_allocator->getStackRange();
+  }
+
   /// \brief Allocates memory on the heap and returns a pointer to it
   PtrTy halloc(unsigned _bytes, uint32_t align = 0) override;
 
@@ -125,6 +141,13 @@ public:
   /// \return symbolic value of the byte at the specified address
   Expr extractUnalignedByte(Expr mem, PtrTy address, unsigned offsetBits);
 
+  /// \brief Loads an integer from an address that is not word aligned by
+  /// reading all words covering the access and shifting them once
+  ///
+  /// \sa extractUnalignedByte
+  Expr loadUnalignedIntFromMem(PtrTy ptr, MemValTy mem, unsigned byteSz,
+                               unsigned offsetBits);
+
   /// \brief Loads an integer of a given size from memory register
   ///
   /// \param[in] ptr pointer being accessed
@@ -153,6 +176,13 @@ public:
   Expr storeUnalignedIntToMem(Expr val, PtrTy ptr, MemValTy mem,
                               unsigned byteSz);
 
+  /// \brief stores integer into memory, address is not word aligned. All
+  /// words covering the access are updated with a single shift and mask
+  ///
+  /// \sa storeUnalignedIntToMem
+  Expr storeUnalignedWideIntToMem(Expr val, PtrTy ptr, MemValTy mem,
+                                  unsigned byteSz);
+
   /// \brief Stores a pointer into memory
   /// \sa storeIntToMem
   Expr storePtrToMem(PtrTy val, PtrTy ptr, MemValTy mem, unsigned byteSz,
@@ -0,0 +1,603 @@
+#include "BvOpSem2Context.hh"
+#include "BvOpSem2RawMemMgr.hh"
+
+#include "llvm/IR/GetElementPtrTypeIterator.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+
+#include "seahorn/Expr/ExprLlvm.hh"
+#include "seahorn/Expr/ExprOpBinder.hh"
+#include "seahorn/Expr/ExprOpStruct.hh"
+#include "seahorn/Support/SeaDebug.h"
+#include "seahorn/Support/SeaLog.hh"
+#include "seahorn/Support/Stats.hh"
+
+#include <functional>
+#include <limits>
+#include <map>
+
+static llvm::cl::opt<bool> SplitMemTrustBase(
+    "horn-bv2-split-mem-trust-base",
+    llvm::cl::desc("Assume that an access at <global address> + <symbolic "
+                   "offset> stays within that global (as for inbounds gep)"),
+    llvm::cl::init(false), llvm::cl::Hidden);
+
+namespace seahorn {
+namespace details {
+
+/// \brief Memory manager that splits memory into per-allocation arrays
+///
+/// Every global variable is given its own array. Everything else (stack,
+/// heap, and memory of unknown provenance) is kept in a merged array. A memory
+/// value is a struct whose field 0 is the merged array and field i+1 is the
+/// array of the i-th region.
+///
+/// The logical content of memory at address \c a is \c region_i[a] if \c a is
+/// in the address interval of \c region_i, and \c merged[a] otherwise.
+/// Accesses that are known to be entirely in one region, or entirely outside
+/// of all regions, go directly to the corresponding array. This covers
+/// globals at constant addresses and accesses relative to the stack pointer.
+/// Other accesses, including to the heap whose pointers are unconstrained,
+/// are dispatched by an ITE over region intervals. Accesses that straddle the
+/// boundary of a region are split into bytes.
+class SplitMemManager : public OpSemMemManager {
+public:
+  using PtrTy = OpSemMemManager::PtrTy;
+  using MemValTy = OpSemMemManager::MemValTy;
+
+private:
+  /// \brief A region of memory with its own array
+  struct Region {
+    /// \brief Global variable that owns the region
+    const GlobalVariable *m_gv;
+    /// \brief Start address. Only valid if \c m_allocated
+    uint64_t m_start;
+    /// \brief End address (exclusive). Only valid if \c m_allocated
+    uint64_t m_end;
+    /// \brief True if the global has been laid out in memory
+    bool m_allocated;
+
+    Region(const GlobalVariable &gv)
+        : m_gv(&gv), m_start(0), m_end(0), m_allocated(false) {}
+  };
+
+  /// \brief Field of accesses that cannot be resolved statically
+  static constexpr unsigned UNKNOWN_FIELD = ~0u;
+
+  /// \brief Memory manager for the underlying arrays
+  RawMemManager m_mem;
+
+  /// \brief All regions. The set is fixed on first access to the module
+  /// since it determines the sort of memory registers
+  mutable std::vector<Region> m_regions;
+  mutable bool m_hasRegions = false;
+  /// \brief Map from a global variable to its region index
+  mutable DenseMap<const GlobalVariable *, unsigned> m_gvToRegion;
+  /// \brief Allocated regions by start address
+  std::map<uint64_t, unsigned> m_regionByStart;
+
+  /// \brief Computes the set of regions for a module
+  void initRegions(const Module &M) const {
+    if (m_hasRegions)
+      return;
+    m_hasRegions = true;
+    for (const GlobalVariable &gv : M.globals()) {
+      if (m_sem.isSkipped(gv))
+        continue;
+      if (gv.getSection().equals("llvm.metadata"))
+        continue;
+      m_gvToRegion[&gv] = m_regions.size();
+      m_regions.emplace_back(gv);
+    }
+    LOG("opsem.split", errs() << "split memory into " << m_regions.size()
+                              << " regions\n";);
+  }
+
+  unsigned numFields() const {
+    assert(m_hasRegions);
+    return m_regions.size() + 1;
+  }
+
+  /// \brief Returns the array of a field of a memory value
+  MemValTy getField(MemValTy mem, unsigned fld) const {
+    return strct::extractVal(mem, fld);
+  }
+  /// \brief Updates the array of a field of a memory value
+  MemValTy setField(MemValTy mem, unsigned fld, MemValTy v) const {
+    return strct::insertVal(mem, fld, v);
+  }
+
+  /// \brief Returns the field of the region that contains the address
+  /// interval [lo, hi), 0 if the interval is outside of all regions, and
+  /// UNKNOWN_FIELD if it straddles the boundary of a region
+  unsigned resolveInterval(uint64_t lo, uint64_t hi) const {
+    auto it = m_regionByStart.lower_bound(hi);
+    if (it == m_regionByStart.begin())
+      return 0;
+    // -- regions are disjoint, so the last one that starts below hi is the
+    // -- only one that can overlap the interval
+    --it;
+    const Region &r = m_regions[it->second];
+    if (r.m_end <= lo)
+      return 0;
+    return r.m_start <= lo && hi <= r.m_end ? it->second + 1 : UNKNOWN_FIELD;
+  }
+
+  /// \brief Returns the field of a memory value that contains all \p byteSz
+  /// bytes at \p ptr if it is statically known, and UNKNOWN_FIELD otherwise
+  unsigned resolveField(PtrTy ptr, unsigned byteSz) {
+    if (m_regionByStart.empty())
+      return 0;
+
+    const unsigned bits = ptrSzInBits();
+    const uint64_t addrLimit =
+        bits < 64 ? uint64_t(1) << bits : std::numeric_limits<uint64_t>::max();
+    auto bo = splitPtrBaseOffset(ptr);
+    uint64_t addr = bo.second & (addrLimit - 1);
+    // -- the offset as a signed number of ptrSzInBits() bits
+    int64_t offset = bits < 64 && addr >= addrLimit / 2
+                         ? int64_t(addr) - int64_t(addrLimit)
+                         : int64_t(addr);
+
+    // -- [lo, hi) is an interval of addresses that contains the access
+    int64_t lo, hi;
+    if (!bo.first) {
+      lo = addr;
+      hi = lo + byteSz;
+    } else if (bo.first == splitPtrBaseOffset(m_mem.mkStackPtr(0)).first) {
+      // -- the stack pointer is in the stack range on function entry
+      auto stack = m_mem.getStackRange();
+      lo = int64_t(stack.first) + offset;
+      hi = int64_t(stack.second) + offset + byteSz;
+    } else if (SplitMemTrustBase) {
+      // -- the access is assumed to be in the object at the numeric part
+      lo = addr;
+      hi = lo + byteSz;
+      unsigned fld = resolveInterval(lo, hi);
+      return fld > 0 ? fld : UNKNOWN_FIELD;
+    } else
+      return UNKNOWN_FIELD;
+
+    if (lo < 0 || uint64_t(hi) > addrLimit)
+      return UNKNOWN_FIELD;
+    return resolveInterval(lo, hi);
+  }
+
+  /// \brief Constraint that all \p byteSz bytes at \p ptr are in region \p r
+  Expr inRegion(PtrTy ptr, unsigned byteSz, const Region &r) const {
+    assert(r.m_allocated);
+    if (r.m_end - r.m_start < byteSz)
+      return mk<FALSE>(m_efac);
+    Expr start = m_ctx.alu().si(r.m_start, ptrSzInBits());
+    Expr last = m_ctx.alu().si(r.m_end - byteSz, ptrSzInBits());
+    return mk<AND>(m_mem.ptrUle(start, ptr), m_mem.ptrUle(ptr, last));
+  }
+
+  /// \brief Constraint that some but not all of the \p byteSz bytes at \p ptr
+  /// are in region \p r
+  Expr straddlesRegion(PtrTy ptr, unsigned byteSz, const Region &r) const {
+    assert(r.m_allocated);
+    assert(byteSz > 1);
+    Expr end = m_ctx.alu().si(r.m_end, ptrSzInBits());
+    Expr overlaps = m_mem.ptrUlt(ptr, end);
+    if (r.m_start >= byteSz) {
+      Expr first = m_ctx.alu().si(r.m_start - byteSz, ptrSzInBits());
+      overlaps = mk<AND>(overlaps, m_mem.ptrUgt(ptr, first));
+    }
+    return mk<AND>(overlaps, mk<NEG>(inRegion(ptr, byteSz, r)));
+  }
+
+  /// \brief Loads \p byteSz bytes at \p ptr one by one
+  Expr loadBytes(PtrTy ptr, MemValTy mem, unsigned byteSz) {
+    Expr res;
+    for (unsigned i = 0; i < byteSz; ++i) {
+      Expr b = loadIntFromMem(ptrAdd(ptr, i), mem, 1, 1);
+      res = res ? bv::concat(b, res) : b;
+    }
+    return res;
+  }
+
+  /// \brief Stores the \p byteSz bytes of \p val at \p ptr one by one
+  MemValTy storeBytes(Expr val, PtrTy ptr, MemValTy mem, unsigned byteSz) {
+    for (unsigned i = 0; i < byteSz; ++i)
+      mem = storeIntToMem(bv::extract(i * 8 + 7, i * 8, val), ptrAdd(ptr, i),
+                          mem, 1, 1);
+    return mem;
+  }
+
+  /// \brief Load from an unresolved address
+  ///
+  /// \param load reads the value from one array
+  /// \param loadStraddling reads the value when it straddles a region
+  Expr dispatchLoad(PtrTy ptr, MemValTy mem, unsigned byteSz,
+                    std::function<Expr(Expr)> load,
+                    std::function<Expr()> loadStraddling) {
+    Stats::count("opsem.split.dispatch");
+    Expr res = load(getField(mem, 0));
+    ExprVector straddles;
+    for (unsigned i = 0, sz = m_regions.size(); i < sz; ++i) {
+      const Region &r = m_regions[i];
+      if (!r.m_allocated)
+        continue;
+      res = boolop::lite(inRegion(ptr, byteSz, r), load(getField(mem, i + 1)),
+                         res);
+      if (byteSz > 1)
+        straddles.push_back(straddlesRegion(ptr, byteSz, r));
+    }
+    if (!straddles.empty())
+      res = boolop::lite(mknary<OR>(mk<FALSE>(m_efac), straddles),
+                         loadStraddling(), res);
+    return res;
+  }
+
+  /// \brief Store to an unresolved address
+  ///
+  /// \param store writes the value to one array
+  /// \param storeStraddling writes the value when it straddles a region
+  MemValTy dispatchStore(PtrTy ptr, MemValTy mem, unsigned byteSz,
+                         std::function<Expr(Expr)> store,
+                         std::function<MemValTy()> storeStraddling) {
+    Stats::count("opsem.split.dispatch");
+    llvm::SmallVector<Expr, 8> kids;
+    // -- content of the merged array inside of regions is never observed,
+    // -- so the store to it need not be guarded
+    kids.push_back(store(getField(mem, 0)));
+    ExprVector straddles;
+    for (unsigned i = 0, sz = m_regions.size(); i < sz; ++i) {
+      const Region &r = m_regions[i];
+      Expr arr = getField(mem, i + 1);
+      if (r.m_allocated) {
+        arr = bind::lite(inRegion(ptr, byteSz, r), store(arr), arr);
+        if (byteSz > 1)
+          straddles.push_back(straddlesRegion(ptr, byteSz, r));
+      }
+      kids.push_back(arr);
+    }
+    if (!straddles.empty()) {
+      Expr cond = mknary<OR>(mk<FALSE>(m_efac), straddles);
+      MemValTy bytes = storeStraddling();
+      for (unsigned i = 0, sz = kids.size(); i < sz; ++i)
+        kids[i] = bind::lite(cond, getField(bytes, i), kids[i]);
+    }
+    return strct::mk(kids);
+  }
+
+  /// \brief Records the address interval of a newly laid out global
+  void onGlobalAllocated(const GlobalVariable &gv, PtrTy start) {
+    auto it = m_gvToRegion.find(&gv);
+    if (it == m_gvToRegion.end() || !m_ctx.alu().isNum(start))
+      return;
+    Region &r = m_regions[it->second];
+    if (r.m_allocated)
+      return;
+    uint64_t sz = m_sem.getTD().getTypeAllocSize(gv.getValueType());
+    if (sz == 0)
+      return;
+    r.m_start = m_ctx.alu().toNum(start).get_ui();
+    r.m_end = r.m_start + sz;
+    r.m_allocated = true;
+    m_regionByStart[r.m_start] = it->second;
+  }
+
+public:
+  SplitMemManager(Bv2OpSem &sem, Bv2OpSemContext &ctx, unsigned ptrSz,
+                  unsigned wordSz, bool useLambdas = false);
+
+  ~SplitMemManager() override = default;
+
+  PtrTy ptrSort() const override { return m_mem.ptrSort(); }
+
+  PtrTy salloc(unsigned bytes, uint32_t align = 0) override {
+    return m_mem.salloc(bytes, align);
+  }
+  PtrTy salloc(Expr elmts, unsigned typeSz, uint32_t align = 0) override {
+    return m_mem.salloc(elmts, typeSz, align);
+  }
+  PtrTy mkStackPtr(unsigned offset) override {
+    return m_mem.mkStackPtr(offset);
+  }
+  PtrTy brk0Ptr() override { return m_mem.brk0Ptr(); }
+  PtrTy halloc(unsigned _bytes, uint32_t align = 0) override {
+    return m_mem.halloc(_bytes, align);
+  }
+  PtrTy halloc(Expr bytes, uint32_t align = 0) override {
+    return m_mem.halloc(bytes, align);
+  }
+
+  PtrTy galloc(const GlobalVariable &gv, uint32_t align = 0) override {
+    PtrTy res = m_mem.galloc(gv, align);
+    onGlobalAllocated(gv, res);
+    return res;
+  }
+
+  PtrTy falloc(const Function &fn) override { return m_mem.falloc(fn); }
+  PtrTy getPtrToFunction(const Function &F) override {
+    return m_mem.getPtrToFunction(F);
+  }
+  PtrTy getPtrToGlobalVariable(const GlobalVariable &gv) override {
+    PtrTy res = m_mem.getPtrToGlobalVariable(gv);
+    onGlobalAllocated(gv, res);
+    return res;
+  }
+  void initGlobalVariable(const GlobalVariable &gv) const override {
+    m_mem.initGlobalVariable(gv);
+  }
+  PtrTy mkAlignedPtr(Expr name, uint32_t align) const override {
+    return m_mem.mkAlignedPtr(name, align);
+  }
+  Expr mkPtrRegisterSort(const Instruction &inst) const override {
+    return m_mem.mkPtrRegisterSort(inst);
+  }
+  Expr mkPtrRegisterSort(const Function &fn) const override {
+    return m_mem.mkPtrRegisterSort(fn);
+  }
+  Expr mkPtrRegisterSort(const GlobalVariable &gv) const override {
+    return m_mem.mkPtrRegisterSort(gv);
+  }
+
+  /// \brief Returns sort of memory-holding register for an instruction
+  Expr mkMemRegisterSort(const Instruction &inst) const override {
+    initRegions(*inst.getModule());
+    ExprVector kids(numFields(), m_mem.mkMemRegisterSort(inst));
+    return sort::structTy(kids);
+  }
+
+  PtrTy freshPtr() override { return m_mem.freshPtr(); }
+  PtrTy nullPtr() const override { return m_mem.nullPtr(); }
+
+  Expr coerce(Expr sort, Expr val) override {
+    if (strct::isStructVal(val)) {
+      llvm::SmallVector<Expr, 8> kids;
+      assert(isOp<STRUCT_TY>(sort));
+      assert(sort->arity() == val->arity());
+      for (unsigned i = 0, sz = val->arity(); i < sz; ++i)
+        kids.push_back(coerce(sort->arg(i), val->arg(i)));
+      return strct::mk(kids);
+    }
+    return m_mem.coerce(sort, val);
+  }
+
+  PtrTy ptrAdd(PtrTy ptr, int32_t _offset) const override {
+    return m_mem.ptrAdd(ptr, _offset);
+  }
+  PtrTy ptrAdd(PtrTy ptr, Expr offset) const override {
+    return m_mem.ptrAdd(ptr, offset);
+  }
+
+  Expr loadIntFromMem(PtrTy ptr, MemValTy mem, unsigned byteSz,
+                      uint64_t align) override {
+    unsigned fld = resolveField(ptr, byteSz);
+    if (fld != UNKNOWN_FIELD) {
+      Stats::count("opsem.split.direct");
+      return m_mem.loadIntFromMem(ptr, getField(mem, fld), byteSz, align);
+    }
+    return dispatchLoad(
+        ptr, mem, byteSz,
+        [&](Expr arr) {
+          return m_mem.loadIntFromMem(ptr, arr, byteSz, align);
+        },
+        [&]() { return loadBytes(ptr, mem, byteSz); });
+  }
+
+  PtrTy loadPtrFromMem(PtrTy ptr, MemValTy mem, unsigned byteSz,
+                       uint64_t align) override {
+    return loadIntFromMem(ptr, mem, byteSz, align);
+  }
+
+  MemValTy storeIntToMem(Expr _val, PtrTy ptr, MemValTy mem, unsigned byteSz,
+                         uint64_t align) override {
+    unsigned fld = resolveField(ptr, byteSz);
+    if (fld != UNKNOWN_FIELD) {
+      Stats::count("opsem.split.direct");
+      return setField(mem, fld,
+                      m_mem.storeIntToMem(_val, ptr, getField(mem, fld),
+                                          byteSz, align));
+    }
+    return dispatchStore(
+        ptr, mem, byteSz,
+        [&](Expr arr) {
+          return m_mem.storeIntToMem(_val, ptr, arr, byteSz, align);
+        },
+        [&]() { return storeBytes(_val, ptr, mem, byteSz); });
+  }
+
+  MemValTy storePtrToMem(PtrTy val, PtrTy ptr, MemValTy mem, unsigned byteSz,
+                         uint64_t align) override {
+    return storeIntToMem(val, ptr, mem, byteSz, align);
+  }
+
+  Expr loadValueFromMem(PtrTy ptr, MemValTy mem, const llvm::Type &ty,
+                        uint64_t align) override {
+    const unsigned byteSz =
+        m_sem.getTD().getTypeStoreSize(const_cast<llvm::Type *>(&ty));
+    unsigned fld = resolveField(ptr, byteSz);
+    // -- unsupported types are reported by m_mem
+    if (!ty.isIntegerTy() && !ty.isPointerTy())
+      fld = fld == UNKNOWN_FIELD ? 0 : fld;
+    if (fld != UNKNOWN_FIELD) {
+      Stats::count("opsem.split.direct");
+      return m_mem.loadValueFromMem(ptr, getField(mem, fld), ty, align);
+    }
+    return dispatchLoad(
+        ptr, mem, byteSz,
+        [&](Expr arr) { return m_mem.loadValueFromMem(ptr, arr, ty, align); },
+        [&]() {
+          Expr res = loadBytes(ptr, mem, byteSz);
+          if (ty.isIntegerTy() && ty.getScalarSizeInBits() < byteSz * 8)
+            res = m_ctx.alu().doTrunc(res, ty.getScalarSizeInBits());
+          return res;
+        });
+  }
+
+  MemValTy storeValueToMem(Expr _val, PtrTy ptr, MemValTy mem,
+                           const llvm::Type &ty, uint32_t align) override {
+    assert(ptr);
+    const unsigned byteSz =
+        m_sem.getTD().getTypeStoreSize(const_cast<llvm::Type *>(&ty));
+    unsigned fld = resolveField(ptr, byteSz);
+    // -- unsupported types are reported by m_mem
+    if (!ty.isIntegerTy() && !ty.isPointerTy())
+      fld = fld == UNKNOWN_FIELD ? 0 : fld;
+    if (fld != UNKNOWN_FIELD) {
+      Stats::count("opsem.split.direct");
+      Expr arr =
+          m_mem.storeValueToMem(_val, ptr, getField(mem, fld), ty, align);
+      return arr ? setField(mem, fld, arr) : Expr();
+    }
+    return dispatchStore(
+        ptr, mem, byteSz,
+        [&](Expr arr) {
+          return m_mem.storeValueToMem(_val, ptr, arr, ty, align);
+        },
+        [&]() {
+          Expr val = _val;
+          if (ty.isIntegerTy() && ty.getScalarSizeInBits() < byteSz * 8)
+            val = m_ctx.alu().doZext(val, byteSz * 8, ty.getScalarSizeInBits());
+          return storeBytes(val, ptr, mem, byteSz);
+        });
+  }
+
+  /// \brief Executes symbolic memset with a concrete length
+  MemValTy MemSet(PtrTy ptr, Expr _val, unsigned len, MemValTy mem,
+                  uint32_t align) override {
+    unsigned fld = resolveField(ptr, len);
+    if (fld != UNKNOWN_FIELD) {
+      Stats::count("opsem.split.direct");
+      Expr arr = m_mem.MemSet(ptr, _val, len, getField(mem, fld), align);
+      return arr ? setField(mem, fld, arr) : Expr();
+    }
+
+    // -- word-by-word through the dispatching store
+    unsigned width;
+    if (!bv::isBvNum(_val, width) || width != 8)
+      return Expr();
+    assert(wordSzInBytes() <= sizeof(unsigned long));
+    unsigned long word = 0;
+    memset(&word, bv::toMpz(_val).get_ui(), wordSzInBytes());
+    Expr wordVal = bv::bvnum(word, wordSzInBits(), m_efac);
+    for (unsigned i = 0; i < len; i += wordSzInBytes())
+      mem = storeIntToMem(wordVal, ptrAdd(ptr, i), mem, wordSzInBytes(),
+                          wordSzInBytes());
+    return mem;
+  }
+
+  /// \brief Executes symbolic memcpy with concrete length
+  MemValTy MemCpy(PtrTy dPtr, PtrTy sPtr, unsigned len, MemValTy memTrsfrRead,
+                  uint32_t align) override {
+    unsigned dFld = resolveField(dPtr, len);
+    unsigned sFld = resolveField(sPtr, len);
+    if (dFld != UNKNOWN_FIELD && dFld == sFld) {
+      Stats::count("opsem.split.direct");
+      Expr arr =
+          m_mem.MemCpy(dPtr, sPtr, len, getField(memTrsfrRead, dFld), align);
+      return arr ? setField(memTrsfrRead, dFld, arr) : Expr();
+    }
+
+    // -- same restrictions as RawMemManager::MemCpy
+    if (!(wordSzInBytes() == 1 || (wordSzInBytes() == 4 && align == 4)))
+      return Expr();
+
+    MemValTy res = memTrsfrRead;
+    for (unsigned i = 0; i < len; i += wordSzInBytes()) {
+      Expr val = loadIntFromMem(ptrAdd(sPtr, i), memTrsfrRead, wordSzInBytes(),
+                                wordSzInBytes());
+      res = storeIntToMem(val, ptrAdd(dPtr, i), res, wordSzInBytes(),
+                          wordSzInBytes());
+    }
+    return res;
+  }
+
+  /// \brief Executes symbolic memcpy from physical memory with concrete
+  /// length
+  MemValTy MemFill(PtrTy dPtr, char *sPtr, unsigned len, MemValTy mem,
+                   uint32_t align = 0) override {
+    unsigned fld = resolveField(dPtr, len);
+    if (fld != UNKNOWN_FIELD) {
+      Stats::count("opsem.split.direct");
+      Expr arr = m_mem.MemFill(dPtr, sPtr, len, getField(mem, fld), align);
+      return arr ? setField(mem, fld, arr) : Expr();
+    }
+
+    assert(sizeof(unsigned long) >= wordSzInBytes());
+    for (unsigned i = 0; i < len; i += wordSzInBytes()) {
+      unsigned long word = 0;
+      std::memcpy(&word, sPtr + i, std::min(wordSzInBytes(), len - i));
+      Expr val = bv::bvnum(word, wordSzInBits(), m_efac);
+      mem = storeIntToMem(val, ptrAdd(dPtr, i), mem, wordSzInBytes(),
+                          wordSzInBytes());
+    }
+    return mem;
+  }
+
+  PtrTy inttoptr(Expr intVal, const Type &intTy,
+                 const Type &ptrTy) const override {
+    return m_mem.inttoptr(intVal, intTy, ptrTy);
+  }
+  Expr ptrtoint(PtrTy ptr, const Type &ptrTy,
+                const Type &intTy) const override {
+    return m_mem.ptrtoint(ptr, ptrTy, intTy);
+  }
+
+  Expr ptrUlt(PtrTy p1, PtrTy p2) const override { return m_mem.ptrUlt(p1, p2); }
+  Expr ptrSlt(PtrTy p1, PtrTy p2) const override { return m_mem.ptrSlt(p1, p2); }
+  Expr ptrUle(PtrTy p1, PtrTy p2) const override { return m_mem.ptrUle(p1, p2); }
+  Expr ptrSle(PtrTy p1, PtrTy p2) const override { return m_mem.ptrSle(p1, p2); }
+  Expr ptrUgt(PtrTy p1, PtrTy p2) const override { return m_mem.ptrUgt(p1, p2); }
+  Expr ptrSgt(PtrTy p1, PtrTy p2) const override { return m_mem.ptrSgt(p1, p2); }
+  Expr ptrUge(PtrTy p1, PtrTy p2) const override { return m_mem.ptrUge(p1, p2); }
+  Expr ptrSge(PtrTy p1, PtrTy p2) const override { return m_mem.ptrSge(p1, p2); }
+  Expr ptrEq(PtrTy p1, PtrTy p2) const override { return m_mem.ptrEq(p1, p2); }
+  Expr ptrNe(PtrTy p1, PtrTy p2) const override { return m_mem.ptrNe(p1, p2); }
+  Expr ptrSub(PtrTy p1, PtrTy p2) const override { return m_mem.ptrSub(p1, p2); }
+
+  PtrTy gep(PtrTy ptr, gep_type_iterator it,
+            gep_type_iterator end) const override {
+    return m_mem.gep(ptr, it, end);
+  }
+
+  void onFunctionEntry(const Function &fn) override {
+    m_mem.onFunctionEntry(fn);
+  }
+
+  void onModuleEntry(const Module &M) override {
+    initRegions(M);
+    m_mem.onModuleEntry(M);
+  }
+
+  void dumpGlobalsMap() override {
+    m_mem.dumpGlobalsMap();
+    errs() << "Regions: \n";
+    for (auto &r : m_regions) {
+      if (!r.m_allocated)
+        continue;
+      errs() << llvm::format_hex(r.m_start, 16, true) << " - "
+             << llvm::format_hex(r.m_end, 16, true) << " @"
+             << r.m_gv->getName() << "\n";
+    }
+  }
+
+  std::pair<char *, unsigned>
+  getGlobalVariableInitValue(const llvm::GlobalVariable &gv) override {
+    return m_mem.getGlobalVariableInitValue(gv);
+  }
+
+  MemValTy zeroedMemory() const override {
+    ExprVector kids(numFields(), m_mem.zeroedMemory());
+    return strct::mk(kids);
+  }
+};
+
+SplitMemManager::SplitMemManager(Bv2OpSem &sem, Bv2OpSemContext &ctx,
+                                 unsigned ptrSz, unsigned wordSz,
+                                 bool useLambdas)
+    : OpSemMemManager(sem, ctx, ptrSz, wordSz),
+      m_mem(sem, ctx, ptrSz, wordSz, useLambdas) {}
+
+OpSemMemManager *mkSplitMemManager(Bv2OpSem &sem, Bv2OpSemContext &ctx,
+                                   unsigned ptrSz, unsigned wordSz,
+                                   bool useLambdas) {
+  return new SplitMemManager(sem, ctx, ptrSz, wordSz, useLambdas);
+}
+
+} // namespace details
+} // namespace seahorn
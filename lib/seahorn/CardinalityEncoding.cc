@@ -0,0 +1,163 @@
+#include "seahorn/CardinalityEncoding.hh"
+
+#include "seahorn/Expr/ExprOpBinder.hh"
+#include "seahorn/Expr/ExprOpVariant.hh"
+
+namespace seahorn {
+namespace card {
+using namespace expr::op;
+
+namespace {
+/// Builds the clauses of an encoding and names its auxiliary constants
+class Encoder {
+  Expr m_name;
+  unsigned m_fresh;
+  ExprVector m_clauses;
+
+public:
+  Encoder(Expr name)
+      : m_name(variant::tag(name, "card")), m_fresh(0) {}
+
+  Expr fresh() {
+    return bind::boolConst(variant::variant(m_fresh++, m_name));
+  }
+
+  /// a => b
+  void imply(Expr a, Expr b) { m_clauses.push_back(mk<IMPL>(a, b)); }
+  /// !(a && b)
+  void exclude(Expr a, Expr b) {
+    m_clauses.push_back(mk<OR>(mk<NEG>(a), mk<NEG>(b)));
+  }
+
+  Expr result() {
+    return mknary<AND>(mk<TRUE>(m_name->efac()), m_clauses);
+  }
+
+  void pairwise(const ExprVector &lits) {
+    for (unsigned i = 0, sz = lits.size(); i < sz; ++i)
+      for (unsigned j = i + 1; j < sz; ++j)
+        exclude(lits[i], lits[j]);
+  }
+
+  /// s_i is true if one of lits[0..i] is true
+  void seqCounter(const ExprVector &lits) {
+    unsigned n = lits.size();
+    if (n < 2)
+      return;
+    Expr s = fresh();
+    imply(lits[0], s);
+    for (unsigned i = 1; i + 1 < n; ++i) {
+      Expr next = fresh();
+      imply(lits[i], next);
+      imply(s, next);
+      exclude(lits[i], s);
+      s = next;
+    }
+    exclude(lits[n - 1], s);
+  }
+
+  /// s[i][j] is true if more than j of lits[0..i] are true
+  void seqCounter(const ExprVector &lits, unsigned k) {
+    unsigned n = lits.size();
+    if (k >= n)
+      return;
+    if (k == 0) {
+      for (Expr l : lits)
+        m_clauses.push_back(mk<NEG>(l));
+      return;
+    }
+
+    ExprVector s(k);
+    for (unsigned j = 0; j < k; ++j)
+      s[j] = fresh();
+    imply(lits[0], s[0]);
+    for (unsigned j = 1; j < k; ++j)
+      m_clauses.push_back(mk<NEG>(s[j]));
+
+    for (unsigned i = 1; i + 1 < n; ++i) {
+      ExprVector next(k);
+      for (unsigned j = 0; j < k; ++j)
+        next[j] = fresh();
+      imply(lits[i], next[0]);
+      imply(s[0], next[0]);
+      for (unsigned j = 1; j < k; ++j) {
+        imply(mk<AND>(lits[i], s[j - 1]), next[j]);
+        imply(s[j], next[j]);
+      }
+      exclude(lits[i], s[k - 1]);
+      s.swap(next);
+    }
+    exclude(lits[n - 1], s[k - 1]);
+  }
+
+  /// Splits the literals into groups of three, each with a commander that
+  /// is implied by the literals of its group, and constrains the
+  /// commanders recursively
+  void commander(const ExprVector &lits) {
+    const unsigned groupSz = 3;
+    if (lits.size() <= 2 * groupSz) {
+      pairwise(lits);
+      return;
+    }
+
+    ExprVector commanders;
+    for (unsigned i = 0, sz = lits.size(); i < sz; i += groupSz) {
+      ExprVector group(lits.begin() + i,
+                       lits.begin() + std::min(i + groupSz, sz));
+      pairwise(group);
+      Expr c = fresh();
+      for (Expr l : group)
+        imply(l, c);
+      commanders.push_back(c);
+    }
+    commander(commanders);
+  }
+};
+
+Expr mkPopCount(const ExprVector &lits, unsigned k, ExprFactory &efac) {
+  unsigned n = lits.size();
+  if (k >= n)
+    return mk<TRUE>(efac);
+  // -- wide enough for the sum of all literals
+  unsigned width = 1;
+  while ((1ul << width) <= n)
+    ++width;
+
+  Expr one = bv::bvnum(1, width, efac);
+  Expr zero = bv::bvnum(0, width, efac);
+  ExprVector bits;
+  for (Expr l : lits)
+    bits.push_back(mk<ITE>(l, one, zero));
+  Expr sum = bits.size() == 1 ? bits[0] : mknary<BADD>(bits);
+  return mk<BULE>(sum, bv::bvnum(k, width, efac));
+}
+} // namespace
+
+Expr mkAtMostOne(const ExprVector &lits, Expr name, Encoding enc) {
+  return mkAtMostK(lits, 1, name, enc);
+}
+
+Expr mkAtMostK(const ExprVector &vec, unsigned k, Expr name, Encoding enc) {
+  // -- a literal that occurs several times counts once
+  ExprVector lits;
+  ExprSet seen;
+  for (Expr l : vec)
+    if (seen.insert(l).second)
+      lits.push_back(l);
+
+  if (enc == Encoding::POPCOUNT)
+    return mkPopCount(lits, k, name->efac());
+
+  Encoder e(name);
+  if (k != 1 || lits.size() < 2)
+    e.seqCounter(lits, k);
+  else if (enc == Encoding::NAIVE)
+    e.pairwise(lits);
+  else if (enc == Encoding::COMMANDER)
+    e.commander(lits);
+  else
+    e.seqCounter(lits);
+  return e.result();
+}
+} // namespace card
+} // namespace seahorn
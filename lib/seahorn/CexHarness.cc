@@ -5,7 +5,9 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/ValueMap.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
 #include "llvm/Support/ToolOutputFile.h"
 
 #include "seahorn/Transforms/Instrumentation/ShadowMemDsa.hh"
@@ -16,6 +18,13 @@
 #include "seahorn/Expr/ExprLlvm.hh"
 #include "seahorn/Expr/ExprOpBinder.hh"
 
+static llvm::cl::opt<std::string> CexValuesFile(
+    "horn-cex-values",
+    llvm::cl::desc("Store values of the harness in a binary side file "
+                   "read by sea-rt, keeping the harness independent of the "
+                   "length of the counterexample"),
+    llvm::cl::init(""), llvm::cl::value_desc("filename"));
+
 using namespace llvm;
 namespace seahorn {
 
@@ -84,6 +93,32 @@ Constant *exprToLlvm(Type *ty, Expr e, LLVMContext &ctx, const DataLayout &dl) {
   llvm_unreachable("Unhandled expression");
 }
 
+bool isCexHarnessFunction(const Function &CF, const TargetLibraryInfo &tli) {
+  if (!CF.hasName())
+    return false;
+  if (CF.isIntrinsic())
+    return false;
+  // We want to ignore seahorn functions, but not nondet
+  // functions created by strip-extern or dummyMainFunction
+  if (CF.getName().find_first_of('.') != StringRef::npos &&
+      !CF.getName().startswith("verifier.nondet"))
+    return false;
+  if (!CF.isExternalLinkage(CF.getLinkage()))
+    return false;
+  if (!CF.getReturnType()->isIntegerTy() && !CF.getReturnType()->isPointerTy())
+    return false;
+
+  // KleeInternalize
+  if (CF.getName().equals("calloc"))
+    return false;
+
+  // -- known library function
+  LibFunc libfn;
+  if (tli.getLibFunc(CF.getName(), libfn))
+    return false;
+  return true;
+}
+
 // return true if success
 template <typename IndexToValueMap>
 bool extractArrayContents(Expr e, IndexToValueMap &out, Expr &default_value) {
@@ -123,6 +158,8 @@ void dumpLLVMCex(BmcTraceWrapper &trace, StringRef CexFile,
                         const DataLayout &dl, const TargetLibraryInfo &tli,
                         LLVMContext &context) {
   std::unique_ptr<Module> Harness = createCexHarness(trace, dl, tli, context);
+  if (!Harness)
+    return;
   std::error_code error_code;
   llvm::tool_output_file out(CexFile, error_code, sys::fs::F_None);
   assert(!error_code);
@@ -135,6 +172,86 @@ void dumpLLVMCex(BmcTraceWrapper &trace, StringRef CexFile,
   out.keep();
 }
 
+namespace {
+/// Tables of values stored in the side file of a harness. The layout
+/// matches the reader in sea-rt/seahorn_values.h.
+class CexValueTables {
+  struct Table {
+    unsigned ElemBytes;
+    std::vector<char> Data;
+  };
+  std::vector<Table> m_tables;
+
+public:
+  /// Starts a new table and returns its id
+  unsigned addTable(unsigned ElemBytes) {
+    m_tables.push_back({ElemBytes, {}});
+    return m_tables.size() - 1;
+  }
+
+  /// Appends the low \p Bytes bytes of \p V to table \p Id in host order
+  void push(unsigned Id, const APInt &V, unsigned Bytes) {
+    uint64_t Raw = V.zextOrTrunc(64).getZExtValue();
+    std::vector<char> &Data = m_tables[Id].Data;
+    for (unsigned i = 0; i < Bytes; ++i) {
+      unsigned Shift = sys::IsLittleEndianHost ? i : Bytes - 1 - i;
+      Data.push_back(char(Shift < 8 ? Raw >> (8 * Shift) : 0));
+    }
+  }
+
+  bool write(StringRef File) const {
+    std::error_code EC;
+    raw_fd_ostream Out(File, EC, sys::fs::F_None);
+    if (EC) {
+      errs() << "ERROR: cannot open " << File << ": " << EC.message() << "\n";
+      return false;
+    }
+
+    auto Write = [&Out](uint64_t V, unsigned Bytes) {
+      uint32_t V32 = V;
+      Out.write(Bytes == 4 ? reinterpret_cast<const char *>(&V32)
+                           : reinterpret_cast<const char *>(&V),
+                Bytes);
+    };
+    auto Align = [](uint64_t Off) { return (Off + 7) & ~uint64_t(7); };
+
+    Out << "SEACEXV1";
+    Write(m_tables.size(), 4);
+    Write(0, 4);
+    uint64_t Off = 16 + 24 * m_tables.size();
+    for (const Table &T : m_tables) {
+      Off = Align(Off);
+      Write(Off, 8);
+      Write(T.Data.size() / T.ElemBytes, 8);
+      Write(T.ElemBytes, 4);
+      Write(0, 4);
+      Off += T.Data.size();
+    }
+    Off = 16 + 24 * m_tables.size();
+    for (const Table &T : m_tables) {
+      for (uint64_t Next = Align(Off); Off < Next; ++Off)
+        Out << '\0';
+      Out.write(T.Data.data(), T.Data.size());
+      Off += T.Data.size();
+    }
+    Out.close();
+    if (Out.has_error()) {
+      errs() << "ERROR: cannot write " << File << "\n";
+      Out.clear_error();
+      return false;
+    }
+    return true;
+  }
+};
+
+APInt exprToAPInt(unsigned Bits, Expr e, LLVMContext &ctx,
+                  const DataLayout &dl) {
+  auto *C = cast<ConstantInt>(
+      exprToLlvm(IntegerType::get(ctx, Bits), e, ctx, dl));
+  return C->getValue().zextOrTrunc(Bits);
+}
+} // namespace
+
 std::unique_ptr<Module> createCexHarness(BmcTraceWrapper &trace,
                                          const DataLayout &dl,
                                          const TargetLibraryInfo &tli,
@@ -191,33 +308,7 @@ std::unique_ptr<Module> createCexHarness(BmcTraceWrapper &trace,
           continue;
         }
 
-        if (!CF->hasName())
-          continue;
-        if (CF->isIntrinsic())
-          continue;
-        // We want to ignore seahorn functions, but not nondet
-        // functions created by strip-extern or dummyMainFunction
-        if (CF->getName().find_first_of('.') != StringRef::npos &&
-            !CF->getName().startswith("verifier.nondet"))
-          continue;
-        if (!CF->isExternalLinkage(CF->getLinkage()))
-          continue;
-        if (!CF->getReturnType()->isIntegerTy() &&
-            !CF->getReturnType()->isPointerTy()) {
-          // LOG("cex",
-          //     errs () << "Skipping harness for " << CF->getName ()
-          //             << " because it returns type: " << *CF->getReturnType()
-          //             << "\n";);
-          continue;
-        }
-
-        // KleeInternalize
-        if (CF->getName().equals("calloc"))
-          continue;
-
-        // -- known library function
-        LibFunc libfn;
-        if (tli.getLibFunc(CF->getName(), libfn))
+        if (!isCexHarnessFunction(*CF, tli))
           continue;
 
         Expr V = trace.eval(loc, I, true);
@@ -230,6 +321,26 @@ std::unique_ptr<Module> createCexHarness(BmcTraceWrapper &trace,
     }
   }
 
+  // -- with a side file, tables of values are read by the run-time
+  std::unique_ptr<CexValueTables> Tables;
+  Constant *ValuesPath = nullptr;
+  Constant *GetTable = nullptr;
+  Constant *GetTableSize = nullptr;
+  if (!CexValuesFile.empty()) {
+    Tables = llvm::make_unique<CexValueTables>();
+    Type *i8PtrTy = Type::getInt8PtrTy(TheContext);
+    Type *i32Ty = Type::getInt32Ty(TheContext);
+    Constant *PathC = ConstantDataArray::getString(TheContext, CexValuesFile);
+    auto *PathGV =
+        new GlobalVariable(*Harness, PathC->getType(), true,
+                           GlobalValue::PrivateLinkage, PathC, "cex.values");
+    ValuesPath = ConstantExpr::getBitCast(PathGV, i8PtrTy);
+    GetTable = Harness->getOrInsertFunction("__seahorn_get_value_table",
+                                            i8PtrTy, i8PtrTy, i32Ty);
+    GetTableSize = Harness->getOrInsertFunction(
+        "__seahorn_get_value_table_size", i32Ty, i8PtrTy, i32Ty);
+  }
+
   // Build harness functions
   for (auto CFV : FuncValueMap) {
 
@@ -247,25 +358,45 @@ std::unique_ptr<Module> createCexHarness(BmcTraceWrapper &trace,
     else
       pRT = Type::getInt8PtrTy(TheContext);
 
-    ArrayType *AT = ArrayType::get(RT, values.size());
-
-    // Convert Expr to LLVM constants
-    SmallVector<Constant *, 20> LLVMarray;
-    std::transform(values.begin(), values.end(), std::back_inserter(LLVMarray),
-                   [&RT, &dl, &TheContext](Expr e) {
-                     return exprToLlvm(RT, e, TheContext, dl);
-                   });
-
-    // This is an array containing the values to be returned
-    GlobalVariable *CA =
-        new GlobalVariable(*Harness, AT, true, GlobalValue::PrivateLinkage,
-                           ConstantArray::get(AT, LLVMarray));
-
     // Build the body of the harness function
     BasicBlock *BB = BasicBlock::Create(TheContext, "entry", HF);
     IRBuilder<> Builder(BB);
 
     Type *CountType = Type::getInt32Ty(TheContext);
+
+    // The values to be returned and their number
+    Value *Table;
+    Value *TableSize;
+    if (Tables) {
+      unsigned ElemBytes = dl.getTypeStoreSize(RT);
+      unsigned Id = Tables->addTable(ElemBytes);
+      for (Expr e : values)
+        Tables->push(Id, exprToAPInt(ElemBytes * 8, e, TheContext, dl),
+                     ElemBytes);
+
+      Value *TableArgs[] = {ValuesPath, ConstantInt::get(CountType, Id)};
+      Table = Builder.CreateBitCast(Builder.CreateCall(GetTable, TableArgs),
+                                    pRT);
+      TableSize = Builder.CreateCall(GetTableSize, TableArgs);
+    } else {
+      ArrayType *AT = ArrayType::get(RT, values.size());
+
+      // Convert Expr to LLVM constants
+      SmallVector<Constant *, 20> LLVMarray;
+      std::transform(values.begin(), values.end(),
+                     std::back_inserter(LLVMarray),
+                     [&RT, &dl, &TheContext](Expr e) {
+                       return exprToLlvm(RT, e, TheContext, dl);
+                     });
+
+      // This is an array containing the values to be returned
+      GlobalVariable *CA =
+          new GlobalVariable(*Harness, AT, true, GlobalValue::PrivateLinkage,
+                             ConstantArray::get(AT, LLVMarray));
+      Table = Builder.CreateBitCast(CA, pRT);
+      TableSize = ConstantInt::get(CountType, values.size());
+    }
+
     GlobalVariable *Counter = new GlobalVariable(
         *Harness, CountType, false, GlobalValue::PrivateLinkage,
         ConstantInt::get(CountType, 0));
@@ -278,8 +409,7 @@ std::unique_ptr<Module> createCexHarness(BmcTraceWrapper &trace,
 
     std::string name;
     std::vector<Type *> ArgTypes = {CountType, pRT, CountType};
-    std::vector<Value *> Args = {LoadCounter, Builder.CreateBitCast(CA, pRT),
-                                 ConstantInt::get(CountType, values.size())};
+    std::vector<Value *> Args = {LoadCounter, Table, TableSize};
 
     if (RT->isIntegerTy()) {
       std::string RS;
@@ -382,6 +512,23 @@ std::unique_ptr<Module> createCexHarness(BmcTraceWrapper &trace,
                        Builder.CreateBitCast(endC, i8PtrTy), valC,
                        ConstantInt::get(intTy, dl.getTypeStoreSize(intPtrTy))});
 
+      if (Tables) {
+        // __seahorn_mem_init_table(path, id, sz)
+        unsigned Id = Tables->addTable(16);
+        for (auto &kv : contentVals) {
+          Tables->push(Id, exprToAPInt(64, kv.first, TheContext, dl), 8);
+          Tables->push(Id, exprToAPInt(64, kv.second, TheContext, dl), 8);
+        }
+        Function *MemInitTable = cast<Function>(Harness->getOrInsertFunction(
+            "__seahorn_mem_init_table", Type::getVoidTy(TheContext), i8PtrTy,
+            Type::getInt32Ty(TheContext), intTy));
+        Builder.CreateCall(
+            MemInitTable,
+            {ValuesPath, ConstantInt::get(Type::getInt32Ty(TheContext), Id),
+             ConstantInt::get(intTy, dl.getTypeStoreSize(intPtrTy))});
+        continue;
+      }
+
       // __seahorn_mem_init(index, val, sz)
       for (auto &kv : contentVals) {
         Value *indexC = exprToLlvm(i8PtrTy, kv.first, TheContext, dl);
@@ -395,6 +542,10 @@ std::unique_ptr<Module> createCexHarness(BmcTraceWrapper &trace,
     Builder.CreateRetVoid();
   } // end AllocateMem
 
+  // -- the harness cannot run without its values
+  if (Tables && !Tables->write(CexValuesFile))
+    return nullptr;
+
   return (Harness);
 }
 } // namespace seahorn
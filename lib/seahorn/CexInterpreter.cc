@@ -0,0 +1,943 @@
+#include "seahorn/CexInterpreter.hh"
+#include "seahorn/CexHarness.hh"
+
+#include "BvOpSem2Context.hh"
+#include "BvOpSem2MemLayout.hh"
+
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/GetElementPtrTypeIterator.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MathExtras.h"
+
+#include "seahorn/Support/SeaDebug.h"
+
+#include <map>
+#include <memory>
+
+using namespace llvm;
+namespace seahorn {
+
+namespace {
+using Status = CexInterpreter::Status;
+using Result = CexInterpreter::Result;
+
+// -- memory layout of OpSemAllocator
+using details::DYN_ALLOC_SIZE;
+using details::functionInterval;
+using details::globalInterval;
+using details::isShadowMemName;
+using details::isStaticallyAllocated;
+using details::MAX_STACK_ADDR;
+using details::MIN_STACK_ADDR;
+using details::TEXT_SEGMENT_START;
+
+std::string toString(const Value &v) {
+  std::string s;
+  raw_string_ostream o(s);
+  if (v.hasName())
+    o << v.getName();
+  else
+    v.printAsOperand(o, false);
+  return o.str();
+}
+
+/// Sparse, zero-initialized, byte addressable memory. Only accesses to
+/// allocated regions are legal.
+class FlatMemory {
+  static const unsigned PAGE_BITS = 12;
+  static const uint64_t PAGE_SIZE = uint64_t(1) << PAGE_BITS;
+
+  DenseMap<uint64_t, std::unique_ptr<uint8_t[]>> m_pages;
+  /// allocated regions, start to end
+  std::map<uint64_t, uint64_t> m_regions;
+
+  uint8_t *page(uint64_t addr) {
+    std::unique_ptr<uint8_t[]> &p = m_pages[addr >> PAGE_BITS];
+    if (!p)
+      p.reset(new uint8_t[PAGE_SIZE]());
+    return p.get();
+  }
+
+  /// Calls \p fn(host ptr, offset, size) for every page-sized chunk of
+  /// [addr, addr + sz)
+  template <typename Fn> void forChunks(uint64_t addr, uint64_t sz, Fn fn) {
+    uint64_t done = 0;
+    while (done < sz) {
+      uint64_t a = addr + done;
+      uint64_t off = a & (PAGE_SIZE - 1);
+      uint64_t n = std::min(sz - done, PAGE_SIZE - off);
+      fn(page(a) + off, done, n);
+      done += n;
+    }
+  }
+
+public:
+  void allocate(uint64_t start, uint64_t end) { m_regions[start] = end; }
+  void release(uint64_t start) { m_regions.erase(start); }
+
+  bool isAllocated(uint64_t addr, uint64_t sz) const {
+    auto it = m_regions.upper_bound(addr);
+    if (it == m_regions.begin())
+      return false;
+    --it;
+    return addr + sz <= it->second;
+  }
+
+  void read(uint64_t addr, uint8_t *dst, uint64_t sz) {
+    forChunks(addr, sz, [dst](uint8_t *p, uint64_t done, uint64_t n) {
+      memcpy(dst + done, p, n);
+    });
+  }
+  void write(uint64_t addr, const uint8_t *src, uint64_t sz) {
+    forChunks(addr, sz, [src](uint8_t *p, uint64_t done, uint64_t n) {
+      memcpy(p, src + done, n);
+    });
+  }
+  void fill(uint64_t addr, uint8_t val, uint64_t sz) {
+    forChunks(addr, sz, [val](uint8_t *p, uint64_t, uint64_t n) {
+      memset(p, val, n);
+    });
+  }
+};
+
+/// Activation record of a function
+struct Frame {
+  const Function *m_fn;
+  /// current and previous basic block
+  const BasicBlock *m_bb;
+  const BasicBlock *m_prev;
+  /// next instruction to execute
+  BasicBlock::const_iterator m_ip;
+  /// values of registers
+  DenseMap<const Value *, APInt> m_regs;
+  /// address and size of every alloca of the function
+  DenseMap<const AllocaInst *, std::pair<uint64_t, uint64_t>> m_allocas;
+  /// stack pointer at entry and lowest address of the frame
+  uint64_t m_sp;
+  uint64_t m_bottom;
+  /// call instruction in the caller
+  const Instruction *m_call;
+};
+
+/// State of a single run of CexInterpreter
+class Machine {
+  const DataLayout &m_dl;
+  const TargetLibraryInfo &m_tli;
+  const DenseMap<const Function *, std::vector<APInt>> &m_values;
+  ArrayRef<const BasicBlock *> m_path;
+  uint64_t m_maxSteps;
+
+  details::ConstantExprEvaluator m_ce;
+  /// address of globals and address-taken functions
+  DenseMap<const GlobalValue *, uint64_t> m_addrs;
+  DenseMap<uint64_t, const Function *> m_fnAt;
+  DenseMap<const Constant *, APInt> m_consts;
+  /// number of values consumed per external function
+  DenseMap<const Function *, unsigned> m_nextValue;
+
+  FlatMemory m_mem;
+  uint64_t m_brk;
+  unsigned m_ptrBits;
+  unsigned m_align;
+  /// alignment of functions and globals, the word size of the memory
+  unsigned m_wordSz;
+
+  std::vector<Frame> m_stack;
+  unsigned m_pathPos;
+  uint64_t m_steps;
+  Result m_res;
+
+  /// Records the result. Always returns false to stop execution.
+  bool stop(Status s, const Instruction *I, const Twine &msg) {
+    m_res = {s, m_steps, I, msg.str()};
+    return false;
+  }
+
+  unsigned bits(Type *ty) const {
+    return ty->isPointerTy() ? m_ptrBits : ty->getIntegerBitWidth();
+  }
+
+  static bool isEvaluable(const Constant &C);
+  bool getConstant(const Constant &C, APInt &out, const Instruction &I);
+  bool get(const Value &v, APInt &out, const Instruction &I);
+  void set(const Value &v, const APInt &val) {
+    m_stack.back().m_regs[&v] = val;
+  }
+
+  void layout(const Module &M);
+  bool enter(const Function &fn, ArrayRef<APInt> args, const Instruction *call);
+  bool visit(const BasicBlock &bb, const Instruction *from);
+  bool jump(const BasicBlock &dst, const Instruction &I);
+  bool ret(const ReturnInst &I);
+  bool halloc(uint64_t bytes, uint64_t &addr, const Instruction &I);
+
+  bool load(uint64_t addr, Type *ty, APInt &out, const Instruction &I);
+  bool store(uint64_t addr, const APInt &v, Type *ty, const Instruction &I);
+  bool checkAccess(uint64_t addr, uint64_t sz, const Instruction &I);
+
+  bool binOp(const BinaryOperator &I);
+  bool icmp(const ICmpInst &I);
+  bool castOp(const CastInst &I);
+  bool gep(const GetElementPtrInst &I);
+  bool call(const Instruction &I);
+  bool intrinsic(const IntrinsicInst &I);
+  bool external(const Function &fn, const Instruction &I);
+  bool step();
+
+public:
+  Machine(const DataLayout &dl, const TargetLibraryInfo &tli,
+          const DenseMap<const Function *, std::vector<APInt>> &values,
+          ArrayRef<const BasicBlock *> path, uint64_t maxSteps,
+          unsigned wordSz)
+      : m_dl(dl), m_tli(tli), m_values(values), m_path(path),
+        m_maxSteps(maxSteps), m_ce(dl), m_brk(0),
+        m_ptrBits(dl.getPointerSizeInBits()),
+        m_align(dl.getPointerABIAlignment()), m_wordSz(wordSz), m_pathPos(0),
+        m_steps(0),
+        m_res({Status::Unsupported, 0, nullptr, ""}) {}
+
+  Result run(const Function &fn) {
+    layout(*fn.getParent());
+
+    SmallVector<APInt, 4> args;
+    for (const Argument &arg : fn.args()) {
+      if (!arg.getType()->isIntegerTy() && !arg.getType()->isPointerTy()) {
+        stop(Status::Unsupported, nullptr,
+             "argument " + toString(arg) + " of entry function");
+        return m_res;
+      }
+      args.push_back(APInt(bits(arg.getType()), 0));
+    }
+
+    if (enter(fn, args, nullptr))
+      while (step())
+        ;
+    return m_res;
+  }
+};
+
+/// Places address-taken functions and then globals from the start of
+/// the text segment, as StaticOpSemAllocator::onModuleEntry does. Globals
+/// are skipped as by the semantics when it tracks pointers: only those
+/// that merely name a shadow memory region
+void Machine::layout(const Module &M) {
+  unsigned addr = TEXT_SEGMENT_START;
+  for (const Function &fn : M) {
+    if (!isStaticallyAllocated(fn))
+      continue;
+    auto range = functionInterval(addr, m_wordSz);
+    m_addrs[&fn] = range.first;
+    m_fnAt[range.first] = &fn;
+    addr = range.second;
+  }
+
+  for (const GlobalVariable &gv : M.globals()) {
+    if (!isStaticallyAllocated(gv, isShadowMemName(gv)))
+      continue;
+    uint64_t bytes = m_dl.getTypeAllocSize(gv.getValueType());
+    auto range = globalInterval(addr, bytes, m_wordSz);
+    m_addrs[&gv] = range.first;
+    m_mem.allocate(range.first, range.first + bytes);
+    addr = range.second;
+  }
+  m_brk = addr;
+
+  // -- initializers may refer to the address of any global
+  m_ce.setGlobalAddrs(m_addrs);
+  for (const GlobalVariable &gv : M.globals()) {
+    if (!gv.hasInitializer() || !m_addrs.count(&gv))
+      continue;
+    std::vector<uint8_t> buf(m_dl.getTypeAllocSize(gv.getValueType()), 0);
+    m_ce.initMemory(gv.getInitializer(), buf.data());
+    m_mem.write(m_addrs[&gv], buf.data(), buf.size());
+  }
+}
+
+bool Machine::isEvaluable(const Constant &C) {
+  const ConstantExpr *CE = dyn_cast<ConstantExpr>(&C);
+  if (!CE)
+    return true;
+  switch (CE->getOpcode()) {
+  case Instruction::GetElementPtr:
+  case Instruction::Trunc:
+  case Instruction::ZExt:
+  case Instruction::SExt:
+  case Instruction::PtrToInt:
+  case Instruction::IntToPtr:
+  case Instruction::BitCast:
+  case Instruction::Add:
+  case Instruction::Sub:
+  case Instruction::Mul:
+  case Instruction::And:
+  case Instruction::Or:
+  case Instruction::Xor:
+    break;
+  default:
+    return false;
+  }
+  for (const Use &op : CE->operands())
+    if (!isEvaluable(*cast<Constant>(op)))
+      return false;
+  return true;
+}
+
+bool Machine::getConstant(const Constant &C, APInt &out,
+                          const Instruction &I) {
+  auto it = m_consts.find(&C);
+  if (it != m_consts.end()) {
+    out = it->second;
+    return true;
+  }
+
+  Type *ty = C.getType();
+  if ((!ty->isIntegerTy() && !ty->isPointerTy()) || !isEvaluable(C))
+    return stop(Status::Unsupported, &I, "constant " + toString(C));
+
+  Optional<GenericValue> gv = m_ce.evaluate(&C);
+  if (!gv.hasValue())
+    return stop(Status::Unsupported, &I, "constant " + toString(C));
+
+  out = ty->isPointerTy()
+            ? APInt(m_ptrBits, (uint64_t)(uintptr_t)gv.getValue().PointerVal)
+            : gv.getValue().IntVal;
+  m_consts[&C] = out;
+  return true;
+}
+
+bool Machine::get(const Value &v, APInt &out, const Instruction &I) {
+  if (const ConstantInt *ci = dyn_cast<ConstantInt>(&v)) {
+    out = ci->getValue();
+    return true;
+  }
+  if (const Constant *c = dyn_cast<Constant>(&v))
+    return getConstant(*c, out, I);
+
+  const Frame &f = m_stack.back();
+  auto it = f.m_regs.find(&v);
+  if (it == f.m_regs.end())
+    return stop(Status::Unsupported, &I, "no value for " + toString(v));
+  out = it->second;
+  return true;
+}
+
+/// Pushes a frame for \p fn. All allocas of \p fn are pre-allocated
+/// below the stack pointer, as StaticOpSemAllocator::onFunctionEntry
+/// does.
+bool Machine::enter(const Function &fn, ArrayRef<APInt> args,
+                    const Instruction *call) {
+  Frame f;
+  f.m_fn = &fn;
+  f.m_call = call;
+  f.m_sp = m_stack.empty() ? MAX_STACK_ADDR : m_stack.back().m_bottom;
+
+  uint64_t end = 0;
+  for (const Instruction &inst : instructions(fn)) {
+    const AllocaInst *alloca = dyn_cast<AllocaInst>(&inst);
+    if (!alloca)
+      continue;
+    uint64_t bytes = DYN_ALLOC_SIZE;
+    if (const ConstantInt *n = dyn_cast<ConstantInt>(alloca->getArraySize()))
+      bytes = m_dl.getTypeAllocSize(alloca->getAllocatedType()) *
+              n->getZExtValue();
+    uint64_t align = std::max<uint64_t>(alloca->getAlignment(), m_align);
+    uint64_t start = alignTo(end, align);
+    end = alignTo(start + bytes, align);
+    f.m_allocas[alloca] = {f.m_sp - end, bytes};
+  }
+  f.m_bottom = f.m_sp - end;
+  if (end > f.m_sp || f.m_bottom < MIN_STACK_ADDR)
+    return stop(Status::Fault, call, "stack overflow entering " + fn.getName());
+
+  unsigned i = 0;
+  for (const Argument &arg : fn.args())
+    f.m_regs[&arg] = args[i++];
+
+  f.m_bb = &fn.getEntryBlock();
+  f.m_prev = nullptr;
+  f.m_ip = f.m_bb->begin();
+  m_stack.push_back(std::move(f));
+  return visit(fn.getEntryBlock(), call);
+}
+
+/// Checks that \p bb is the next block on the expected path
+bool Machine::visit(const BasicBlock &bb, const Instruction *from) {
+  if (m_stack.size() != 1 || m_path.empty())
+    return true;
+  if (m_pathPos >= m_path.size())
+    return stop(Status::Diverged, from,
+                "entered " + bb.getName() + " past the end of the trace");
+  if (m_path[m_pathPos] != &bb)
+    return stop(Status::Diverged, from,
+                "entered " + bb.getName() + " instead of " +
+                    m_path[m_pathPos]->getName());
+  ++m_pathPos;
+  return true;
+}
+
+bool Machine::jump(const BasicBlock &dst, const Instruction &I) {
+  Frame &f = m_stack.back();
+
+  // -- evaluate all PHI nodes before assigning any of them
+  SmallVector<std::pair<const PHINode *, APInt>, 8> phis;
+  for (const Instruction &inst : dst) {
+    const PHINode *phi = dyn_cast<PHINode>(&inst);
+    if (!phi)
+      break;
+    APInt v;
+    if (!get(*phi->getIncomingValueForBlock(f.m_bb), v, *phi))
+      return false;
+    phis.push_back({phi, v});
+  }
+  for (auto &kv : phis)
+    f.m_regs[kv.first] = kv.second;
+
+  f.m_prev = f.m_bb;
+  f.m_bb = &dst;
+  f.m_ip = dst.getFirstNonPHI()->getIterator();
+  return visit(dst, &I);
+}
+
+bool Machine::ret(const ReturnInst &I) {
+  APInt rv;
+  const Value *v = I.getReturnValue();
+  if (v && !get(*v, rv, I))
+    return false;
+
+  Frame &f = m_stack.back();
+  for (auto &kv : f.m_allocas)
+    m_mem.release(kv.second.first);
+  const Function *fn = f.m_fn;
+  const Instruction *call = f.m_call;
+  m_stack.pop_back();
+
+  if (m_stack.empty())
+    return stop(Status::Exit, &I, "returned from " + fn->getName());
+  if (v)
+    set(*call, rv);
+  return true;
+}
+
+/// Allocates memory on the heap, which grows from the end of the data
+/// segment towards the stack
+bool Machine::halloc(uint64_t bytes, uint64_t &addr, const Instruction &I) {
+  addr = alignTo(m_brk, m_align);
+  uint64_t end = addr + alignTo(std::max<uint64_t>(bytes, 1), m_align);
+  if (end > MIN_STACK_ADDR)
+    return stop(Status::Fault, &I, "out of heap memory");
+  m_brk = end;
+  m_mem.allocate(addr, addr + bytes);
+  return true;
+}
+
+bool Machine::checkAccess(uint64_t addr, uint64_t sz, const Instruction &I) {
+  if (m_mem.isAllocated(addr, sz))
+    return true;
+  std::string msg;
+  raw_string_ostream o(msg);
+  o << "invalid access of " << sz << " bytes at "
+    << format_hex(addr, 2 + m_ptrBits / 4);
+  return stop(Status::Fault, &I, o.str());
+}
+
+bool Machine::load(uint64_t addr, Type *ty, APInt &out, const Instruction &I) {
+  if (!ty->isIntegerTy() && !ty->isPointerTy())
+    return stop(Status::Unsupported, &I, "load of non-integer type");
+  unsigned sz = m_dl.getTypeStoreSize(ty);
+  if (!checkAccess(addr, sz, I))
+    return false;
+
+  SmallVector<uint8_t, 16> buf(sz);
+  m_mem.read(addr, buf.data(), sz);
+  APInt v(sz * 8, 0);
+  for (unsigned i = 0; i < sz; ++i) {
+    uint8_t b = m_dl.isLittleEndian() ? buf[i] : buf[sz - 1 - i];
+    v |= APInt(sz * 8, b).shl(8 * i);
+  }
+  out = v.zextOrTrunc(bits(ty));
+  return true;
+}
+
+bool Machine::store(uint64_t addr, const APInt &val, Type *ty,
+                    const Instruction &I) {
+  if (!ty->isIntegerTy() && !ty->isPointerTy())
+    return stop(Status::Unsupported, &I, "store of non-integer type");
+  unsigned sz = m_dl.getTypeStoreSize(ty);
+  if (!checkAccess(addr, sz, I))
+    return false;
+
+  APInt v = val.zextOrTrunc(sz * 8);
+  SmallVector<uint8_t, 16> buf(sz);
+  for (unsigned i = 0; i < sz; ++i) {
+    uint8_t b = v.extractBits(8, 8 * i).getZExtValue();
+    buf[m_dl.isLittleEndian() ? i : sz - 1 - i] = b;
+  }
+  m_mem.write(addr, buf.data(), sz);
+  return true;
+}
+
+bool Machine::binOp(const BinaryOperator &I) {
+  APInt a, b;
+  if (!get(*I.getOperand(0), a, I) || !get(*I.getOperand(1), b, I))
+    return false;
+  unsigned w = a.getBitWidth();
+
+  APInt r;
+  switch (I.getOpcode()) {
+  case Instruction::Add:
+    r = a + b;
+    break;
+  case Instruction::Sub:
+    r = a - b;
+    break;
+  case Instruction::Mul:
+    r = a * b;
+    break;
+  case Instruction::UDiv:
+  case Instruction::SDiv:
+  case Instruction::URem:
+  case Instruction::SRem:
+    if (!b)
+      return stop(Status::Fault, &I, "division by zero");
+    r = I.getOpcode() == Instruction::UDiv
+            ? a.udiv(b)
+            : I.getOpcode() == Instruction::SDiv
+                  ? a.sdiv(b)
+                  : I.getOpcode() == Instruction::URem ? a.urem(b) : a.srem(b);
+    break;
+  // -- shifting by the bit-width or more is poison, saturate instead
+  case Instruction::Shl:
+    r = a.shl(b.getLimitedValue(w));
+    break;
+  case Instruction::LShr:
+    r = a.lshr(b.getLimitedValue(w));
+    break;
+  case Instruction::AShr:
+    r = a.ashr(b.getLimitedValue(w));
+    break;
+  case Instruction::And:
+    r = a & b;
+    break;
+  case Instruction::Or:
+    r = a | b;
+    break;
+  case Instruction::Xor:
+    r = a ^ b;
+    break;
+  default:
+    return stop(Status::Unsupported, &I, "binary operator");
+  }
+  set(I, r);
+  return true;
+}
+
+bool Machine::icmp(const ICmpInst &I) {
+  APInt a, b;
+  if (!get(*I.getOperand(0), a, I) || !get(*I.getOperand(1), b, I))
+    return false;
+
+  bool r;
+  switch (I.getPredicate()) {
+  case CmpInst::ICMP_EQ:
+    r = a == b;
+    break;
+  case CmpInst::ICMP_NE:
+    r = a != b;
+    break;
+  case CmpInst::ICMP_UGT:
+    r = a.ugt(b);
+    break;
+  case CmpInst::ICMP_UGE:
+    r = a.uge(b);
+    break;
+  case CmpInst::ICMP_ULT:
+    r = a.ult(b);
+    break;
+  case CmpInst::ICMP_ULE:
+    r = a.ule(b);
+    break;
+  case CmpInst::ICMP_SGT:
+    r = a.sgt(b);
+    break;
+  case CmpInst::ICMP_SGE:
+    r = a.sge(b);
+    break;
+  case CmpInst::ICMP_SLT:
+    r = a.slt(b);
+    break;
+  case CmpInst::ICMP_SLE:
+    r = a.sle(b);
+    break;
+  default:
+    return stop(Status::Unsupported, &I, "comparison predicate");
+  }
+  set(I, APInt(1, r));
+  return true;
+}
+
+bool Machine::castOp(const CastInst &I) {
+  Type *dstTy = I.getType();
+  Type *srcTy = I.getSrcTy();
+  if ((!dstTy->isIntegerTy() && !dstTy->isPointerTy()) ||
+      (!srcTy->isIntegerTy() && !srcTy->isPointerTy()))
+    return stop(Status::Unsupported, &I, "cast of non-integer type");
+
+  APInt a;
+  if (!get(*I.getOperand(0), a, I))
+    return false;
+  unsigned w = bits(dstTy);
+
+  switch (I.getOpcode()) {
+  case Instruction::SExt:
+    set(I, a.sextOrTrunc(w));
+    return true;
+  case Instruction::Trunc:
+  case Instruction::ZExt:
+  case Instruction::PtrToInt:
+  case Instruction::IntToPtr:
+  case Instruction::BitCast:
+    set(I, a.zextOrTrunc(w));
+    return true;
+  default:
+    return stop(Status::Unsupported, &I, "cast");
+  }
+}
+
+bool Machine::gep(const GetElementPtrInst &I) {
+  if (I.getType()->isVectorTy())
+    return stop(Status::Unsupported, &I, "vector of pointers");
+
+  APInt base;
+  if (!get(*I.getPointerOperand(), base, I))
+    return false;
+
+  uint64_t addr = base.getZExtValue();
+  for (auto GTI = gep_type_begin(I), E = gep_type_end(I); GTI != E; ++GTI) {
+    APInt idx;
+    if (!get(*GTI.getOperand(), idx, I))
+      return false;
+    if (StructType *sty = GTI.getStructTypeOrNull())
+      addr += m_dl.getStructLayout(sty)->getElementOffset(idx.getZExtValue());
+    else
+      addr += idx.sextOrTrunc(64).getSExtValue() *
+              m_dl.getTypeAllocSize(GTI.getIndexedType());
+  }
+  set(I, APInt(m_ptrBits, addr));
+  return true;
+}
+
+bool Machine::intrinsic(const IntrinsicInst &I) {
+  switch (I.getIntrinsicID()) {
+  case Intrinsic::memset: {
+    APInt dst, val, len;
+    if (!get(*I.getArgOperand(0), dst, I) ||
+        !get(*I.getArgOperand(1), val, I) || !get(*I.getArgOperand(2), len, I))
+      return false;
+    uint64_t n = len.getZExtValue();
+    if (!checkAccess(dst.getZExtValue(), n, I))
+      return false;
+    m_mem.fill(dst.getZExtValue(), val.getZExtValue(), n);
+    return true;
+  }
+  case Intrinsic::memcpy:
+  case Intrinsic::memmove: {
+    APInt dst, src, len;
+    if (!get(*I.getArgOperand(0), dst, I) ||
+        !get(*I.getArgOperand(1), src, I) || !get(*I.getArgOperand(2), len, I))
+      return false;
+    uint64_t n = len.getZExtValue();
+    if (!checkAccess(dst.getZExtValue(), n, I) ||
+        !checkAccess(src.getZExtValue(), n, I))
+      return false;
+    std::vector<uint8_t> buf(n);
+    m_mem.read(src.getZExtValue(), buf.data(), n);
+    m_mem.write(dst.getZExtValue(), buf.data(), n);
+    return true;
+  }
+  default:
+    // -- debug info, lifetime markers, etc. have no effect
+    if (I.getType()->isVoidTy())
+      return true;
+    return stop(Status::Unsupported, &I,
+                "intrinsic " + I.getCalledFunction()->getName());
+  }
+}
+
+/// Calls to functions without a body
+bool Machine::external(const Function &fn, const Instruction &I) {
+  ImmutableCallSite CS(&I);
+  StringRef name = fn.getName();
+
+  if (name.equals("verifier.error") || name.equals("seahorn.fail") ||
+      name.equals("seahorn.error"))
+    return stop(Status::Error, &I, "reached " + name);
+
+  if (name.equals("verifier.assume") || name.equals("verifier.assume.not") ||
+      name.equals("verifier.assert")) {
+    APInt c;
+    if (!get(*CS.getArgument(0), c, I))
+      return false;
+    bool holds = c.getBoolValue() != name.endswith(".not");
+    if (holds)
+      return true;
+    if (name.equals("verifier.assert"))
+      return stop(Status::Error, &I, "assertion failed");
+    return stop(Status::AssumeViolated, &I, "assumption does not hold");
+  }
+
+  // -- markers and shadow memory of seahorn do not affect execution
+  if (name.startswith("shadow.mem") || name.startswith("seahorn.")) {
+    if (!fn.getReturnType()->isVoidTy())
+      set(I, APInt(bits(fn.getReturnType()), 0));
+    return true;
+  }
+
+  LibFunc libfn;
+  if (m_tli.getLibFunc(fn, libfn)) {
+    switch (libfn) {
+    case LibFunc_malloc:
+    case LibFunc_calloc: {
+      APInt n, m(m_ptrBits, 1);
+      if (!get(*CS.getArgument(0), n, I) ||
+          (libfn == LibFunc_calloc && !get(*CS.getArgument(1), m, I)))
+        return false;
+      // -- fresh heap memory is zero-initialized
+      uint64_t addr;
+      if (!halloc(n.getZExtValue() * m.getZExtValue(), addr, I))
+        return false;
+      set(I, APInt(m_ptrBits, addr));
+      return true;
+    }
+    case LibFunc_free: {
+      APInt p;
+      if (!get(*CS.getArgument(0), p, I))
+        return false;
+      m_mem.release(p.getZExtValue());
+      return true;
+    }
+    default:
+      break;
+    }
+  }
+
+  if (isCexHarnessFunction(fn, m_tli)) {
+    auto it = m_values.find(&fn);
+    unsigned &next = m_nextValue[&fn];
+    if (it == m_values.end() || next >= it->second.size())
+      return stop(Status::Diverged, &I, "no more values for " + name);
+    APInt v = it->second[next++].zextOrTrunc(bits(fn.getReturnType()));
+    // -- addresses of the model are meaningless here. Non-null pointers
+    // -- get fresh memory, as the harness does for unknown memory.
+    if (fn.getReturnType()->isPointerTy() && !!v) {
+      uint64_t addr;
+      if (!halloc(DYN_ALLOC_SIZE, addr, I))
+        return false;
+      v = APInt(m_ptrBits, addr);
+    }
+    set(I, v);
+    return true;
+  }
+
+  if (fn.getReturnType()->isVoidTy()) {
+    LOG("cex-interp", errs() << "Ignoring call to " << name << "\n";);
+    return true;
+  }
+  return stop(Status::Unsupported, &I, "call to external function " + name);
+}
+
+bool Machine::call(const Instruction &I) {
+  ImmutableCallSite CS(&I);
+  const Function *fn =
+      dyn_cast<Function>(CS.getCalledValue()->stripPointerCasts());
+  if (!fn) {
+    APInt target;
+    if (!get(*CS.getCalledValue(), target, I))
+      return false;
+    auto it = m_fnAt.find(target.getZExtValue());
+    if (it == m_fnAt.end())
+      return stop(Status::Fault, &I, "call through invalid function pointer");
+    fn = it->second;
+  }
+
+  if (fn->isIntrinsic())
+    return intrinsic(cast<IntrinsicInst>(I));
+  if (fn->isDeclaration())
+    return external(*fn, I);
+
+  SmallVector<APInt, 4> args;
+  for (const Use &arg : CS.args()) {
+    APInt v;
+    if (!get(*arg, v, I))
+      return false;
+    args.push_back(v);
+  }
+  if (args.size() != fn->arg_size())
+    return stop(Status::Unsupported, &I, "call with mismatching arguments");
+  return enter(*fn, args, &I);
+}
+
+bool Machine::step() {
+  if (m_steps >= m_maxSteps)
+    return stop(Status::StepLimit, nullptr, "step limit reached");
+  ++m_steps;
+
+  Frame &f = m_stack.back();
+  const Instruction &I = *f.m_ip++;
+
+  switch (I.getOpcode()) {
+  case Instruction::Br: {
+    const BranchInst &br = cast<BranchInst>(I);
+    if (br.isUnconditional())
+      return jump(*br.getSuccessor(0), I);
+    APInt c;
+    if (!get(*br.getCondition(), c, I))
+      return false;
+    return jump(*br.getSuccessor(c.getBoolValue() ? 0 : 1), I);
+  }
+  case Instruction::Switch: {
+    const SwitchInst &sw = cast<SwitchInst>(I);
+    APInt c;
+    if (!get(*sw.getCondition(), c, I))
+      return false;
+    for (auto cs : sw.cases())
+      if (cs.getCaseValue()->getValue() == c)
+        return jump(*cs.getCaseSuccessor(), I);
+    return jump(*sw.getDefaultDest(), I);
+  }
+  case Instruction::Ret:
+    return ret(cast<ReturnInst>(I));
+  case Instruction::Unreachable:
+    return stop(Status::Fault, &I, "reached unreachable");
+  case Instruction::Alloca: {
+    const AllocaInst &alloca = cast<AllocaInst>(I);
+    auto region = f.m_allocas.lookup(&alloca);
+    uint64_t bytes = region.second;
+    if (!isa<ConstantInt>(alloca.getArraySize())) {
+      APInt n;
+      if (!get(*alloca.getArraySize(), n, I))
+        return false;
+      bytes = m_dl.getTypeAllocSize(alloca.getAllocatedType()) *
+              n.getZExtValue();
+      if (bytes > region.second)
+        return stop(Status::Unsupported, &I, "dynamic allocation over 4K");
+    }
+    m_mem.allocate(region.first, region.first + bytes);
+    set(I, APInt(m_ptrBits, region.first));
+    return true;
+  }
+  case Instruction::Load: {
+    APInt p, v;
+    if (!get(*I.getOperand(0), p, I) ||
+        !load(p.getZExtValue(), I.getType(), v, I))
+      return false;
+    set(I, v);
+    return true;
+  }
+  case Instruction::Store: {
+    const StoreInst &st = cast<StoreInst>(I);
+    APInt p, v;
+    if (!get(*st.getValueOperand(), v, I) ||
+        !get(*st.getPointerOperand(), p, I))
+      return false;
+    return store(p.getZExtValue(), v, st.getValueOperand()->getType(), I);
+  }
+  case Instruction::GetElementPtr:
+    return gep(cast<GetElementPtrInst>(I));
+  case Instruction::ICmp:
+    return icmp(cast<ICmpInst>(I));
+  case Instruction::Select: {
+    const SelectInst &sel = cast<SelectInst>(I);
+    APInt c, v;
+    if (!get(*sel.getCondition(), c, I) ||
+        !get(c.getBoolValue() ? *sel.getTrueValue() : *sel.getFalseValue(), v,
+             I))
+      return false;
+    set(I, v);
+    return true;
+  }
+  case Instruction::Call:
+    return call(I);
+  default:
+    if (const BinaryOperator *bo = dyn_cast<BinaryOperator>(&I))
+      return binOp(*bo);
+    if (const CastInst *ci = dyn_cast<CastInst>(&I))
+      return castOp(*ci);
+    return stop(Status::Unsupported, &I, "instruction");
+  }
+}
+} // namespace
+
+void CexInterpreter::loadTrace(BmcTraceWrapper &trace) {
+  LLVMContext &ctx = m_module.getContext();
+  m_values.clear();
+  m_path.clear();
+
+  for (unsigned loc = 0; loc < trace.size(); ++loc) {
+    const BasicBlock &BB = *trace.bb(loc);
+    m_path.push_back(&BB);
+
+    // -- same values, in the same order, as in createCexHarness
+    for (const Instruction &I : BB) {
+      const CallInst *ci = dyn_cast<CallInst>(&I);
+      if (!ci)
+        continue;
+      const Function *CF =
+          dyn_cast<Function>(ci->getCalledValue()->stripPointerCasts());
+      if (!CF || !isCexHarnessFunction(*CF, m_tli))
+        continue;
+      Expr V = trace.eval(loc, I, true);
+      if (!V)
+        continue;
+      Type *RT = CF->getReturnType();
+      unsigned bits = RT->isPointerTy() ? m_dl.getPointerSizeInBits()
+                                        : RT->getIntegerBitWidth();
+      Constant *C = exprToLlvm(IntegerType::get(ctx, bits), V, ctx, m_dl);
+      addValue(*CF, cast<ConstantInt>(C)->getValue().zextOrTrunc(bits));
+    }
+  }
+}
+
+CexInterpreter::Result CexInterpreter::run(const Function &fn) {
+  Machine m(m_dl, m_tli, m_values, m_path, m_maxSteps, m_wordSz);
+  Result res = m.run(fn);
+  LOG("cex-interp", errs() << "Interpreted " << fn.getName() << ": " << res
+                           << "\n";);
+  return res;
+}
+
+const char *CexInterpreter::statusName(Status s) {
+  switch (s) {
+  case Status::Error:
+    return "error";
+  case Status::Exit:
+    return "exit";
+  case Status::AssumeViolated:
+    return "assume-violated";
+  case Status::Diverged:
+    return "diverged";
+  case Status::Fault:
+    return "fault";
+  case Status::Unsupported:
+    return "unsupported";
+  case Status::StepLimit:
+    return "step-limit";
+  }
+  llvm_unreachable("unknown status");
+}
+
+raw_ostream &operator<<(raw_ostream &o, const CexInterpreter::Result &r) {
+  o << CexInterpreter::statusName(r.status) << " after " << r.steps
+    << " steps";
+  if (!r.msg.empty())
+    o << ": " << r.msg;
+  if (r.inst)
+    o << "\n  at " << *r.inst;
+  return o;
+}
+} // namespace seahorn
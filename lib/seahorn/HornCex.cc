@@ -14,6 +14,7 @@
 #include "llvm/Support/ToolOutputFile.h"
 
 #include "seahorn/CexHarness.hh"
+#include "seahorn/CexInterpreter.hh"
 #include "seahorn/HornCex.hh"
 #include "seahorn/MemSimulator.hh"
 
@@ -64,6 +65,11 @@ static llvm::cl::opt<bool>
            llvm::cl::desc("Run memory simulation on the counterexample"),
            llvm::cl::init(false));
 
+static llvm::cl::opt<bool> CexInterp(
+    "horn-cex-interp",
+    llvm::cl::desc("Replay the counterexample with the concrete interpreter"),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<std::string> SvCompCexFileSpec(
     "horn-svcomp-cex-spec",
     llvm::cl::desc("Specification key in SV-COMP XML format"),
@@ -125,9 +131,8 @@ bool HornCex::runOnFunction(Module &M, Function &F) {
 
   Stats::resume("CexValidation");
 
-  auto &fp = hs.getZFixedPoint();
   ExprVector rules;
-  fp.getCexRules(rules);
+  hs.getCexRules(rules);
   boost::reverse(rules);
 
   // extract a trace of basic blocks corresponding to the counterexample
@@ -260,11 +265,10 @@ bool HornCex::runOnFunction(Module &M, Function &F) {
   const TargetLibraryInfo &tli =
       getAnalysis<TargetLibraryInfoWrapperPass>().getTLI();
 
-  BmcEngine bmc(*sem, hm.getZContext());
+  IncBmcEngine bmc(*sem, hm.getZContext());
 
   // -- load the trace into the engine
-  for (const CutPoint *cp : cpTrace)
-    bmc.addCutPoint(*cp);
+  bmc.setTrace(cpTrace);
 
   // -- construct BMC instance
   bmc.encode();
@@ -288,6 +292,26 @@ bool HornCex::runOnFunction(Module &M, Function &F) {
   // -- DUMP unsat core if validation failed
   if (!res) {
     errs() << "Warning: the BMC engine failed to validate cex\n";
+    // -- find the shortest infeasible prefix of the trace. Prefixes share
+    // -- the VCs of their edges with the trace, so every check only adds
+    // -- the glue between the edges
+    unsigned feasible = 1, infeasible = cpTrace.size();
+    while (feasible + 1 < infeasible) {
+      unsigned mid = (feasible + infeasible) / 2;
+      bmc.setTrace(makeArrayRef(cpTrace).slice(0, mid));
+      if (!bmc.solve())
+        infeasible = mid;
+      else
+        feasible = mid;
+    }
+    if (infeasible > 1) {
+      const CutPoint &src = *cpTrace[infeasible - 2];
+      const CutPoint &dst = *cpTrace[infeasible - 1];
+      errs() << "cex becomes infeasible at edge " << infeasible - 2 << " ("
+             << src.bb().getName() << " -> " << dst.bb().getName() << ")\n";
+      bmc.setTrace(cpTrace);
+    }
+
     errs() << "Computing unsat core\n";
     ExprVector core;
     bmc.unsatCore(core);
@@ -306,7 +330,12 @@ bool HornCex::runOnFunction(Module &M, Function &F) {
   LOG("cex", trace.print(errs()));
   std::unique_ptr<MemSimulator> memSim = nullptr;
 
-  if (UseBv) {
+  // -- memory is only simulated to replay the trace or to dump it as a
+  // -- harness
+  StringRef HornCexFileRef(HornCexFile);
+  bool dumpHarness =
+      HornCexFileRef.endswith(".ll") || HornCexFileRef.endswith(".bc");
+  if (UseBv && (CexInterp || dumpHarness)) {
     const DataLayout &dl = M.getDataLayout();
     const TargetLibraryInfo &tli =
         getAnalysis<TargetLibraryInfoWrapperPass>().getTLI();
@@ -324,8 +353,25 @@ bool HornCex::runOnFunction(Module &M, Function &F) {
     }
   }
 
-  StringRef HornCexFileRef(HornCexFile);
-  if (HornCexFileRef.endswith(".ll") || HornCexFileRef.endswith(".bc")) {
+  if (CexInterp) {
+    std::unique_ptr<BmcTraceWrapper> traceW(new BmcTraceWrapper(trace));
+    if (memSim)
+      traceW.reset(new BmcTraceMemSim(*memSim));
+
+    Stats::resume("CexInterp");
+    CexInterpreter interp(M, M.getDataLayout(), tli);
+    interp.loadTrace(*traceW);
+    CexInterpreter::Result res = interp.run(F);
+    Stats::stop("CexInterp");
+
+    Stats::sset("CexInterp", CexInterpreter::statusName(res.status));
+    if (res.status != CexInterpreter::Status::Error)
+      errs() << "Warning: concrete replay of cex did not reach an error: "
+             << res << "\n";
+    LOG("cex", errs() << "Concrete replay of cex: " << res << "\n";);
+  }
+
+  if (dumpHarness) {
     const DataLayout &dl = M.getDataLayout();
     std::unique_ptr<BmcTraceWrapper> traceW(new BmcTraceWrapper(trace));
     if (memSim) {
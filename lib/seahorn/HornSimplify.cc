@@ -0,0 +1,870 @@
+#include "seahorn/HornSimplify.hh"
+
+#include "seahorn/Expr/ExprOpBinder.hh"
+#include "seahorn/Expr/ExprOpVariant.hh"
+#include "seahorn/Expr/ExprVisitor.hh"
+#include "seahorn/Support/SeaDebug.h"
+#include "seahorn/Support/Stats.hh"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+
+namespace seahorn {
+using namespace expr;
+using namespace expr::op;
+
+namespace {
+/// An application of a relation in a given set
+struct IsRelApp : public std::unary_function<Expr, bool> {
+  const ExprSet &m_rels;
+  IsRelApp(const ExprSet &rels) : m_rels(rels) {}
+  bool operator()(Expr e) const {
+    return bind::isFapp(e) && m_rels.count(bind::fname(e)) > 0;
+  }
+};
+
+/// true if \p e mentions no constant and no bound variable
+bool isGround(Expr e) {
+  ExprVector v;
+  filter(e, [](Expr x) { return bind::isFapp(x) || bind::isBVar(x); },
+         std::back_inserter(v));
+  return v.empty();
+}
+
+/// constants that occur in \p e
+ExprSet constsOf(Expr e) {
+  ExprSet res;
+  filter(e, bind::IsConst(), std::inserter(res, res.begin()));
+  return res;
+}
+
+ExprVector appArgs(Expr app) {
+  return ExprVector(++app->args_begin(), app->args_end());
+}
+
+/// Top-level conjuncts of \p e
+void conjuncts(Expr e, ExprVector &out) {
+  if (isOpX<AND>(e))
+    for (auto it = e->args_begin(), end = e->args_end(); it != end; ++it)
+      conjuncts(*it, out);
+  else
+    out.push_back(e);
+}
+
+Expr mkAnd(const ExprVector &v, ExprFactory &efac) {
+  return mknary<AND>(mk<TRUE>(efac), v);
+}
+
+/// Constants to stand for the arguments of \p rel
+ExprVector mkArgs(Expr rel) {
+  Expr name = mkTerm<std::string>("hs_arg", rel->efac());
+  ExprVector res;
+  for (unsigned i = 0, sz = bind::domainSz(rel); i < sz; ++i)
+    res.push_back(
+        bind::mkConst(variant::variant(i, name), bind::domainTy(rel, i)));
+  return res;
+}
+
+/// Union-find over the terms of a rule
+class TermPartition {
+  ExprMap m_parent;
+
+public:
+  Expr find(Expr e) {
+    auto it = m_parent.find(e);
+    if (it == m_parent.end())
+      return e;
+    Expr root = find(it->second);
+    it->second = root;
+    return root;
+  }
+  /// Returns true if \p a and \p b were in different classes
+  bool merge(Expr a, Expr b) {
+    a = find(a);
+    b = find(b);
+    if (a == b)
+      return false;
+    m_parent[a] = b;
+    return true;
+  }
+  /// \p e with every constant replaced by the root of its class
+  Expr canon(Expr e) {
+    ExprMap sub;
+    for (Expr c : constsOf(e))
+      if (find(c) != c)
+        sub[c] = find(c);
+    return sub.empty() ? e : replace(e, sub);
+  }
+};
+} // namespace
+
+class HornSimplifier {
+  struct Rule {
+    ExprVector m_vars;
+    Expr m_head;
+    Expr m_body;
+    /// rules of the original db this rule is made of, top-down
+    std::vector<unsigned> m_trace;
+    bool m_dead;
+  };
+  typedef HornSimplifyModelConverter::signature_type signature_type;
+
+  HornClauseDB &m_db;
+  HornSimplifyModelConverter &m_mc;
+  ExprFactory &m_efac;
+
+  std::vector<Rule> m_rules;
+  /// relations of the db being simplified
+  ExprSet m_rels;
+  /// relations of the queries
+  ExprSet m_queryRels;
+  /// relations that are neither inlined nor sliced
+  ExprSet m_fixed;
+  /// head relations of the original rules
+  ExprVector m_origHeads;
+  unsigned m_fresh;
+
+  Expr headRel(const Rule &r) const { return bind::fname(r.m_head); }
+
+  ExprVector bodyApps(const Rule &r) const {
+    ExprVector res;
+    filter(r.m_body, IsRelApp(m_rels), std::back_inserter(res));
+    return res;
+  }
+
+  signature_type signature(const Rule &r) const {
+    ExprVector rels;
+    for (Expr app : bodyApps(r))
+      rels.push_back(bind::fname(app));
+    std::sort(rels.begin(), rels.end());
+    return signature_type(headRel(r), rels);
+  }
+
+  /// relations a counterexample goes through when it uses \p r
+  ExprVector traceKey(const Rule &r) const {
+    ExprVector res;
+    for (unsigned i : r.m_trace)
+      res.push_back(m_origHeads[i]);
+    return res;
+  }
+
+  /// Records that \p rel is defined by \p def over \p args
+  void define(Expr rel, const ExprVector &args, Expr def,
+              const ExprVector &vars = ExprVector()) {
+    HornSimplifyModelConverter::Step step;
+    step.m_rel = rel;
+    step.m_args = args;
+    step.m_defs.push_back(std::make_pair(vars, def));
+    m_mc.m_steps.push_back(step);
+  }
+
+  void removeRel(Expr rel, bool value) {
+    m_rels.erase(rel);
+    define(rel, mkArgs(rel), value ? mk<TRUE>(m_efac) : mk<FALSE>(m_efac));
+  }
+
+  void coi();
+  void inlineRels();
+  bool sliceArgs();
+  std::map<Expr, std::vector<bool>> relevantArgs();
+  std::map<Expr, std::vector<unsigned>> equalArgs();
+  bool pruneArgs();
+  void subsume();
+
+public:
+  HornSimplifier(HornClauseDB &db, HornSimplifyModelConverter &mc)
+      : m_db(db), m_mc(mc), m_efac(db.getExprFactory()), m_fresh(0) {
+    for (Expr rel : db.getRelations()) {
+      m_rels.insert(rel);
+      m_mc.m_rels.push_back(rel);
+      if (db.hasConstraints(rel) || db.hasInvariants(rel))
+        m_fixed.insert(rel);
+    }
+    for (Expr q : db.getQueries())
+      if (bind::isFapp(q)) {
+        m_queryRels.insert(bind::fname(q));
+        m_fixed.insert(bind::fname(q));
+      }
+    for (const HornRule &r : db.getRules()) {
+      Rule rule;
+      rule.m_vars = r.vars();
+      rule.m_head = r.head();
+      rule.m_body = r.body();
+      rule.m_trace.push_back(m_rules.size());
+      rule.m_dead = false;
+      m_rules.push_back(rule);
+      m_origHeads.push_back(bind::fname(r.head()));
+      m_mc.m_rules.push_back(r.get());
+    }
+    m_mc.m_allRels = m_rels;
+  }
+
+  void run() {
+    coi();
+    inlineRels();
+    while (sliceArgs() || pruneArgs())
+      ;
+    subsume();
+  }
+
+  void write(HornClauseDB &tdb) {
+    for (Expr rel : m_rels)
+      tdb.registerRelation(rel);
+    for (Rule &r : m_rules) {
+      if (r.m_dead)
+        continue;
+      tdb.addRule(HornRule(r.m_vars, r.m_head, r.m_body));
+      m_mc.m_traces.insert(std::make_pair(signature(r), r.m_trace));
+    }
+    for (Expr q : m_db.getQueries())
+      tdb.addQuery(q);
+
+    // -- relations with constraints or invariants are unchanged
+    for (Expr rel : m_rels) {
+      if (!m_db.hasConstraints(rel) && !m_db.hasInvariants(rel))
+        continue;
+      Expr app = bind::fapp(rel, mkArgs(rel));
+      if (m_db.hasConstraints(rel))
+        tdb.addConstraint(app, m_db.getConstraints(app));
+      if (m_db.hasInvariants(rel))
+        tdb.addInvariant(app, m_db.getInvariants(app));
+    }
+    m_mc.m_allRels.insert(m_rels.begin(), m_rels.end());
+  }
+};
+
+/// Removes the relations that cannot be derived, and then those that the
+/// queries do not depend on
+void HornSimplifier::coi() {
+  // -- forward: a relation is derived once a rule defining it has all
+  // -- its body relations derived
+  ExprSet derived;
+  std::map<Expr, std::vector<unsigned>> users;
+  std::vector<unsigned> missing(m_rules.size(), 0);
+  ExprVector work;
+  for (unsigned i = 0, sz = m_rules.size(); i < sz; ++i) {
+    ExprSet rels;
+    for (Expr app : bodyApps(m_rules[i]))
+      rels.insert(bind::fname(app));
+    missing[i] = rels.size();
+    for (Expr rel : rels)
+      users[rel].push_back(i);
+    if (missing[i] == 0 && derived.insert(headRel(m_rules[i])).second)
+      work.push_back(headRel(m_rules[i]));
+  }
+  while (!work.empty()) {
+    Expr rel = work.back();
+    work.pop_back();
+    for (unsigned i : users[rel])
+      if (--missing[i] == 0 && derived.insert(headRel(m_rules[i])).second)
+        work.push_back(headRel(m_rules[i]));
+  }
+
+  // -- backward: relations that a query depends on
+  std::map<Expr, std::vector<unsigned>> defs;
+  for (unsigned i = 0, sz = m_rules.size(); i < sz; ++i) {
+    if (missing[i] > 0)
+      m_rules[i].m_dead = true;
+    else
+      defs[headRel(m_rules[i])].push_back(i);
+  }
+  ExprSet cone(m_queryRels);
+  work.assign(m_queryRels.begin(), m_queryRels.end());
+  while (!work.empty()) {
+    Expr rel = work.back();
+    work.pop_back();
+    for (unsigned i : defs[rel])
+      for (Expr app : bodyApps(m_rules[i]))
+        if (cone.insert(bind::fname(app)).second)
+          work.push_back(bind::fname(app));
+  }
+  for (Rule &r : m_rules)
+    if (!cone.count(headRel(r)))
+      r.m_dead = true;
+
+  ExprVector rels(m_rels.begin(), m_rels.end());
+  for (Expr rel : rels) {
+    if (m_queryRels.count(rel))
+      continue;
+    if (!derived.count(rel))
+      removeRel(rel, false);
+    else if (!cone.count(rel))
+      removeRel(rel, true);
+  }
+}
+
+/// Inlines every relation that is defined by exactly one rule and used
+/// exactly once, in a rule of another relation.
+///
+/// A counterexample of the simplified db is mapped back through the
+/// relations of its rules. An inlining is skipped if it would make a
+/// rule look like another one that goes through different relations.
+void HornSimplifier::inlineRels() {
+  std::map<Expr, std::vector<unsigned>> defs, uses;
+  std::map<signature_type, ExprVector> traces;
+  for (unsigned i = 0, sz = m_rules.size(); i < sz; ++i) {
+    const Rule &r = m_rules[i];
+    if (r.m_dead)
+      continue;
+    defs[headRel(r)].push_back(i);
+    for (Expr app : bodyApps(r))
+      uses[bind::fname(app)].push_back(i);
+    traces.insert(std::make_pair(signature(r), traceKey(r)));
+  }
+
+  for (auto &kv : uses) {
+    Expr rel = kv.first;
+    if (m_fixed.count(rel) || kv.second.size() != 1 || defs[rel].size() != 1)
+      continue;
+    unsigned u = kv.second[0], d = defs[rel][0];
+    Rule &use = m_rules[u];
+    const Rule &def = m_rules[d];
+    if (u == d || headRel(use) == rel)
+      continue;
+
+    Expr app;
+    for (Expr a : bodyApps(use))
+      if (bind::fname(a) == rel)
+        app = a;
+    ExprVector defApps = bodyApps(def);
+
+    // -- rename the variables of def apart. Head arguments that are
+    // -- variables take the values of the arguments of app
+    ExprSet defVars(def.m_vars.begin(), def.m_vars.end());
+    ExprVector actuals = appArgs(app), formals = appArgs(def.m_head);
+    ExprMap sub;
+    std::vector<bool> bound(formals.size(), false);
+    for (unsigned k = 0; k < formals.size(); ++k)
+      if (defVars.count(formals[k]) && !sub.count(formals[k])) {
+        sub[formals[k]] = actuals[k];
+        bound[k] = true;
+      }
+    Rule res;
+    res.m_vars = use.m_vars;
+    for (Expr v : def.m_vars) {
+      if (sub.count(v))
+        continue;
+      Expr name = bind::fname(bind::fname(v));
+      Expr fresh = bind::mkConst(
+          variant::variant(++m_fresh, variant::tag(name, "hs")),
+          bind::typeOf(v));
+      sub[v] = fresh;
+      res.m_vars.push_back(fresh);
+    }
+    ExprVector inl;
+    conjuncts(replace(def.m_body, sub), inl);
+    for (unsigned k = 0; k < formals.size(); ++k)
+      if (!bound[k])
+        inl.push_back(mk<EQ>(replace(formals[k], sub), actuals[k]));
+
+    ExprMap appSub;
+    appSub[app] = mkAnd(inl, m_efac);
+    res.m_head = use.m_head;
+    res.m_body = replace(use.m_body, appSub);
+    res.m_trace = use.m_trace;
+    res.m_trace.insert(res.m_trace.end(), def.m_trace.begin(),
+                       def.m_trace.end());
+    res.m_dead = false;
+
+    ExprVector key = traceKey(res);
+    auto it = traces.insert(std::make_pair(signature(res), key)).first;
+    if (it->second != key)
+      continue;
+
+    // -- the relation is defined by the body of its only rule
+    ExprVector args = mkArgs(rel);
+    ExprVector eqs;
+    conjuncts(def.m_body, eqs);
+    for (unsigned k = 0; k < formals.size(); ++k)
+      eqs.push_back(mk<EQ>(args[k], formals[k]));
+    define(rel, args, mkAnd(eqs, m_efac), def.m_vars);
+
+    LOG("horn-simplify", errs() << "inlined " << *bind::fname(rel) << "\n";);
+
+    use = res;
+    m_rules[d].m_dead = true;
+    m_rels.erase(rel);
+    defs[rel].clear();
+    kv.second.clear();
+    for (Expr a : defApps)
+      for (unsigned &i : uses[bind::fname(a)])
+        if (i == d)
+          i = u;
+  }
+}
+
+/// Removes the arguments of a relation that no use of the relation
+/// constrains, or that every rule defining the relation sets to the same
+/// constant. Returns true if an argument was removed.
+bool HornSimplifier::sliceArgs() {
+  std::map<Expr, std::vector<unsigned>> defs;
+  std::map<Expr, std::vector<std::pair<unsigned, Expr>>> uses;
+  for (unsigned i = 0, sz = m_rules.size(); i < sz; ++i) {
+    const Rule &r = m_rules[i];
+    if (r.m_dead)
+      continue;
+    defs[headRel(r)].push_back(i);
+    for (Expr app : bodyApps(r))
+      uses[bind::fname(app)].push_back(std::make_pair(i, app));
+  }
+
+  bool changed = false;
+  ExprVector rels(m_rels.begin(), m_rels.end());
+  for (Expr rel : rels) {
+    unsigned n = bind::domainSz(rel);
+    if (n == 0 || m_fixed.count(rel) || defs[rel].empty() || uses[rel].empty())
+      continue;
+
+    // -- arguments that every definition sets to the same constant
+    ExprVector value(n);
+    bool first = true;
+    for (unsigned i : defs[rel]) {
+      const Rule &r = m_rules[i];
+      ExprMap eqs;
+      ExprVector body;
+      conjuncts(r.m_body, body);
+      for (Expr c : body)
+        if (isOpX<EQ>(c) && isGround(c->right()))
+          eqs[c->left()] = c->right();
+        else if (isOpX<EQ>(c) && isGround(c->left()))
+          eqs[c->right()] = c->left();
+
+      ExprVector args = appArgs(r.m_head);
+      for (unsigned k = 0; k < n; ++k) {
+        Expr v = isGround(args[k]) ? args[k] : Expr();
+        if (!v && eqs.count(args[k]))
+          v = eqs[args[k]];
+        if (first)
+          value[k] = v;
+        else if (value[k] != v)
+          value[k] = Expr();
+      }
+      first = false;
+    }
+
+    // -- arguments that are fresh variables at every use
+    std::vector<bool> unused(n, true);
+    for (auto &use : uses[rel]) {
+      const Rule &r = m_rules[use.first];
+      ExprMap appSub;
+      appSub[use.second] = mk<TRUE>(m_efac);
+      ExprSet rest = constsOf(mk<AND>(r.m_head, replace(r.m_body, appSub)));
+      ExprVector args = appArgs(use.second);
+      std::map<Expr, unsigned> occurs;
+      for (Expr a : args)
+        for (Expr c : constsOf(a))
+          ++occurs[c];
+      for (unsigned k = 0; k < n; ++k)
+        if (!bind::IsConst()(args[k]) || rest.count(args[k]) ||
+            occurs[args[k]] > 1 ||
+            std::find(r.m_vars.begin(), r.m_vars.end(), args[k]) ==
+                r.m_vars.end())
+          unused[k] = false;
+    }
+
+    ExprVector types;
+    std::vector<unsigned> kept;
+    for (unsigned k = 0; k < n; ++k)
+      if (!unused[k] && !value[k]) {
+        kept.push_back(k);
+        types.push_back(bind::domainTy(rel, k));
+      }
+    if (kept.size() == n)
+      continue;
+    types.push_back(bind::rangeTy(rel));
+    Expr nrel = bind::fdecl(variant::tag(bind::fname(rel), "s"), types);
+
+    auto project = [&kept, nrel](const ExprVector &args) {
+      ExprVector res;
+      for (unsigned k : kept)
+        res.push_back(args[k]);
+      return bind::fapp(nrel, res);
+    };
+    // -- the constants that a use no longer passes
+    auto constants = [&](const ExprVector &args) {
+      ExprVector res;
+      for (unsigned k = 0; k < n; ++k)
+        if (!unused[k] && value[k])
+          res.push_back(mk<EQ>(args[k], value[k]));
+      return res;
+    };
+
+    ExprVector args = mkArgs(rel);
+    ExprVector def = constants(args);
+    def.push_back(project(args));
+    define(rel, args, mkAnd(def, m_efac));
+
+    for (unsigned i : defs[rel])
+      m_rules[i].m_head = project(appArgs(m_rules[i].m_head));
+    for (auto &use : uses[rel]) {
+      Rule &r = m_rules[use.first];
+      ExprVector uargs = appArgs(use.second);
+      ExprVector c = constants(uargs);
+      c.push_back(project(uargs));
+      ExprMap appSub;
+      appSub[use.second] = mkAnd(c, m_efac);
+      r.m_body = replace(r.m_body, appSub);
+    }
+
+    LOG("horn-simplify", errs() << "sliced " << n - kept.size() << " of " << n
+                                << " arguments of " << *bind::fname(rel)
+                                << "\n";);
+
+    m_rels.erase(rel);
+    m_rels.insert(nrel);
+    m_mc.m_allRels.insert(nrel);
+    changed = true;
+  }
+  return changed;
+}
+
+/// Computes, for every relation, the arguments whose value can influence
+/// whether a query is derivable.
+///
+/// This is a least fixpoint over the rules. All arguments of fixed
+/// relations are relevant. An argument of a body application is relevant
+/// unless it is a variable of the rule that occurs nowhere else in the
+/// rule, except as irrelevant arguments of the head. Such arguments are
+/// only passed through, as unused shadow memory often is.
+std::map<Expr, std::vector<bool>> HornSimplifier::relevantArgs() {
+  std::map<Expr, std::vector<bool>> relevant;
+  for (Expr rel : m_rels)
+    relevant[rel].assign(bind::domainSz(rel), m_fixed.count(rel) > 0);
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const Rule &r : m_rules) {
+      if (r.m_dead)
+        continue;
+      ExprVector body;
+      conjuncts(r.m_body, body);
+      ExprVector constraints;
+      for (Expr c : body)
+        if (!IsRelApp(m_rels)(c))
+          constraints.push_back(c);
+      ExprSet constrained = constsOf(mkAnd(constraints, m_efac));
+
+      ExprVector apps = bodyApps(r);
+      std::map<Expr, unsigned> occurs;
+      for (Expr app : apps)
+        for (Expr a : appArgs(app))
+          for (Expr c : constsOf(a))
+            ++occurs[c];
+
+      Expr head = headRel(r);
+      ExprVector hargs = appArgs(r.m_head);
+      const std::vector<bool> &hrel = relevant[head];
+      auto passedThrough = [&](Expr a) {
+        if (!bind::IsConst()(a) || constrained.count(a) || occurs[a] > 1 ||
+            std::find(r.m_vars.begin(), r.m_vars.end(), a) == r.m_vars.end())
+          return false;
+        for (unsigned j = 0, sz = hargs.size(); j < sz; ++j)
+          if ((hargs[j] != a || hrel[j]) && constsOf(hargs[j]).count(a))
+            return false;
+        return true;
+      };
+
+      for (Expr app : apps) {
+        std::vector<bool> &rel = relevant[bind::fname(app)];
+        ExprVector args = appArgs(app);
+        for (unsigned k = 0, sz = args.size(); k < sz; ++k)
+          if (!rel[k] && !passedThrough(args[k])) {
+            rel[k] = true;
+            changed = true;
+          }
+      }
+    }
+  }
+  return relevant;
+}
+
+/// Partitions the arguments of every relation into classes of arguments
+/// that are equal in every derivable fact. The class of an argument is
+/// named by its first position.
+///
+/// This is a greatest fixpoint: it starts from one class per type and
+/// splits a class whenever a rule may derive a head whose arguments in the
+/// class differ, assuming the classes of its body applications.
+std::map<Expr, std::vector<unsigned>> HornSimplifier::equalArgs() {
+  std::map<Expr, std::vector<unsigned>> classes;
+  for (Expr rel : m_rels) {
+    std::vector<unsigned> &cls = classes[rel];
+    for (unsigned k = 0, n = bind::domainSz(rel); k < n; ++k) {
+      cls.push_back(k);
+      if (m_fixed.count(rel))
+        continue;
+      for (unsigned j = 0; j < k; ++j)
+        if (bind::domainTy(rel, j) == bind::domainTy(rel, k)) {
+          cls[k] = j;
+          break;
+        }
+    }
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const Rule &r : m_rules) {
+      Expr head = headRel(r);
+      if (r.m_dead || m_fixed.count(head))
+        continue;
+
+      TermPartition eq;
+      for (Expr app : bodyApps(r)) {
+        const std::vector<unsigned> &cls = classes[bind::fname(app)];
+        ExprVector args = appArgs(app);
+        for (unsigned k = 0, sz = args.size(); k < sz; ++k)
+          eq.merge(args[k], args[cls[k]]);
+      }
+      ExprVector body;
+      conjuncts(r.m_body, body);
+      // -- a bounded number of rounds, since the canonical forms of the
+      // -- sides of an equality change as classes are merged
+      for (unsigned round = 0, more = 1; more && round < body.size();
+           ++round) {
+        more = 0;
+        for (Expr c : body)
+          if (isOpX<EQ>(c))
+            more |= eq.merge(eq.canon(c->left()), eq.canon(c->right()));
+      }
+
+      std::vector<unsigned> &cls = classes[head];
+      ExprVector hargs = appArgs(r.m_head);
+      std::map<std::pair<unsigned, Expr>, unsigned> split;
+      for (unsigned k = 0, sz = hargs.size(); k < sz; ++k) {
+        auto key = std::make_pair(cls[k], eq.find(eq.canon(hargs[k])));
+        unsigned c = split.insert(std::make_pair(key, k)).first->second;
+        if (c != cls[k]) {
+          cls[k] = c;
+          changed = true;
+        }
+      }
+    }
+  }
+  return classes;
+}
+
+/// Removes the arguments that cannot influence a query, and the arguments
+/// that are always equal to an earlier argument of the same relation.
+/// Returns true if an argument was removed.
+bool HornSimplifier::pruneArgs() {
+  std::map<Expr, std::vector<bool>> relevant = relevantArgs();
+  std::map<Expr, std::vector<unsigned>> classes = equalArgs();
+
+  std::map<Expr, std::vector<unsigned>> defs;
+  std::map<Expr, std::vector<std::pair<unsigned, Expr>>> uses;
+  for (unsigned i = 0, sz = m_rules.size(); i < sz; ++i) {
+    const Rule &r = m_rules[i];
+    if (r.m_dead)
+      continue;
+    defs[headRel(r)].push_back(i);
+    for (Expr app : bodyApps(r))
+      uses[bind::fname(app)].push_back(std::make_pair(i, app));
+  }
+
+  bool changed = false;
+  ExprVector rels(m_rels.begin(), m_rels.end());
+  for (Expr rel : rels) {
+    unsigned n = bind::domainSz(rel);
+    if (n == 0 || m_fixed.count(rel) || defs[rel].empty())
+      continue;
+
+    // -- each relevant argument is kept, or replaced by the first relevant
+    // -- argument of its class
+    const std::vector<bool> &rlv = relevant[rel];
+    const std::vector<unsigned> &cls = classes[rel];
+    std::vector<int> rep(n, -1);
+    std::map<unsigned, unsigned> first;
+    for (unsigned k = 0; k < n; ++k)
+      if (rlv[k])
+        rep[k] = first.insert(std::make_pair(cls[k], k)).first->second;
+
+    ExprVector types;
+    std::vector<unsigned> kept;
+    for (unsigned k = 0; k < n; ++k)
+      if (rep[k] == (int)k) {
+        kept.push_back(k);
+        types.push_back(bind::domainTy(rel, k));
+      }
+    if (kept.size() == n)
+      continue;
+    types.push_back(bind::rangeTy(rel));
+    Expr nrel = bind::fdecl(variant::tag(bind::fname(rel), "p"), types);
+
+    auto project = [&kept, nrel](const ExprVector &args) {
+      ExprVector res;
+      for (unsigned k : kept)
+        res.push_back(args[k]);
+      return bind::fapp(nrel, res);
+    };
+    // -- the equalities that a use no longer passes
+    auto equalities = [&](const ExprVector &args) {
+      ExprVector res;
+      for (unsigned k = 0; k < n; ++k)
+        if (rep[k] >= 0 && rep[k] != (int)k)
+          res.push_back(mk<EQ>(args[k], args[rep[k]]));
+      return res;
+    };
+
+    ExprVector args = mkArgs(rel);
+    ExprVector def = equalities(args);
+    def.push_back(project(args));
+    define(rel, args, mkAnd(def, m_efac));
+
+    for (unsigned i : defs[rel])
+      m_rules[i].m_head = project(appArgs(m_rules[i].m_head));
+    for (auto &use : uses[rel]) {
+      Rule &r = m_rules[use.first];
+      ExprVector uargs = appArgs(use.second);
+      ExprVector c = equalities(uargs);
+      c.push_back(project(uargs));
+      ExprMap appSub;
+      appSub[use.second] = mkAnd(c, m_efac);
+      r.m_body = replace(r.m_body, appSub);
+    }
+
+    LOG("horn-simplify", errs() << "pruned " << n - kept.size() << " of " << n
+                                << " arguments of " << *bind::fname(rel)
+                                << "\n";);
+
+    m_rels.erase(rel);
+    m_rels.insert(nrel);
+    m_mc.m_allRels.insert(nrel);
+    changed = true;
+  }
+  return changed;
+}
+
+/// Removes rules with a false body, and rules whose body is a superset of
+/// the body of another rule with the same head
+void HornSimplifier::subsume() {
+  // -- bound on the number of rules with the same head that are compared
+  // -- pairwise
+  const unsigned maxGroup = 64;
+
+  std::map<Expr, std::vector<unsigned>> groups;
+  for (unsigned i = 0, sz = m_rules.size(); i < sz; ++i) {
+    Rule &r = m_rules[i];
+    if (r.m_dead)
+      continue;
+    if (isOpX<FALSE>(r.m_body))
+      r.m_dead = true;
+    else
+      groups[r.m_head].push_back(i);
+  }
+
+  for (auto &kv : groups) {
+    std::vector<unsigned> &group = kv.second;
+    if (group.size() < 2 || group.size() > maxGroup)
+      continue;
+    std::vector<ExprVector> bodies(group.size());
+    for (unsigned i = 0; i < group.size(); ++i) {
+      conjuncts(m_rules[group[i]].m_body, bodies[i]);
+      std::sort(bodies[i].begin(), bodies[i].end());
+      bodies[i].erase(std::unique(bodies[i].begin(), bodies[i].end()),
+                      bodies[i].end());
+    }
+    for (unsigned i = 0; i < group.size(); ++i)
+      for (unsigned j = 0; j < group.size(); ++j) {
+        if (i == j || m_rules[group[j]].m_dead)
+          continue;
+        if (std::includes(bodies[i].begin(), bodies[i].end(),
+                          bodies[j].begin(), bodies[j].end())) {
+          m_rules[group[i]].m_dead = true;
+          break;
+        }
+      }
+  }
+}
+
+static unsigned numArgs(const HornClauseDB &db) {
+  unsigned res = 0;
+  for (Expr rel : db.getRelations())
+    res += bind::domainSz(rel);
+  return res;
+}
+
+HornSimplifyStats simplifyHornClauseDB(HornClauseDB &db, HornClauseDB &tdb,
+                                       HornSimplifyModelConverter &mc) {
+  ScopedStats _st_("HornSimplify");
+
+  HornSimplifier hs(db, mc);
+  hs.run();
+  hs.write(tdb);
+
+  HornSimplifyStats stats;
+  stats.m_rulesBefore = db.getRules().size();
+  stats.m_rulesAfter = tdb.getRules().size();
+  stats.m_relsBefore = db.getRelations().size();
+  stats.m_relsAfter = tdb.getRelations().size();
+  stats.m_argsBefore = numArgs(db);
+  stats.m_argsAfter = numArgs(tdb);
+  return stats;
+}
+
+Expr HornSimplifyModelConverter::applyModel(HornDbModel &model, Expr e) {
+  ExprVector apps;
+  filter(e, IsRelApp(m_allRels), std::back_inserter(apps));
+  ExprMap sub;
+  for (Expr app : apps)
+    sub[app] = model.getDef(app);
+  return replace(e, sub);
+}
+
+bool HornSimplifyModelConverter::convert(HornDbModel &in, HornDbModel &out) {
+  HornDbModel model(in);
+  for (auto it = m_steps.rbegin(), end = m_steps.rend(); it != end; ++it) {
+    ExprFactory &efac = it->m_rel->efac();
+    ExprVector defs;
+    for (auto &def : it->m_defs) {
+      Expr e = applyModel(model, def.second);
+      if (!def.first.empty()) {
+        // -- exists V . e  ==  !(forall V . !e)
+        ExprSet vars(def.first.begin(), def.first.end());
+        try {
+          e = boolop::lneg(z3_forall_elim(m_zctx, boolop::lneg(e), vars));
+        } catch (z3::exception &ex) {
+          errs() << "Warning: cannot eliminate quantifiers in the definition "
+                 << "of " << *bind::fname(it->m_rel) << ": " << ex.msg()
+                 << "\n";
+          return false;
+        }
+      }
+      defs.push_back(e);
+    }
+    model.addDef(bind::fapp(it->m_rel, it->m_args),
+                 mknary<OR>(mk<FALSE>(efac), defs));
+  }
+
+  for (Expr rel : m_rels) {
+    Expr app = bind::fapp(rel, mkArgs(rel));
+    out.addDef(app, model.getDef(app));
+  }
+  return true;
+}
+
+bool HornSimplifyModelConverter::convertCex(const ExprVector &in,
+                                            ExprVector &out) {
+  for (Expr r : in) {
+    Expr head = isOpX<IMPL>(r) ? r->arg(1) : r;
+    if (!bind::isFapp(head))
+      return false;
+    ExprVector body;
+    if (isOpX<IMPL>(r)) {
+      filter(r->arg(0), IsRelApp(m_allRels), std::back_inserter(body));
+      for (Expr &app : body)
+        app = bind::fname(app);
+      std::sort(body.begin(), body.end());
+    }
+    auto it = m_traces.find(signature_type(bind::fname(head), body));
+    if (it == m_traces.end())
+      return false;
+    for (unsigned i : it->second)
+      out.push_back(m_rules[i]);
+  }
+  return true;
+}
+
+} // namespace seahorn
@@ -1,6 +1,8 @@
 #include "seahorn/HornSolver.hh"
 #include "seahorn/HornClauseDBTransf.hh"
 #include "seahorn/HornDbModel.hh"
+#include "seahorn/HornSimplify.hh"
+#include "seahorn/HornSummaryCache.hh"
 #include "seahorn/HornifyModule.hh"
 #include "seahorn/Expr/ExprLlvm.hh"
 
@@ -10,7 +12,12 @@
 
 #include "boost/range/algorithm/reverse.hpp"
 
+#include <atomic>
+#include <cctype>
+#include <chrono>
 #include <climits>
+#include <mutex>
+#include <thread>
 #include "seahorn/Support/SeaDebug.h"
 
 using namespace llvm;
@@ -94,21 +101,57 @@ static llvm::cl::opt<bool>
     UseEufGen("horn-use-euf-gen", cl::Hidden, cl::init(true),
               cl::desc("Use euf generalizer for equalities"));
 
+static llvm::cl::opt<bool>
+    Simplify("horn-simplify", cl::init(false),
+             cl::desc("Simplify the Horn clauses before solving them"));
+
+static llvm::cl::list<std::string> PortfolioProfiles(
+    "horn-portfolio",
+    cl::desc("Solve with one fixedpoint instance per profile, in parallel. "
+             "A profile is a space-separated list of name=value parameters "
+             "set on top of the default ones"),
+    cl::ZeroOrMore, cl::value_desc("profile"));
+
+static llvm::cl::opt<std::string> SummaryCacheDir(
+    "horn-summary-cache",
+    cl::desc("Directory where the invariants of functions are cached across "
+             "runs. Cached invariants are added to the Horn clauses and the "
+             "new ones are stored when the program is safe"),
+    cl::init(""), cl::value_desc("dir"));
+
 namespace seahorn {
   char HornSolver::ID = 0;
 
-  bool HornSolver::runOnModule(Module &M) {
-    Stats::sset ("Result", "UNKNOWN");
-
-    HornifyModule &hm = getAnalysis<HornifyModule> ();
-
-    // Load the Horn clause database
-    auto &db = hm.getHornClauseDB ();
-
-    m_fp.reset (new ZFixedPoint<EZ3> (hm.getZContext ()));
-    ZFixedPoint<EZ3> &fp = *m_fp;
+  /// Sets the name=value parameters of \p profile. A value is a Boolean,
+  /// an unsigned, a double (with a fraction or an exponent) or a symbol
+  static void setProfile(ZParams<EZ3> &params, const std::string &profile) {
+    SmallVector<StringRef, 8> kvs;
+    StringRef(profile).split(kvs, ' ', -1, false);
+    for (StringRef kv : kvs) {
+      StringRef k, v;
+      std::tie(k, v) = kv.split('=');
+      if (k.empty() || v.empty())
+        report_fatal_error("Bad parameter in horn-portfolio profile: " + kv);
+      std::string name = k.startswith(":") ? k.str() : ":" + k.str();
+      unsigned n;
+      double d;
+      if (v == "true" || v == "false")
+        params.set(name, v == "true");
+      else if (!v.getAsInteger(10, n))
+        params.set(name, n);
+      else if (v.front() == '-')
+        // -- z3 has no signed parameters
+        report_fatal_error("Negative value in horn-portfolio profile: " + kv);
+      else if (!v.getAsDouble(d))
+        params.set(name, d);
+      else if (isdigit(v.front()) || v.front() == '.')
+        report_fatal_error("Bad number in horn-portfolio profile: " + kv);
+      else
+        params.set(name, v.str());
+    }
+  }
 
-    ZParams<EZ3> params (hm.getZContext ());
+  void HornSolver::setParams(ZParams<EZ3> &params) {
     params.set(":engine", ChcEngine);
     // -- disable slicing so that we can use cover
     params.set (":xform.slice", false);
@@ -137,6 +180,161 @@ namespace seahorn {
     params.set(":spacer.ground_pobs", false);
     params.set(":spacer.use_euf_gen", UseEufGen);
     params.set(":spacer.max_level", HornMaxDepth);
+  }
+
+  /// Solves the clauses of \p db with one fixedpoint per profile, each in
+  /// its own z3 context and thread. The first definitive answer wins and
+  /// interrupts the other instances; the winner is kept in m_fp.
+  ///
+  /// Expressions are not thread-safe: all instances are loaded, and the
+  /// answer is extracted, in the calling thread. The threads only run
+  /// ZFixedPoint::solve().
+  boost::tribool HornSolver::runPortfolio(HornClauseDB &db) {
+    struct Instance {
+      std::unique_ptr<EZ3> zctx;
+      std::unique_ptr<ZFixedPoint<EZ3>> fp;
+      boost::tribool res = boost::indeterminate;
+    };
+
+    ExprFactory &efac = db.getExprFactory();
+    std::vector<Instance> instances(PortfolioProfiles.size());
+    for (unsigned i = 0, sz = instances.size(); i < sz; ++i) {
+      Instance &inst = instances[i];
+      inst.zctx.reset(new EZ3(efac));
+      inst.fp.reset(new ZFixedPoint<EZ3>(*inst.zctx));
+
+      ZParams<EZ3> params(*inst.zctx);
+      setParams(params);
+      setProfile(params, PortfolioProfiles[i]);
+      try {
+        inst.fp->set(params);
+      } catch (z3::exception &e) {
+        // -- unknown name or a value of the wrong type
+        report_fatal_error(Twine("Bad horn-portfolio profile \"") +
+                           PortfolioProfiles[i] + "\": " + e.msg());
+      }
+      db.loadZFixedPoint(*inst.fp, SkipConstraints);
+      if (UseInvariant == solver_detail::INACTIVE) {
+        params.set(":spacer.use_bg_invs", false);
+        inst.fp->set(params);
+      }
+      inst.fp->prepareQuery();
+    }
+
+    // -- a single interrupt is lost by an instance that has not entered
+    // -- the query yet, or that is in a phase that ignores it. Instances
+    // -- check `done` before solving, and the calling thread interrupts
+    // -- the unfinished ones until they all return
+    std::mutex mutex;
+    std::atomic<bool> done(false);
+    std::vector<bool> finished(instances.size(), false);
+    unsigned numFinished = 0;
+    int winner = -1;
+    std::vector<std::thread> threads;
+    for (unsigned i = 0, sz = instances.size(); i < sz; ++i)
+      threads.emplace_back(
+          [&instances, &mutex, &done, &finished, &numFinished, &winner, i]() {
+            boost::tribool res = boost::indeterminate;
+            if (!done) {
+              try {
+                res = instances[i].fp->solve();
+              } catch (z3::exception &) {
+                // -- interrupted or failed: no answer from this instance
+              }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            instances[i].res = res;
+            finished[i] = true;
+            ++numFinished;
+            if (!boost::indeterminate(res) && winner < 0) {
+              winner = i;
+              done = true;
+            }
+          });
+
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (numFinished == instances.size())
+          break;
+        if (done)
+          for (unsigned j = 0, sz = instances.size(); j < sz; ++j)
+            if (!finished[j])
+              instances[j].fp->interrupt();
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (std::thread &t : threads)
+      t.join();
+
+    // -- keep the first instance if none has an answer
+    unsigned keep = winner >= 0 ? winner : 0;
+    LOG("horn-portfolio", for (unsigned i = 0; i < instances.size(); ++i) {
+      boost::tribool res = instances[i].res;
+      errs() << "profile " << i << " \"" << PortfolioProfiles[i] << "\": "
+             << (res ? "sat" : !res ? "unsat" : "unknown")
+             << (i == keep ? " (kept)" : "") << "\n";
+    });
+    if (winner >= 0)
+      Stats::uset("HornPortfolioWinner", winner);
+
+    // -- the fixedpoint must go before its context
+    m_fp = std::move(instances[keep].fp);
+    m_zctx = std::move(instances[keep].zctx);
+    return instances[keep].res;
+  }
+
+  bool HornSolver::runOnModule(Module &M) {
+    Stats::sset ("Result", "UNKNOWN");
+
+    HornifyModule &hm = getAnalysis<HornifyModule> ();
+
+    // Load the Horn clause database
+    HornClauseDB *sdb = &hm.getHornClauseDB ();
+    std::unique_ptr<HornSummaryCache> cache;
+    if (!SummaryCacheDir.empty ()) {
+      cache.reset (new HornSummaryCache (SummaryCacheDir, hm));
+      Stats::uset ("HornSummaryCacheHits", cache->load (M, *sdb));
+    }
+    if (Simplify) {
+      m_sdb.reset (new HornClauseDB (sdb->getExprFactory ()));
+      m_mc.reset (new HornSimplifyModelConverter (hm.getZContext ()));
+      HornSimplifyStats st = simplifyHornClauseDB (*sdb, *m_sdb, *m_mc);
+      Stats::uset ("HornSimplifyRulesBefore", st.m_rulesBefore);
+      Stats::uset ("HornSimplifyRulesAfter", st.m_rulesAfter);
+      Stats::uset ("HornSimplifyRelsBefore", st.m_relsBefore);
+      Stats::uset ("HornSimplifyRelsAfter", st.m_relsAfter);
+      Stats::uset ("HornSimplifyArgsBefore", st.m_argsBefore);
+      Stats::uset ("HornSimplifyArgsAfter", st.m_argsAfter);
+      sdb = m_sdb.get ();
+    }
+    auto &db = *sdb;
+
+    if (!PortfolioProfiles.empty()) {
+      Stats::resume ("Horn");
+      m_result = runPortfolio (db);
+      Stats::stop ("Horn");
+    } else
+      solve (db);
+
+    reportResult (M);
+
+    if (cache && !m_result) {
+      HornDbModel model;
+      getModel (model);
+      Stats::uset ("HornSummaryCacheStored", cache->store (M, model));
+    }
+    return false;
+  }
+
+  void HornSolver::solve(HornClauseDB &db) {
+    HornifyModule &hm = getAnalysis<HornifyModule> ();
+    m_fp.reset (new ZFixedPoint<EZ3> (hm.getZContext ()));
+    ZFixedPoint<EZ3> &fp = *m_fp;
+
+    ZParams<EZ3> params (hm.getZContext ());
+    setParams (params);
     fp.set (params);
 
     db.loadZFixedPoint (fp, SkipConstraints);
@@ -149,6 +347,37 @@ namespace seahorn {
     Stats::resume ("Horn");
     m_result = fp.query ();
     Stats::stop ("Horn");
+  }
+
+  void HornSolver::getModel(HornDbModel &model) {
+    if (!m_mc) {
+      initDBModelFromFP(model, getAnalysis<HornifyModule>().getHornClauseDB(),
+                        *m_fp);
+      return;
+    }
+    HornDbModel smodel;
+    initDBModelFromFP(smodel, *m_sdb, *m_fp);
+    if (!m_mc->convert(smodel, model))
+      errs() << "Warning: the model of the simplified Horn clauses could not "
+                "be fully converted\n";
+  }
+
+  void HornSolver::getCexRules(ExprVector &rules) {
+    m_fp->getCexRules(rules);
+    if (!m_mc)
+      return;
+    ExprVector orig;
+    if (m_mc->convertCex(rules, orig)) {
+      rules.swap(orig);
+      return;
+    }
+    errs() << "Warning: the counterexample of the simplified Horn clauses "
+              "could not be converted\n";
+    rules.clear();
+  }
+
+  void HornSolver::reportResult(Module &M) {
+    ZFixedPoint<EZ3> &fp = *m_fp;
 
     if (m_result)
       outs() << "sat";
@@ -167,15 +396,13 @@ namespace seahorn {
 
     if (PrintAnswer && !m_result) {
       HornDbModel dbModel;
-      initDBModelFromFP(dbModel, db, fp);
+      getModel(dbModel);
       printInvars(M, dbModel);
     } else if (PrintAnswer && m_result)
       printCex ();
 
     if (EstimateSizeInvars)
       estimateSizeInvars(M);
-
-    return false;
   }
 
 void HornSolver::getAnalysisUsage(AnalysisUsage &AU) const {
@@ -184,11 +411,8 @@ void HornSolver::getAnalysisUsage(AnalysisUsage &AU) const {
   }
 
 void HornSolver::printCex() {
-    ZFixedPoint<EZ3> fp = *m_fp;
-    //outs () << *fp.getCex () << "\n";
-
     ExprVector rules;
-    fp.getCexRules (rules);
+    getCexRules (rules);
     boost::reverse (rules);
   for (Expr r : rules) {
       Expr src;
@@ -218,7 +442,8 @@ void HornSolver::printCex() {
 
 void HornSolver::estimateSizeInvars(Module &M) {
     HornifyModule &hm = getAnalysis<HornifyModule> ();
-    ZFixedPoint<EZ3> fp = *m_fp;
+    HornDbModel model;
+    getModel (model);
 
     Expr allInvars;
     bool first = true;
@@ -231,7 +456,7 @@ void HornSolver::estimateSizeInvars(Module &M) {
         continue;
         Expr bbPred = hm.bbPredicate (BB);
         const ExprVector &live = hm.live (BB);
-        Expr invars = fp.getCoverDelta (bind::fapp (bbPred, live));
+        Expr invars = model.getDef (bind::fapp (bbPred, live));
         numBlocks++;
         if (first) {
           allInvars = invars;
@@ -0,0 +1,407 @@
+#include "seahorn/HornSummaryCache.hh"
+
+#include "seahorn/Expr/ExprLlvm.hh"
+#include "seahorn/Expr/ExprOpBinder.hh"
+#include "seahorn/Expr/Smt/EZ3.hh"
+#include "seahorn/Support/GitSHA1.h"
+#include "seahorn/Support/SeaDebug.h"
+#include "seahorn/Support/Stats.hh"
+#include "seahorn/config.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+
+using namespace llvm;
+
+namespace seahorn {
+namespace {
+/// version of the format of the cache files
+const char *CacheFormat = "2";
+
+/// horn-* options of the run, sorted
+std::string &cacheOptions() {
+  static std::string opts;
+  return opts;
+}
+
+/// Printed IR without what depends on the rest of the module: debug
+/// information, metadata and attribute group numbers. Region ids of
+/// shadow.mem calls are numbered module-wide, so they are renumbered in
+/// order of appearance
+template <typename V> std::string printIR(const V &v) {
+  static const std::regex metadata("(, )?![A-Za-z_.][A-Za-z0-9_.]* ![0-9]+");
+  static const std::regex attrs(" #[0-9]+");
+  static const std::regex region(
+      "(@shadow\\.mem\\.[A-Za-z0-9_.]*\\(i32 )([0-9]+)");
+
+  std::string str;
+  raw_string_ostream os(str);
+  v.print(os);
+  os.flush();
+
+  std::istringstream in(str);
+  std::string line, res;
+  std::map<std::string, unsigned> regions;
+  while (std::getline(in, line)) {
+    if (line.find("@llvm.dbg.") != std::string::npos ||
+        (!line.empty() && line[0] == ';'))
+      continue;
+    line = std::regex_replace(line, metadata, "");
+    line = std::regex_replace(line, attrs, "");
+    std::smatch m;
+    if (std::regex_search(line, m, region)) {
+      auto it = regions.insert(std::make_pair(m[2].str(), regions.size()));
+      line = m.prefix().str() + m[1].str() +
+             std::to_string(it.first->second) + m.suffix().str();
+    }
+    res += line;
+    res += '\n';
+  }
+  return res;
+}
+
+/// Global variables that \p v refers to, through constant expressions
+/// and initializers
+void collectGlobals(const Value *v, std::set<const GlobalVariable *> &out) {
+  if (const GlobalVariable *gv = dyn_cast<GlobalVariable>(v)) {
+    if (out.insert(gv).second && gv->hasInitializer())
+      collectGlobals(gv->getInitializer(), out);
+  } else if (isa<Constant>(v) && !isa<GlobalValue>(v)) {
+    for (const Use &u : cast<Constant>(v)->operands())
+      collectGlobals(u.get(), out);
+  }
+}
+
+/// Constants that stand for the arguments of \p rel in the cache files
+ExprVector cacheArgs(Expr rel) {
+  ExprVector res;
+  for (unsigned i = 0, sz = bind::domainSz(rel); i < sz; ++i)
+    res.push_back(bind::mkConst(
+        mkTerm<std::string>("sc_arg_" + std::to_string(i), rel->efac()),
+        bind::domainTy(rel, i)));
+  return res;
+}
+
+/// true if the only applications in \p lemma are of \p args
+bool isOver(Expr lemma, const ExprVector &args) {
+  ExprVector apps;
+  filter(lemma, [](Expr e) { return bind::isFapp(e); },
+         std::back_inserter(apps));
+  for (Expr app : apps)
+    if (std::find(args.begin(), args.end(), app) == args.end())
+      return false;
+  return true;
+}
+} // namespace
+
+void setHornSummaryCacheOptions(int argc, char **argv) {
+  std::vector<std::string> opts;
+  for (int i = 1; i < argc; ++i) {
+    StringRef arg = StringRef(argv[i]).ltrim('-');
+    if (arg.startswith("horn-") && !arg.startswith("horn-summary-cache") &&
+        !arg.startswith("horn-stats"))
+      opts.push_back(arg.str());
+  }
+  std::sort(opts.begin(), opts.end());
+  std::string &res = cacheOptions();
+  res.clear();
+  for (const std::string &opt : opts)
+    res += opt + "\n";
+}
+
+const std::string &HornSummaryCache::key(const Function &F) {
+  auto it = m_keys.find(&F);
+  if (it != m_keys.end())
+    return it->second;
+
+  // -- the function and all the functions it calls
+  std::set<const Function *> fns = {&F};
+  std::set<const GlobalVariable *> globals;
+  std::vector<const Function *> work = {&F};
+  bool indirect = false;
+  while (!work.empty() && !indirect) {
+    const Function *fn = work.back();
+    work.pop_back();
+    for (const Instruction &inst : instructions(*fn)) {
+      ImmutableCallSite CS(&inst);
+      if (CS) {
+        const Function *callee =
+            dyn_cast<Function>(CS.getCalledValue()->stripPointerCasts());
+        if (callee && fns.insert(callee).second)
+          work.push_back(callee);
+        indirect |= !callee && !CS.isInlineAsm();
+      }
+      for (const Use &u : inst.operands())
+        collectGlobals(u.get(), globals);
+    }
+  }
+
+  std::string &res = m_keys[&F];
+  if (indirect)
+    return res;
+
+  const Module &M = *F.getParent();
+  MD5 md5;
+  md5.update(CacheFormat);
+  md5.update(SEAHORN_VERSION_INFO);
+  md5.update(g_GIT_SHA1);
+  md5.update(cacheOptions());
+  md5.update(M.getTargetTriple());
+  md5.update(M.getDataLayoutStr());
+  md5.update(F.getName());
+
+  auto byName = [](const GlobalValue *a, const GlobalValue *b) {
+    return a->getName() < b->getName();
+  };
+  std::vector<const Function *> sortedFns(fns.begin(), fns.end());
+  std::sort(sortedFns.begin(), sortedFns.end(), byName);
+  for (const Function *fn : sortedFns)
+    md5.update(printIR(*fn));
+  std::vector<const GlobalVariable *> sortedGlobals(globals.begin(),
+                                                    globals.end());
+  std::sort(sortedGlobals.begin(), sortedGlobals.end(), byName);
+  for (const GlobalVariable *gv : sortedGlobals)
+    md5.update(printIR(*gv));
+
+  MD5::MD5Result digest;
+  md5.final(digest);
+  SmallString<32> hex;
+  MD5::stringifyResult(digest, hex);
+  res = hex.str().str();
+  return res;
+}
+
+std::vector<std::pair<std::string, Expr>>
+HornSummaryCache::relations(const Function &F) {
+  std::vector<std::pair<std::string, Expr>> res;
+  if (Expr sum = m_hm.summaryPredicate(F))
+    res.push_back(std::make_pair("sum", sum));
+  unsigned idx = 0;
+  for (const BasicBlock &bb : F) {
+    if (m_hm.hasBbPredicate(bb))
+      res.push_back(
+          std::make_pair("bb" + std::to_string(idx), m_hm.bbPredicate(bb)));
+    ++idx;
+  }
+  return res;
+}
+
+std::string HornSummaryCache::signature(const Function &F, Expr rel) {
+  DenseMap<const Value *, unsigned> pos;
+  for (const Instruction &inst : instructions(F))
+    pos.insert(std::make_pair(&inst, pos.size()));
+  auto id = [&pos](const Value *v) {
+    if (const Argument *arg = dyn_cast<Argument>(v))
+      return "a" + std::to_string(arg->getArgNo());
+    if (isa<GlobalValue>(v))
+      return "@" + v->getName().str();
+    auto it = pos.find(v);
+    return it != pos.end() ? "i" + std::to_string(it->second)
+                           : std::string("?");
+  };
+  // -- a register is named by a value, or by a region and a scalar in it
+  auto regId = [&id](Expr reg) {
+    Expr u = bind::fname(bind::fname(reg));
+    if (isOpX<VALUE>(u))
+      return id(getTerm<const Value *>(u));
+    if (isOpX<SELECT>(u) && isOpX<VALUE>(u->left()) &&
+        isOpX<VALUE>(u->right()))
+      return id(getTerm<const Value *>(u->left())) + "[" +
+             id(getTerm<const Value *>(u->right())) + "]";
+    return std::string("?");
+  };
+
+  std::string res;
+  if (m_hm.isBbPredicate(rel)) {
+    for (Expr reg : m_hm.live(m_hm.predicateBb(rel)))
+      res += " " + regId(reg);
+    return res;
+  }
+
+  // -- the summary predicate follows the function info
+  const FunctionInfo &fi = m_hm.symExec().getFunctionInfo(F);
+  for (const Value *v : fi.regions)
+    res += " r" + id(v);
+  for (const Argument *arg : fi.args)
+    res += " " + id(arg);
+  for (const GlobalVariable *gv : fi.globals)
+    res += " " + id(gv);
+  if (fi.ret)
+    res += " ret " + id(fi.ret);
+  return res;
+}
+
+std::string HornSummaryCache::path(const std::string &key) const {
+  SmallString<256> res(m_dir);
+  sys::path::append(res, key + ".smt2");
+  return res.str().str();
+}
+
+unsigned HornSummaryCache::load(Module &M, HornClauseDB &db) {
+  ScopedStats _st_("HornSummaryCache.load");
+  EZ3 &zctx = m_hm.getZContext();
+
+  std::set<const Function *> hitFns;
+  for (const Function &F : M) {
+    if (F.isDeclaration() || key(F).empty())
+      continue;
+    auto buf = MemoryBuffer::getFile(path(key(F)));
+    if (!buf) {
+      Stats::count("HornSummaryCache.miss");
+      continue;
+    }
+
+    std::map<std::string, Expr> rels;
+    for (auto &kv : relations(F))
+      rels.insert(kv);
+
+    // -- entries are smt-lib scripts between "#entry <name>" and "#end"
+    unsigned loaded = 0;
+    SmallVector<StringRef, 64> lines;
+    (*buf)->getBuffer().split(lines, '\n');
+    std::string name, sig, script;
+    for (StringRef line : lines) {
+      if (line.startswith("#entry ")) {
+        // -- the name of the predicate, followed by its signature
+        std::pair<StringRef, StringRef> header =
+            line.drop_front(7).rtrim().split(' ');
+        name = header.first.str();
+        sig = header.second.empty() ? "" : " " + header.second.str();
+        script.clear();
+        continue;
+      }
+      if (!line.startswith("#end")) {
+        script += line;
+        script += '\n';
+        continue;
+      }
+
+      Expr rel = rels.count(name) ? rels[name] : Expr();
+      if (!rel || !db.hasRelation(rel) || db.hasConstraints(rel))
+        continue;
+      if (sig != signature(F, rel)) {
+        Stats::count("HornSummaryCache.mismatch");
+        LOG("horn-summary-cache", errs() << "ignoring the invariant of "
+                                         << F.getName() << ":" << name
+                                         << ": arguments do not match\n";);
+        continue;
+      }
+      ExprVector args = cacheArgs(rel);
+      Expr lemma;
+      try {
+        lemma = z3_from_smtlib(zctx, script);
+      } catch (z3::exception &e) {
+        LOG("horn-summary-cache", errs() << "cannot read the invariant of "
+                                         << F.getName() << ":" << name << ": "
+                                         << e.msg() << "\n";);
+        continue;
+      }
+      // -- an entry whose arguments do not match the predicate is ignored
+      if (!isOver(lemma, args))
+        continue;
+      db.addInvariant(bind::fapp(rel, args), lemma);
+      ++loaded;
+    }
+
+    LOG("horn-summary-cache", errs() << "loaded " << loaded
+                                     << " invariants of " << F.getName()
+                                     << "\n";);
+    if (loaded > 0)
+      hitFns.insert(&F);
+  }
+
+  // -- share of the clauses that belong to functions found in the cache,
+  // -- i.e., what caching their clauses and Crab invariants could save
+  unsigned rules = 0, hitRules = 0;
+  for (const HornRule &rule : db.getRules()) {
+    ++rules;
+    Expr head = rule.head();
+    if (!bind::isFapp(head))
+      continue;
+    Expr name = bind::fname(bind::fname(head));
+    const Function *fn = nullptr;
+    if (isOpX<BB>(name))
+      fn = getTerm<const BasicBlock *>(name)->getParent();
+    else if (isOpX<FUNCTION>(name))
+      fn = getTerm<const Function *>(name);
+    if (fn && hitFns.count(fn))
+      ++hitRules;
+  }
+  Stats::uset("HornSummaryCache.rules", rules);
+  Stats::uset("HornSummaryCache.hit_rules", hitRules);
+  return hitFns.size();
+}
+
+unsigned HornSummaryCache::store(Module &M, HornDbModel &model) {
+  ScopedStats _st_("HornSummaryCache.store");
+  EZ3 &zctx = m_hm.getZContext();
+  HornClauseDB &db = m_hm.getHornClauseDB();
+
+  if (std::error_code ec = sys::fs::create_directories(m_dir)) {
+    errs() << "Warning: cannot create the summary cache " << m_dir << ": "
+           << ec.message() << "\n";
+    return 0;
+  }
+
+  unsigned stored = 0;
+  for (const Function &F : M) {
+    if (F.isDeclaration() || key(F).empty())
+      continue;
+
+    std::string entries;
+    for (auto &kv : relations(F)) {
+      Expr rel = kv.second;
+      if (!db.hasRelation(rel) || db.hasConstraints(rel))
+        continue;
+      Expr lemma = model.getDef(bind::fapp(rel, cacheArgs(rel)));
+      if (isOpX<TRUE>(lemma))
+        continue;
+      try {
+        entries += "#entry " + kv.first + signature(F, rel) + "\n" +
+                   zctx.toSmtLibDecls(lemma) +
+                   "(assert " + zctx.toSmtLib(lemma) + ")\n#end\n";
+      } catch (z3::exception &e) {
+        LOG("horn-summary-cache", errs() << "cannot write the invariant of "
+                                         << F.getName() << ":" << kv.first
+                                         << ": " << e.msg() << "\n";);
+      }
+    }
+    if (entries.empty())
+      continue;
+
+    // -- write to a fresh file first, so that concurrent runs never read a
+    // -- partial entry
+    std::string dst = path(key(F));
+    int fd;
+    SmallString<256> tmp;
+    if (sys::fs::createUniqueFile(dst + ".%%%%%%.tmp", fd, tmp))
+      continue;
+    {
+      raw_fd_ostream out(fd, true);
+      out << ";; SeaHorn v." << SEAHORN_VERSION_INFO << " summaries of "
+          << F.getName() << "\n"
+          << entries;
+    }
+    if (sys::fs::rename(tmp, dst)) {
+      sys::fs::remove(tmp);
+      continue;
+    }
+    ++stored;
+  }
+  return stored;
+}
+
+} // namespace seahorn
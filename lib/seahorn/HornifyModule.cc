@@ -280,6 +280,16 @@ bool HornifyModule::runOnModule(Module &M) {
                                mk<OR>(args[0], mk<EQ>(args[1], args[2]))));
   }
 
+  // Functions are hornified one at a time in bottom-up SCC order.
+  //
+  // The order matters: the summary predicate of a function is only
+  // created when the function is hornified (its signature depends on
+  // the live symbols at entry), and liveness and hornification of a
+  // caller read the summaries of its callees. The work cannot be
+  // spread over threads either: all functions share m_efac and m_sem,
+  // neither of which is thread-safe, and the CutPointGraph of a
+  // function is obtained on demand from the legacy pass manager and is
+  // only valid until the next function is requested.
   CallGraph &CG = getAnalysis<CallGraphWrapperPass>().getCallGraph();
   for (auto it = scc_begin(&CG); !it.isAtEnd(); ++it) {
     const std::vector<CallGraphNode *> &scc = *it;
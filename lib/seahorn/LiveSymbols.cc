@@ -9,42 +9,62 @@
 
 namespace seahorn {
 
-void LiveInfo::setLive(const ExprVector &l) {
-  m_live.assign(l.begin(), l.end());
-  boost::sort(m_live);
+bool LiveInfo::addLive(const BitVector &v) {
+  // -- check whether v is a subset of m_live
+  BitVector extra(v);
+  extra.reset(m_live);
+  if (extra.none())
+    return false;
+
+  m_live |= extra;
+  m_liveSymsValid = false;
+  return true;
 }
 
-void LiveInfo::setDefs(const ExprVector &d) {
-  m_defs.assign(d.begin(), d.end());
-  boost::sort(m_defs);
+void LiveInfo::resize(unsigned sz) {
+  m_live.resize(sz);
+  m_defs.resize(sz);
+  for (BitVector &d : m_edgeDefs)
+    d.resize(sz);
 }
 
-void LiveInfo::addEdgeDef(const ExprVector &d) {
-  m_edgeDefs.push_back(ExprVector());
-  ExprVector &defs = m_edgeDefs.back();
-  defs.assign(d.begin(), d.end());
-  boost::sort(defs);
+const ExprVector &LiveInfo::liveSymbols(const ExprVector &symbols) const {
+  if (m_liveSymsValid)
+    return m_liveSyms;
+
+  m_liveSyms.clear();
+  m_liveSyms.reserve(m_live.count());
+  for (int i = m_live.find_first(); i != -1; i = m_live.find_next(i))
+    m_liveSyms.push_back(symbols[i]);
+  boost::sort(m_liveSyms);
+  m_liveSymsValid = true;
+  return m_liveSyms;
 }
 
-void LiveInfo::addLive(ExprVector &v) {
-  if (v.size() == 0)
-    return;
-
-  boost::sort(v);
-  size_t sz = m_live.size();
-  m_live.reserve(sz + v.size());
+unsigned LiveSymbols::symbolId(Expr v) {
+  auto it = m_symbolIds.find(v);
+  if (it != m_symbolIds.end())
+    return it->second;
 
-  boost::copy(v, std::back_inserter(m_live));
-  std::inplace_merge(m_live.begin(), m_live.begin() + sz, m_live.end());
+  unsigned id = m_symbols.size();
+  m_symbols.push_back(v);
+  m_symbolIds.insert({v, id});
+  return id;
 }
 
-/// like add live but v might contain already live variables
-void LiveInfo::unionLive(ExprVector &v) {
-  boost::sort(v);
-  ExprVector newLive;
-  newLive.reserve(v.size());
-  boost::set_difference(v, m_live, std::back_inserter(newLive));
-  addLive(newLive);
+BitVector LiveSymbols::toBits(const ExprVector &vec) {
+  for (const Expr &v : vec)
+    symbolId(v);
+
+  // -- grow existing sets if new symbols were discovered
+  for (auto &kv : m_liveInfo)
+    if (kv.second.live().size() < m_symbols.size())
+      kv.second.resize(m_symbols.size());
+
+  BitVector res(m_symbols.size());
+  for (const Expr &v : vec)
+    res.set(m_symbolIds[v]);
+  return res;
 }
 
 void LiveSymbols::run() {
@@ -65,23 +85,26 @@ void LiveSymbols::run() {
 
   // -- anything that is live at entry should be live at every block
   // -- reachable from entry
-  ExprVector liveAtEntry(live(&m_f.getEntryBlock()));
-  globallyLive(liveAtEntry);
+  BitVector liveAtEntry(m_liveInfo[&m_f.getEntryBlock()].live());
+  for (auto &kv : m_liveInfo)
+    kv.second.addLive(liveAtEntry);
 }
 
 void LiveSymbols::dump() const {
   errs() << "Function: " << m_f.getName() << "\n";
   for (auto &entry : m_liveInfo)
-    errs() << entry.first->getName() << ": " << entry.second.live().size()
+    errs() << entry.first->getName() << ": " << entry.second.live().count()
            << "\n";
 }
 
 void LiveSymbols::patchArgsAndGlobals() {
   LiveInfo &li = m_liveInfo[&m_f.getEntryBlock()];
 
-  ExprVector extras;
+  BitVector extras(m_symbols.size());
 
-  for (Expr v : li.live()) {
+  const BitVector &live = li.live();
+  for (int i = live.find_first(); i != -1; i = live.find_next(i)) {
+    Expr v = m_symbols[i];
     assert(bind::isFapp(v));
     Expr u = bind::fname(bind::fname(v));
     if (!isOpX<VALUE>(u))
@@ -90,7 +113,7 @@ void LiveSymbols::patchArgsAndGlobals() {
     const Value *val = getTerm<const Value *>(u);
 
     if (isa<Argument>(val) || isa<GlobalVariable>(val))
-      extras.push_back(v);
+      extras.set(i);
   }
 
   // find block with return and make extras live there
@@ -101,11 +124,22 @@ void LiveSymbols::patchArgsAndGlobals() {
     }
 }
 
+namespace {
+/// Symbols used and defined by a basic block and on its outgoing edges
+struct LocalUseDef {
+  ExprVector uses;
+  ExprVector defs;
+  llvm::SmallVector<ExprVector, 2> edgeUses;
+  llvm::SmallVector<ExprVector, 2> edgeDefs;
+};
+} // namespace
+
 void LiveSymbols::localPass() {
   RevTopoSort(m_f, m_rtopo);
 
+  DenseMap<const BasicBlock *, LocalUseDef> local;
   for (const BasicBlock *bb : m_rtopo) {
-    LiveInfo &li = m_liveInfo[bb];
+    LocalUseDef &lud = local[bb];
 
     // // -- no live variables at any terminal basic block of the main function
     // if (llvm::succ_begin (bb) == llvm::succ_end (bb) &&
@@ -123,11 +157,11 @@ void LiveSymbols::localPass() {
         << "\n";);
 
     // -- live and defs based on what is read/written by symbolic execution
-    li.setLive(s.uses());
-    li.setDefs(s.defs());
+    lud.uses = s.uses();
+    lud.defs = s.defs();
 
-    // -- execute phi-nodes on the edges and update block's live
-    // -- symbols and edge definitions
+    // -- execute phi-nodes on the edges to find edge definitions and
+    // -- uses
     for (const llvm::BasicBlock *succ : llvm::successors(bb)) {
       SymStore ss(m_gstore, true);
       OpSemContextPtr cctx = m_sem.mkContext(ss, m_side);
@@ -140,20 +174,41 @@ void LiveSymbols::localPass() {
           for (auto i
                : ss.uses()) { errs() << *i << " "; } errs()
           << "\n";);
-      li.addEdgeDef(ss.defs());
-
-      // compute extra live variables by finding new uses at the edge
-      ExprVector uses(ss.uses().size());
-      boost::copy(ss.uses(), uses.begin());
-      boost::sort(uses);
-
-      ExprVector uses2;
-      uses2.reserve(uses.size());
-      boost::set_difference(uses, li.defs(), std::back_inserter(uses2));
-      uses.clear();
-      boost::set_difference(uses2, li.live(), std::back_inserter(uses));
-      li.addLive(uses);
+      lud.edgeDefs.push_back(ss.defs());
+      lud.edgeUses.push_back(ss.uses());
+    }
+  }
+
+  // -- number all symbols that appear in the function
+  for (auto &kv : local) {
+    LocalUseDef &lud = kv.second;
+    for (const Expr &v : lud.uses)
+      symbolId(v);
+    for (const Expr &v : lud.defs)
+      symbolId(v);
+    for (const ExprVector &vec : lud.edgeUses)
+      for (const Expr &v : vec)
+        symbolId(v);
+    for (const ExprVector &vec : lud.edgeDefs)
+      for (const Expr &v : vec)
+        symbolId(v);
+  }
+
+  for (const BasicBlock *bb : m_rtopo) {
+    LocalUseDef &lud = local[bb];
+    LiveInfo &li = m_liveInfo[bb];
+
+    BitVector live = toBits(lud.uses);
+    BitVector defs = toBits(lud.defs);
+    // -- uses on an edge that are not defined by bb are live at bb
+    for (unsigned i = 0, sz = lud.edgeUses.size(); i < sz; ++i) {
+      li.addEdgeDef(toBits(lud.edgeDefs[i]));
+      BitVector edgeUses = toBits(lud.edgeUses[i]);
+      edgeUses.reset(defs);
+      live |= edgeUses;
     }
+    li.setLive(std::move(live));
+    li.setDefs(std::move(defs));
     // -- at this point local live information for bb is computed
   }
   // -- at this point all local live information is computed for all
@@ -163,6 +218,7 @@ void LiveSymbols::localPass() {
 void LiveSymbols::globalPass() {
   // -- propagate live symbol information until nothing can be propagated
   // -- based on local live symbol information computed by initialize()
+  BitVector live(m_symbols.size());
   bool dirty;
   do {
     dirty = false;
@@ -174,23 +230,11 @@ void LiveSymbols::globalPass() {
            boost::make_iterator_range(succ_begin(src), succ_end(src))) {
         LiveInfo &dstLi = m_liveInfo[dst];
 
-        ExprVector live;
-        live.reserve(dstLi.live().size());
-
-        ExprVector live2;
-        live2.reserve(live.size());
-
-        boost::set_difference(dstLi.live(), srcLi.edge_defs(idx++),
-                              std::back_inserter(live));
-        boost::set_difference(live, srcLi.defs(), std::back_inserter(live2));
-
-        live.clear();
-        boost::set_difference(live2, srcLi.live(), std::back_inserter(live));
-
-        if (!live.empty()) {
-          dirty = true;
-          srcLi.addLive(live);
-        }
+        // -- live(src) |= live(dst) - edge_defs(src, dst) - defs(src)
+        live = dstLi.live();
+        live.reset(srcLi.edge_defs(idx++));
+        live.reset(srcLi.defs());
+        dirty |= srcLi.addLive(live);
       }
     }
   } while (dirty);
@@ -210,11 +254,12 @@ void LiveSymbols::symExecPhi(OpSemContext &ctx, const BasicBlock &bb,
 const ExprVector &LiveSymbols::live(const BasicBlock *bb) const {
   auto it = m_liveInfo.find(bb);
   assert(it != m_liveInfo.end());
-  return it->second.live();
+  return it->second.liveSymbols(m_symbols);
 }
 
 void LiveSymbols::globallyLive(ExprVector &live) {
+  BitVector bits = toBits(live);
   for (auto &kv : m_liveInfo)
-    kv.second.unionLive(live);
+    kv.second.addLive(bits);
 }
 } // namespace seahorn
@@ -768,9 +768,7 @@ solver::SolverResult PathBmcEngine::path_encoding_and_solve_with_smt(
    *****************************************************************/
   m_smt_path_solver->reset();
   // TODO: add here path_constraints to help
-  for (Expr e : path_formula) {
-    m_smt_path_solver->add(e);
-  }
+  m_smt_path_solver->add(path_formula);
 
   solver::SolverResult res;
   {
@@ -1147,9 +1145,7 @@ solver::SolverResult PathBmcEngine::solve() {
       m_unsolved_path_formulas.pop();
 
       m_smt_path_solver->reset();
-      for (Expr e : kv.second) {
-        m_smt_path_solver->add(e);
-      }
+      m_smt_path_solver->add(kv.second);
 
       unsigned timeout;
       auto it = timeout_map.find(kv.first);
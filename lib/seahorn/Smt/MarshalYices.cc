@@ -9,6 +9,10 @@
 
 #include "boost/lexical_cast.hpp"
 
+#include <map>
+#include <unordered_map>
+#include <vector>
+
 using namespace expr;
 
 namespace seahorn {
@@ -62,7 +66,13 @@ static std::string get_name(Expr e){
 }
 
 type_t marshal_yices::encode_type(Expr e){
-  
+  // -- yices types live as long as the library, so the caches are shared
+  // -- by all solvers. They are keyed on the structure of a sort, never on
+  // -- its node, since nodes die with their factory and their addresses
+  // -- are reused by later ones.
+  static std::unordered_map<unsigned, type_t> s_bv_types;
+  static std::map<std::pair<type_t, type_t>, type_t> s_fun_types;
+
   type_t res = NULL_TYPE;
   if (isOpX<INT_TY>(e))
     res = yices_int_type();
@@ -75,15 +85,24 @@ type_t marshal_yices::encode_type(Expr e){
     type_t range = encode_type(e->right());
 
     if (domain != NULL_TYPE && range != NULL_TYPE) {
+      auto it = s_fun_types.find({domain, range});
+      if (it != s_fun_types.end())
+        return it->second;
       res = yices_function_type1(domain, range);
+      if (res != NULL_TYPE)
+        s_fun_types.insert({{domain, range}, res});
     }
   } else if (isOpX<BVSORT>(e)) {
-    res = yices_bv_type(bv::width(e));
+    unsigned width = bv::width(e);
+    auto it = s_bv_types.find(width);
+    if (it != s_bv_types.end())
+      return it->second;
+    res = yices_bv_type(width);
     assert(res != NULL_TERM);
+    s_bv_types.insert({width, res});
   } else {
     encode_term_fail(e, "Unhandled sort");
   }
-
   return res;
 }
 
@@ -107,22 +126,58 @@ Expr decode_type(type_t ytau, ExprFactory &efac) {
   return etype;
 }
 
-term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
+/// true if \p e is encoded without encoding other terms first
+static bool is_leaf(Expr e) {
+  return bind::isBVar(e) || isOpX<UINT>(e) || isOpX<MPQ>(e) ||
+         isOpX<MPZ>(e) || bv::is_bvnum(e) || bind::isBoolConst(e) ||
+         bind::isIntConst(e) || bind::isRealConst(e) ||
+         op::bv::isBvConst(e) || bind::isConst<ARRAY_TY>(e) ||
+         bind::isFdecl(e) || isOpX<FORALL>(e) || isOpX<EXISTS>(e) ||
+         isOpX<LAMBDA>(e);
+}
 
-  assert(e);
+/// Adds to \p out the terms that must be encoded before \p e
+static void encode_deps(Expr e, ExprVector &out) {
+  if (is_leaf(e))
+    return;
+  if (bind::isFapp(e)) {
+    out.insert(out.end(), e->args_begin(), e->args_end());
+    return;
+  }
+  if (isOpX<BEXTRACT>(e)) {
+    out.push_back(bv::earg(e));
+    return;
+  }
+  switch (e->arity()) {
+  case 0:
+    return;
+  case 1:
+    out.push_back(e->left());
+    return;
+  case 2:
+    out.push_back(e->left());
+    // -- the second argument of an extension is a sort
+    if (!isOpX<BSEXT>(e) && !isOpX<BZEXT>(e))
+      out.push_back(e->right());
+    return;
+  default:
+    out.insert(out.end(), e->args_begin(), e->args_end());
+  }
+}
 
+/// Returns the encoding of \p e, which has already been encoded
+static term_t encoded(Expr e, const ycache_t &cache) {
   if (isOpX<TRUE>(e))
     return yices_true();
   if (isOpX<FALSE>(e))
     return yices_false();
+  auto it = cache.find(e);
+  assert(it != cache.end());
+  return it->second;
+}
 
-  /** check the cache */
-  {
-    auto it = cache.find(e);
-    if (it != cache.end())
-      return it->second;
-  }
-
+/// Encodes \p e assuming that all terms in encode_deps(e) are in \p cache
+static term_t encode_node(Expr e, const ycache_t &cache) {
   term_t res = NULL_TERM;
   if (bind::isBVar(e)) {
     encode_term_fail(e, nullptr);
@@ -158,7 +213,7 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
   } else if (bind::isConst<ARRAY_TY>(e)) {
     if (bind::isFdecl(e->left())) {
       Expr fdecl = e->left();
-      type_t var_type  = encode_type(fdecl->right());
+      type_t var_type  = marshal_yices::encode_type(fdecl->right());
       std::string sname =  get_name(fdecl);
       const char* varname = sname.c_str();
       res =  yices_new_uninterpreted_term(var_type);
@@ -176,7 +231,7 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
     uint32_t arity = e->arity();
     std::vector<type_t> domain(arity);
     for (size_t i = 0; i < bind::domainSz(e); ++i) {
-      type_t yt_i = encode_type(bind::domainTy(e, i));
+      type_t yt_i = marshal_yices::encode_type(bind::domainTy(e, i));
       if (yt_i == NULL_TYPE) {
         encode_term_fail(e, "fdecl domain encode error");
         return NULL_TERM;
@@ -184,7 +239,7 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
       domain[i] = yt_i;
     }
 
-    type_t range = encode_type(bind::rangeTy(e));
+    type_t range = marshal_yices::encode_type(bind::rangeTy(e));
     if (range == NULL_TYPE) {
       encode_term_fail(e, "fdecl range encode error");
       return NULL_TERM;
@@ -199,7 +254,7 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
   /** function application */
   else if (bind::isFapp(e)) {
     if (bind::isFdecl(bind::fname(e))) {
-      term_t yfdecl = encode_term(bind::fname(e), cache);
+      term_t yfdecl = encoded(bind::fname(e), cache);
       assert(yfdecl != NULL_TERM);
 
       uint32_t arity = e->arity() - 1;
@@ -207,7 +262,7 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
       unsigned pos = 0;
       for (auto it = ++(e->args_begin()), end = e->args_end(); it != end;
            ++it) {
-        term_t arg_i = encode_term(*it, cache);
+        term_t arg_i = encoded(*it, cache);
         assert(arg_i != NULL_TERM);
         args[pos++] = arg_i;
       }
@@ -221,11 +276,8 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
     encode_term_fail(e, nullptr);
   }
 
-  // -- cache the result for unmarshaling
-  if (res != NULL_TERM) {
-    cache[e] = res;
+  if (res != NULL_TERM)
     return res;
-  }
 
   int arity = e->arity();
 
@@ -238,7 +290,7 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
       encode_term_fail(e, "array-default term not supported in yices");
     }
     
-    term_t arg = encode_term(e->left(), cache);
+    term_t arg = encoded(e->left(), cache);
 
     if (isOpX<UN_MINUS>(e)) {
       res = yices_neg(arg);
@@ -265,10 +317,10 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
       encode_term_fail(e, "const-array term not supported in yices");
     }
       
-    term_t t1 = encode_term(e->left(), cache);
+    term_t t1 = encoded(e->left(), cache);
     term_t t2;    
     if (!isOpX<BSEXT>(e) && !isOpX<BZEXT>(e)) {    
-      t2 = encode_term(e->right(), cache);
+      t2 = encoded(e->right(), cache);
     }
     
     if (isOpX<AND>(e))
@@ -377,7 +429,7 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
       return encode_term_fail(e, "unhandle binary case");
   } else if (isOpX<BEXTRACT>(e)) {
     assert(bv::high(e) >= bv::low(e));
-    term_t b = encode_term(bv::earg(e), cache);
+    term_t b = encoded(bv::earg(e), cache);
     res = yices_bvextract(b, bv::low(e), bv::high(e));
   } else if (isOpX<AND>(e) || isOpX<OR>(e) || isOpX<ITE>(e) || isOpX<XOR>(e) ||
              isOpX<PLUS>(e) || isOpX<MINUS>(e) || isOpX<MULT>(e) ||
@@ -385,7 +437,7 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
 
     std::vector<term_t> args;
     for (auto it = e->args_begin(), end = e->args_end(); it != end; ++it) {
-      term_t yt = encode_term(*it, cache);
+      term_t yt = encoded(*it, cache);
       args.push_back(yt);
     }
 
@@ -417,10 +469,55 @@ term_t marshal_yices::encode_term(Expr e, ycache_t &cache) {
     encode_term_fail(e, yices::error_string().c_str());
   }
 
-  cache[e] = res;
   return res;
 }
 
+
+term_t marshal_yices::encode_term(Expr root, ycache_t &cache) {
+  assert(root);
+
+  if (isOpX<TRUE>(root))
+    return yices_true();
+  if (isOpX<FALSE>(root))
+    return yices_false();
+
+  /** check the cache */
+  {
+    auto it = cache.find(root);
+    if (it != cache.end())
+      return it->second;
+  }
+
+  // -- post-order traversal with an explicit stack. A node is encoded
+  // -- when it is seen for the second time, after its dependencies.
+  std::vector<std::pair<Expr, bool>> stack;
+  ExprVector deps;
+  stack.push_back({root, false});
+  while (!stack.empty()) {
+    Expr e = stack.back().first;
+    if (isOpX<TRUE>(e) || isOpX<FALSE>(e) || cache.count(e)) {
+      stack.pop_back();
+      continue;
+    }
+
+    if (!stack.back().second) {
+      stack.back().second = true;
+      deps.clear();
+      encode_deps(e, deps);
+      for (auto it = deps.rbegin(), end = deps.rend(); it != end; ++it)
+        if (!isOpX<TRUE>(*it) && !isOpX<FALSE>(*it) && !cache.count(*it))
+          stack.push_back({*it, false});
+      continue;
+    }
+
+    stack.pop_back();
+    // -- cache the result for unmarshaling
+    cache[e] = encode_node(e, cache);
+  }
+
+  return cache[root];
+}
+
 Expr marshal_yices::decode_yval(yval_t &yval, ExprFactory &efac, model_t *model,
                                 bool isArray, Expr domain, Expr range) {
   Expr res = nullptr;
@@ -80,6 +80,33 @@ bool yices_solver_impl::add(expr::Expr exp){
   return true;
 }
 
+bool yices_solver_impl::add(const ExprVector &exps){
+  std::vector<term_t> yts;
+  yts.reserve(exps.size());
+  for (Expr exp : exps) {
+    term_t yt = marshal_yices::encode_term(exp, get_cache());
+    if (yt == NULL_TERM){
+      std::string str;
+      raw_string_ostream str_os(str);
+      str_os << "yices_solver_impl::add:  failed to encode: " << *exp << "\n";
+      report_fatal_error(str_os.str());
+    }
+    yts.push_back(yt);
+  }
+  if (yts.empty())
+    return true;
+
+  int32_t errcode = yices_assert_formulas(d_ctx, yts.size(), &yts[0]);
+  if (errcode == -1){
+    std::string str;
+    raw_string_ostream str_os(str);
+    str_os << "yices_solver_impl::add:  yices_assert_formulas failed: "
+	   << yices::error_string() << "\n";
+    report_fatal_error(str_os.str());
+  }
+  return true;
+}
+
 /** Check for satisfiability */
 SolverResult yices_solver_impl::check(){
   d_last_assumptions.clear();
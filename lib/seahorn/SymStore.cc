@@ -14,16 +14,17 @@ void SymStore::swap(SymStore &o) {
 
   std::swap(m_Parent, o.m_Parent);
   std::swap(m_ownedParent, o.m_ownedParent);
-  std::swap(m_Store, o.m_Store);
+  m_Store.swap(o.m_Store);
   std::swap(m_trackUse, o.m_trackUse);
   std::swap(m_uses, o.m_uses);
   std::swap(m_defs, o.m_defs);
   std::swap(m_defs_sz, o.m_defs_sz);
+  std::swap(m_havocs, o.m_havocs);
 }
 
 void SymStore::print(llvm::raw_ostream &out) {
   out << "SYMSTORE BEGIN\n";
-  for (auto p : m_Store)
+  for (auto &p : m_Store)
     out << *p.first << ": " << *p.second << "\n";
   out << "SYMSTORE END\n";
 }
@@ -32,7 +33,7 @@ void SymStore::print(llvm::raw_ostream &out) {
 void SymStore::write(Expr key, Expr val) {
   assert(!isValue(key));
 
-  m_Store[key] = val;
+  m_Store.insert_or_assign(key, val);
   if (m_trackUse)
     m_defs.push_back(key);
 }
@@ -83,6 +84,10 @@ Expr SymStore::havoc(Expr key) {
 
       fname = variant::variant(idx, fname);
       val = bind::reapp(val ? val : key, bind::rename(fdecl, fname));
+      if (m_trackUse) {
+        m_havocs.push_back(key);
+        m_havocs.push_back(val);
+      }
     }
   }
 
@@ -135,8 +140,9 @@ const ExprVector &SymStore::defs() {
 
 namespace detail {
 VisitAction seahorn::detail::SymStoreEvalVisitor::operator()(Expr exp) const {
-  if (m_store.isDefined(exp))
-    return VisitAction::changeTo(m_store.at(exp));
+  Expr val = m_store.at(exp);
+  if (val)
+    return VisitAction::changeTo(val);
 
   else if (expr::op::bind::isFdecl(exp) || isOpX<BIND>(exp))
     return VisitAction::skipKids();
@@ -1,8 +1,15 @@
+#include "seahorn/config.h"
+
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 
 #include "seahorn/Analysis/CutPointGraph.hh"
+#include "seahorn/CardinalityEncoding.hh"
 #include "seahorn/Expr/Smt/EZ3.hh"
+#include "seahorn/Expr/Smt/Z3SolverImpl.hh"
+#ifdef WITH_YICES2
+#include "seahorn/Expr/Smt/Yices2SolverImpl.hh"
+#endif
 #include "seahorn/Support/CFG.hh"
 #include "seahorn/Support/Stats.hh"
 #include "seahorn/VCGen.hh"
@@ -15,11 +22,40 @@ static llvm::cl::opt<bool> EnforceAtMostOnePredecessor(
     llvm::cl::desc("Encode a block has at most one predecessor"),
     llvm::cl::init(false), llvm::cl::Hidden);
 
+static llvm::cl::opt<seahorn::card::Encoding> AtMostOneEncoding(
+    "horn-at-most-one-encoding",
+    llvm::cl::desc("Encoding of at-most-one predecessor constraints"),
+    llvm::cl::values(
+        clEnumValN(seahorn::card::Encoding::NAIVE, "naive",
+                   "Pairwise exclusion (quadratic)"),
+        clEnumValN(seahorn::card::Encoding::SEQ_COUNTER, "seq",
+                   "Sequential counter"),
+        clEnumValN(seahorn::card::Encoding::COMMANDER, "commander",
+                   "Commander encoding"),
+        clEnumValN(seahorn::card::Encoding::POPCOUNT, "popcount",
+                   "Bit-vector population count")),
+    llvm::cl::init(seahorn::card::Encoding::SEQ_COUNTER), llvm::cl::Hidden);
+
 static llvm::cl::opt<bool> LargeStepReduce(
     "horn-large-reduce",
     llvm::cl::desc("Reduce constraints during large-step encoding"),
     llvm::cl::init(false), llvm::cl::Hidden);
 
+static llvm::cl::opt<seahorn::solver::SolverKind> ReduceSolver(
+    "horn-large-reduce-solver",
+    llvm::cl::desc("SMT solver used to reduce large-step constraints"),
+    llvm::cl::values(clEnumValN(seahorn::solver::SolverKind::Z3, "z3",
+                                "z3 SMT solver"),
+                     clEnumValN(seahorn::solver::SolverKind::YICES2, "yices2",
+                                "Yices2 SMT solver")),
+    llvm::cl::init(seahorn::solver::SolverKind::Z3), llvm::cl::Hidden);
+
+static llvm::cl::opt<unsigned> ReduceResetEdges(
+    "horn-large-reduce-reset",
+    llvm::cl::desc("Number of edges after which the large-step reduction "
+                   "solver drops its assertions"),
+    llvm::cl::init(64), llvm::cl::Hidden);
+
 static llvm::cl::opt<bool> UseIte("horn-vcgen-use-ite",
                                   llvm::cl::desc("Use ite-terms in VC"),
                                   llvm::cl::init(false), llvm::cl::Hidden);
@@ -30,81 +66,255 @@ static llvm::cl::opt<bool>
                                 "imprecise depending on other configurations."),
                  llvm::cl::init(false), llvm::cl::Hidden);
 
+static llvm::cl::opt<bool> CacheBbSummaries(
+    "horn-vcgen-bb-cache",
+    llvm::cl::desc("Reuse symbolic summaries of basic blocks between VCs"),
+    llvm::cl::init(false), llvm::cl::Hidden);
+
 using namespace seahorn;
 namespace seahorn {
 
-void VCGen::initSmt(std::unique_ptr<EZ3> &zctx,
-                    std::unique_ptr<ZSolver<EZ3>> &smt) {
-  if (!LargeStepReduce)
-    return;
-  errs() << "\nE";
-  // XXX Consider using global EZ3
-  zctx.reset(new EZ3(m_sem.efac()));
-  smt.reset(new ZSolver<EZ3>(*zctx));
-  ZParams<EZ3> params(*zctx);
-  params.set(":smt.array.weak", true);
-  params.set(":smt.arith.ignore_int", true);
-  smt->set(params);
+VCGen::VCGen(OperationalSemantics &sem) : m_sem(sem), m_smtEdges(0) {
+  trueE = mk<TRUE>(m_sem.getExprFactory());
 }
 
-void VCGen::checkSideAtBb(unsigned &head, ExprVector &side, Expr pathCond,
-                          ZSolver<EZ3> &smt, const CpEdge &edge,
-                          const BasicBlock &bb) {
+VCGen::~VCGen() {}
+
+Expr VCGen::initSmt() {
   if (!LargeStepReduce)
-    return;
-  bind::IsConst isConst;
+    return Expr();
+
+  // -- retire the assertions of old edges once in a while. The context,
+  // -- and with it the marshal cache, is kept
+  if (m_smt && ReduceResetEdges > 0 && m_smtEdges % ReduceResetEdges == 0)
+    m_smt->reset();
+
+  if (!m_smt) {
+    errs() << "\nE";
+    Stats::count("VCGen.smt.contexts");
+    if (ReduceSolver == solver::SolverKind::YICES2) {
+#ifdef WITH_YICES2
+      m_smt.reset(new solver::yices_solver_impl(m_sem.efac()));
+#else
+      assertion_failed("Compile with YICES2_HOME option", __FILE__, __LINE__);
+#endif
+    } else {
+      auto *z3 = new solver::z3_solver_impl(m_sem.efac());
+      m_smt.reset(z3);
+      ZParams<EZ3> params(z3->get_context());
+      params.set(":smt.array.weak", true);
+      params.set(":smt.arith.ignore_int", true);
+      z3->get_solver().set(params);
+    }
+  }
 
+  return bind::boolConst(variant::variant(
+      m_smtEdges++, mkTerm<std::string>("vcgen_edge", m_sem.efac())));
+}
+
+void VCGen::assertSide(unsigned &head, ExprVector &side, Expr act) {
+  ScopedStats __st__("VCGen.smt");
+  bind::IsConst isConst;
   for (unsigned sz = side.size(); head < sz; ++head) {
-    ScopedStats __st__("VCGen.smt");
     Expr e = side[head];
     if (!bind::isFapp(e) || isConst(e))
-      smt.assertExpr(e);
+      m_smt->add(mk<IMPL>(act, e));
   }
+}
+
+void VCGen::reduceSide(unsigned &head, ExprVector &side, Expr act,
+                       const ExprVector &bbVs, const CpEdge &edge) {
+  assertSide(head, side, act);
 
   errs() << ".";
   errs().flush();
 
   TimeIt<llvm::raw_ostream &> _t_("smt-solving", errs(), 0.1);
-
   ScopedStats __st__("VCGen.smt");
-  Expr a[1] = {pathCond};
 
   LOG("pedge", std::error_code EC;
       raw_fd_ostream file("/tmp/p-edge.smt2", EC, sys::fs::F_Text); if (!EC) {
         file << "(set-info :original \"" << edge.source().bb().getName()
-             << " --> " << bb.getName() << " --> "
-             << edge.target().bb().getName() << "\")\n";
-        smt.toSmtLibAssuming(file, a);
+             << " --> " << edge.target().bb().getName() << "\")\n";
+        m_smt->to_smt_lib(file);
         file.close();
       });
 
-  auto res = smt.solveAssuming(a);
-  if (!res) {
-    errs() << "F";
-    errs().flush();
-    Stats::count("VCGen.smt.unsat");
-    smt.assertExpr(boolop::lneg(pathCond));
-    side.push_back(boolop::lneg(pathCond));
+  ExprVector assumptions = {act};
+  auto res = m_smt->check_with_assumptions(
+      llvm::make_range(assumptions.cbegin(), assumptions.cend()));
+  if (res == solver::SolverResult::UNSAT) {
+    Stats::count("VCGen.smt.last.unsat");
+    side.push_back(mk<FALSE>(m_sem.efac()));
   }
+  if (res != solver::SolverResult::SAT) {
+    m_smt->add(mk<NEG>(act));
+    return;
+  }
+
+  // -- blocks not executed by any model found so far. Each query asks for
+  // -- a model that executes one of them, so that all blocks are checked
+  // -- with at most one query more than there are models needed to cover
+  // -- the executable blocks
+  ExprVector remaining(bbVs);
+  Expr guardName = mkTerm<std::string>("vcgen_blocks", m_sem.efac());
+  for (unsigned round = 0; !remaining.empty(); ++round) {
+    auto model = m_smt->get_model();
+    ExprVector next;
+    for (Expr bbV : remaining)
+      if (!isOpX<TRUE>(model->eval(bbV, true)))
+        next.push_back(bbV);
+    remaining.swap(next);
+    if (remaining.empty())
+      break;
+
+    Expr guard = bind::boolConst(
+        variant::variant(round, variant::tag(act, guardName)));
+    m_smt->add(
+        mk<IMPL>(guard, mknary<OR>(mk<FALSE>(m_sem.efac()), remaining)));
+    assumptions = {act, guard};
+    Stats::count("VCGen.smt.queries");
+    res = m_smt->check_with_assumptions(
+        llvm::make_range(assumptions.cbegin(), assumptions.cend()));
+    m_smt->add(mk<NEG>(guard));
+
+    if (res == solver::SolverResult::UNSAT) {
+      for (Expr bbV : remaining) {
+        errs() << "F";
+        Stats::count("VCGen.smt.unsat");
+        side.push_back(boolop::lneg(bbV));
+      }
+      errs().flush();
+      break;
+    }
+    if (res != solver::SolverResult::SAT)
+      break;
+  }
+
+  m_smt->add(mk<NEG>(act));
 }
 
-void VCGen::checkSideAtEnd(unsigned &head, ExprVector &side,
-                           ZSolver<EZ3> &smt) {
-  if (!LargeStepReduce)
+namespace {
+/// \brief Returns true if executing \p bb affects only the symbolic store
+/// and the side condition. Allocation and calls to defined functions update
+/// the internal state of the semantics and are not summarized. Only
+/// declarations of verifier builtins may be called.
+bool isSummarizable(const BasicBlock &bb) {
+  for (const Instruction &inst : bb) {
+    if (isa<AllocaInst>(inst))
+      return false;
+    if (const CallInst *ci = dyn_cast<CallInst>(&inst)) {
+      const Function *fn = ci->getCalledFunction();
+      if (!fn)
+        return false;
+      if (fn->isIntrinsic())
+        continue;
+      // -- a defined function is never a verifier builtin, whatever its name
+      if (!fn->isDeclaration())
+        return false;
+      StringRef name = fn->getName();
+      if (!(name.startswith("verifier.") || name.startswith("shadow.mem") ||
+            name.startswith("sea.") || name.startswith("seahorn.") ||
+            name.startswith("__VERIFIER_") || name.startswith("nd")))
+        return false;
+    }
+  }
+  return true;
+}
+
+/// \brief Initial value of a register that is read before being written
+///
+/// Same as the value SymStore::read() creates in a store without a parent
+Expr initialValue(Expr reg) {
+  Expr fdecl = bind::fname(reg);
+  Expr fname = variant::variant(0, bind::fname(fdecl));
+  return bind::reapp(reg, bind::rename(fdecl, fname));
+}
+
+struct SubstVisitor : public std::unary_function<Expr, VisitAction> {
+  const ExprMap &m_map;
+  SubstVisitor(const ExprMap &map) : m_map(map) {}
+  VisitAction operator()(Expr exp) const {
+    auto it = m_map.find(exp);
+    if (it != m_map.end())
+      return VisitAction::changeTo(it->second);
+    if (bind::isFdecl(exp))
+      return VisitAction::skipKids();
+    return VisitAction::doKids();
+  }
+};
+} // namespace
+
+void VCGen::execBb(const BasicBlock &bb, OpSemContext &ctx) {
+  if (!CacheBbSummaries || !isSummarizable(bb)) {
+    m_sem.exec(bb, ctx);
     return;
-  bind::IsConst isConst;
-  for (unsigned sz = side.size(); head < sz; ++head) {
-    ScopedStats __st__("VCGen.smt");
-    Expr e = side[head];
-    if (!bind::isFapp(e) || isConst(e))
-      smt.assertExpr(e);
   }
 
-  ScopedStats __st__("VCGen.smt.last");
-  auto res = smt.solve();
-  if (!res) {
-    Stats::count("VCGen.smt.last.unsat");
-    side.push_back(mk<FALSE>(m_sem.efac()));
+  const BbSummary *sum = m_sem.getBbSummary(bb);
+  if (sum) {
+    Stats::count("vcgen.bbcache.hit");
+  } else {
+    Stats::count("vcgen.bbcache.miss");
+    sum = &m_sem.addBbSummary(bb, mkBbSummary(bb, ctx));
+  }
+  applyBbSummary(*sum, ctx);
+}
+
+BbSummary VCGen::mkBbSummary(const BasicBlock &bb, OpSemContext &ctx) {
+  ScopedStats __st__("vcgen.bbcache.summarize");
+  BbSummary sum;
+
+  // -- a parent-less store that tracks reads, writes, and havocs. Every
+  // -- register read before being written gets its initial value
+  SymStore store(m_sem.efac(), true /* trackUse */, true /* globalParent */);
+  ExprVector side;
+  OpSemContextPtr sctx = ctx.fork(store, side);
+
+  sum.pathCond = bind::boolConst(
+      mkTerm<std::string>("vcgen.bb.pc", m_sem.efac()));
+  sctx->setPathCond(sum.pathCond);
+  m_sem.exec(bb, *sctx);
+
+  for (const Expr &reg : store.uses()) {
+    sum.inRegs.push_back(reg);
+    sum.inVals.push_back(initialValue(reg));
+  }
+  const ExprVector &havocs = store.havocs();
+  for (unsigned i = 0, sz = havocs.size(); i < sz; i += 2) {
+    sum.freshRegs.push_back(havocs[i]);
+    sum.freshVals.push_back(havocs[i + 1]);
+  }
+  for (const Expr &reg : store.defs()) {
+    sum.outRegs.push_back(reg);
+    sum.outVals.push_back(store.at(reg));
+  }
+  sum.side = std::move(side);
+  return sum;
+}
+
+void VCGen::applyBbSummary(const BbSummary &sum, OpSemContext &ctx) {
+  ExprMap subst;
+  Expr pc = ctx.getPathCond();
+  subst[sum.pathCond] = pc;
+  // -- inputs must be read before any of them is overwritten by a havoc
+  for (unsigned i = 0, sz = sum.inRegs.size(); i < sz; ++i)
+    subst[sum.inVals[i]] = ctx.read(sum.inRegs[i]);
+  // -- fresh values of the summary are renamed apart in every instance
+  for (unsigned i = 0, sz = sum.freshRegs.size(); i < sz; ++i)
+    subst[sum.freshVals[i]] = ctx.havoc(sum.freshRegs[i]);
+
+  SubstVisitor sv(subst);
+  DagVisit<SubstVisitor> dv(sv);
+  for (unsigned i = 0, sz = sum.outRegs.size(); i < sz; ++i)
+    ctx.write(sum.outRegs[i], dv(sum.outVals[i]));
+
+  for (const Expr &e : sum.side) {
+    // -- re-simplify constraints scoped by the path condition
+    if (isOpX<IMPL>(e) && e->left() == sum.pathCond)
+      ctx.addSide(boolop::limp(pc, dv(e->right())));
+    else
+      ctx.addSide(dv(e));
   }
 }
 
@@ -117,12 +327,13 @@ void VCGen::genVcForCpEdgeLegacy(SymStore &s, const CpEdge &edge,
 void VCGen::genVcForCpEdge(OpSemContext &ctx, const CpEdge &edge) {
   const CutPoint &target = edge.target();
 
-  std::unique_ptr<EZ3> zctx(nullptr);
-  std::unique_ptr<ZSolver<EZ3>> smt(nullptr);
-  initSmt(zctx, smt);
+  // -- activation literal of the edge in the shared solver
+  Expr act = initSmt();
 
   // remember what was added since last call to smt
   unsigned head = ctx.side().size();
+  // -- blocks of the edge whose execution is checked
+  ExprVector bbVs;
 
   bool isEntry = true;
   for (const BasicBlock &bb : edge) {
@@ -132,7 +343,7 @@ void VCGen::genVcForCpEdge(OpSemContext &ctx, const CpEdge &edge) {
       bbV = ctx.havoc(m_sem.mkSymbReg(bb, ctx));
       // -- compute side-conditions for the entry block of the edge
       ctx.setPathCond(trueE);
-      m_sem.exec(bb, ctx);
+      execBb(bb, ctx);
     } else {
       // -- generate side-conditions for bb
       genVcForBasicBlockOnEdge(ctx, edge, bb);
@@ -141,18 +352,17 @@ void VCGen::genVcForCpEdge(OpSemContext &ctx, const CpEdge &edge) {
     }
     isEntry = false;
 
-    // -- check that the current side condition is consistent
-    if (smt)
-      checkSideAtBb(head, ctx.side(), bbV, *smt, edge, bb);
+    if (act)
+      bbVs.push_back(bbV);
   }
 
   // -- generate side condition for the last basic block on the edge
   // -- this executes only PHINode instructions in target.bb()
   genVcForBasicBlockOnEdge(ctx, edge, target.bb(), true);
 
-  // -- check consistency of side-conditions at the end
-  if (smt)
-    checkSideAtEnd(head, ctx.side(), *smt);
+  // -- check consistency of side-conditions and of every block at the end
+  if (act)
+    reduceSide(head, ctx.side(), act, bbVs, edge);
 }
 
 namespace sem_detail {
@@ -170,24 +380,6 @@ struct FwdReachPred : public std::unary_function<const BasicBlock &, bool> {
 };
 } // namespace sem_detail
 
-/// \brief Naive quadratic implementation of at-most-one
-static Expr mkAtMostOne(ExprVector &vec) {
-  assert(!vec.empty());
-  ExprVector res;
-  for (unsigned i = 0, e = vec.size(); i < e; ++i) {
-    ExprVector exactly_vi; // exactly  vec[i]
-    exactly_vi.push_back(vec[i]);
-    for (unsigned j = 0; j < e; ++j) {
-      if (vec[i] == vec[j])
-        continue;
-      exactly_vi.push_back(mk<NEG>(vec[j]));
-    }
-    // at this point: exactly_vi is vi && !vj for all j
-    res.push_back(op::boolop::land(exactly_vi));
-  }
-  return mknary<OR>(res);
-}
-
 namespace {
 bool hasTrackablePhiNode(const BasicBlock &bb, OperationalSemantics &sem) {
   bool hasPhi = false;
@@ -349,7 +541,8 @@ Expr computePathCondForBb(const BasicBlock &bb, const CpEdge &cpEdge,
     // this enforces at-most-one predecessor.
     // if !bbV (i.e., bb is not reachable) then bb won't have
     // predecessors.
-    ctx.addSide(mk<IMPL>(bbV, mkAtMostOne(edges)));
+    ctx.addSide(
+        mk<IMPL>(bbV, card::mkAtMostOne(edges, bbV, AtMostOneEncoding)));
   }
 
   // relate predecessors and conditions under which control flows from them
@@ -403,7 +596,7 @@ void VCGen::genVcForBasicBlockOnEdge(OpSemContext &ctx, const CpEdge &edge,
   // actions of the block. The side-conditions are not guarded by
   // the basic-block variable because it does not matter.
   if (!last) {
-    m_sem.exec(bb, ctx.pc(bbV));
+    execBb(bb, ctx.pc(bbV));
   } else if (const TerminatorInst *term = bb.getTerminator()) {
     if (isa<UnreachableInst>(term))
       m_sem.exec(bb, ctx.pc(trueE));
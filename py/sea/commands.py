@@ -349,6 +349,11 @@ class Seapp(sea.LimitedCmd):
                          "Use --devirt-function to devirtualize other calls",
                          dest='devirt_funcs_cha', default=False,
                          action='store_true')
+        ap.add_argument ('--devirt-functions-bounce',
+                         help='Dispatch in bounce functions by a chain of '
+                         'comparisons or by a single switch',
+                         choices=['chain', 'switch'], default=None,
+                         dest='devirt_bounce')
         ap.add_argument ('--lower-assert',
                          help='Replace assertions with assumptions',
                          dest='lower_assert', default=False,
@@ -439,6 +444,8 @@ class Seapp(sea.LimitedCmd):
                 argv.append ('--devirt-functions-method={0}'.format(args.devirt_funcs))
             if args.devirt_funcs_cha:
                 argv.append ('--devirt-functions-with-cha')
+            if args.devirt_bounce is not None:
+                argv.append ('--devirt-functions-bounce={0}'.format(args.devirt_bounce))
 
             if args.enable_ext_funcs:
                 argv.append ('--externalize-addr-taken-funcs')
@@ -761,6 +768,12 @@ class SimpleMemoryChecks(sea.LimitedCmd):
                          help='Check id to instrement', default=0)
         ap.add_argument ('--smc-instrument-alloc', type=int, dest='smc_instrument_alloc',
                          help='Allocation site id to instrument', default=0)
+        ap.add_argument ('--smc-batch', default=False, action='store_true',
+                         dest='smc_batch',
+                         help='Instrument all allocation sites of all checks at once. '
+                         'With --bmc=mono, the result of every site is reported')
+        ap.add_argument ('--smc-batch-report', dest='smc_batch_report', default=None,
+                         metavar='FILE', help='Write the table of sites instrumented in batch mode')
         ap.add_argument ('--sea-dsa-type-aware', default=False, action='store_true',
                          dest='smc_type_aware', help='Use type-aware SeaDsa')
 
@@ -792,6 +805,11 @@ class SimpleMemoryChecks(sea.LimitedCmd):
         if args.smc_instrument_alloc is not None:
             argv.append ('--smc-instrument-alloc={t}'.format(t=args.smc_instrument_alloc))
 
+        if args.smc_batch:
+            argv.append ('--smc-batch')
+        if args.smc_batch_report is not None:
+            argv.append ('--smc-batch-report={f}'.format(f=args.smc_batch_report))
+
         if args.log is not None:
             for l in args.log.split (':'): argv.extend (['-log', l])
         if args.dsa_log is not None:
@@ -1114,6 +1132,10 @@ class Seahorn(sea.LimitedCmd):
                          default=None, metavar='FILE')
         ap.add_argument ('--bv-cex', dest='bv_cex', help='Generate bit-precise counterexamples',
                          default=False, action='store_true')
+        ap.add_argument ('--cex-values', dest='cex_values', default=None, metavar='FILE',
+                         help='Store values of the cex harness in a binary side file')
+        ap.add_argument ('--cex-interp', dest='cex_interp', default=False, action='store_true',
+                         help='Replay the counterexample with the concrete interpreter')
         ap.add_argument ('--solve', dest='solve', action='store_true',
                          help='Solve', default=self.solve)
         ap.add_argument ('--ztrace', dest='ztrace', metavar='STR',
@@ -1219,6 +1241,10 @@ class Seahorn(sea.LimitedCmd):
             argv.append ('-horn-cex={0}'.format (args.cex))
             if args.bv_cex:
                 argv.append ('--horn-cex-bv=true')
+            if args.cex_values is not None:
+                argv.append ('--horn-cex-values={0}'.format (args.cex_values))
+            if args.cex_interp:
+                argv.append ('--horn-cex-interp')
         if args.asm_out_file is not None: argv.extend (['-oll', args.asm_out_file])
 
         argv.extend (['-horn-inter-proc',
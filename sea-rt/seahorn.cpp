@@ -1,4 +1,6 @@
 #include "seahorn/seahorn.h"
+#include "seahorn_shadow.h"
+#include "seahorn_values.h"
 #include <stdarg.h>
 #include <cstdint>
 #include <cstdio>
@@ -13,10 +15,11 @@
 extern "C" {
 
 void sealog (const char *format, ...) {
+    static const bool verbose = std::getenv("SEAHORN_RT_VERBOSE") != nullptr;
+    if (!verbose) return;
     va_list args;
     va_start(args, format);
-    if (std::getenv("SEAHORN_RT_VERBOSE"))
-        vprintf(format, args);
+    vprintf(format, args);
     va_end(args);
 }
 
@@ -50,13 +53,24 @@ get_value_int(8)
 
 get_value_helper(intptr_t, ptr_internal)
 
+/** Value tables of a harness generated with --horn-cex-values */
+seahorn_rt::ValueTables cexvalues;
+
+void *__seahorn_get_value_table(const char *path, int id) {
+  return const_cast<void *>(cexvalues.data(path, id));
+}
+
+int __seahorn_get_value_table_size(const char *path, int id) {
+  return (int)cexvalues.entry(path, id).count;
+}
+
 const int MEM_REGION_SIZE_GUESS = 4000;
 const int TYPE_GUESS = sizeof(int);
 
-std::map<intptr_t, intptr_t, std::greater<intptr_t>> absptrmap;
+seahorn_rt::ShadowRegions absptrmap;
 
-std::map<size_t, size_t, std::greater<size_t>> fatptrslot0; // (int)ptr : base
-std::map<size_t, size_t, std::greater<size_t>> fatptrslot1; // (int)ptr : size
+seahorn_rt::ShadowSlots<size_t> fatptrslot0; // (int)ptr : base
+seahorn_rt::ShadowSlots<size_t> fatptrslot1; // (int)ptr : size
 
 // 64-bit fat pointer: [8:base|8:size|48:addr]
 static uint16_t ptr_base; // 16 bit common base of stack allocated ptrs
@@ -90,22 +104,16 @@ void* __emv(void* p) {
 
     size_t sz = MEM_REGION_SIZE_GUESS * (ebits == 0 ? TYPE_GUESS : ebits);
 
-    absptrmap[absptr] = absptr + sz;
+    absptrmap.add(absptr, absptr + sz, nullptr);
 
-    sealog("[sea] returning a pointer to an abstract region [%#lx, %#lx]\n", absptr, absptrmap.at(absptr));
+    sealog("[sea] returning a pointer to an abstract region [%#lx, %#lx]\n", absptr, absptr + sz);
 
     return absptr;
   }
 
   bool is_dummy_address (void *addr) {
 
-    intptr_t ip = intptr_t (addr);
-    auto it = absptrmap.lower_bound (ip+1);
-    if (it == absptrmap.end()) return false;
-    intptr_t lb = it->first;
-    intptr_t ub = it->second;
-
-    return (ip >= lb && ip < ub);
+    return absptrmap.find (uintptr_t (addr)) != nullptr;
   }
 
   bool is_legal_address (void *addr) {
@@ -121,6 +129,14 @@ void __seahorn_mem_alloc(void* start, void* end, int64_t val, size_t sz)
 void __seahorn_mem_init (void* addr, int64_t val, size_t sz)
 {}
 
+/** Initializes memory from a table of (address, value) pairs */
+void __seahorn_mem_init_table (const char *path, int id, size_t sz) {
+  const seahorn_rt::ValueTableEntry &e = cexvalues.entry(path, id);
+  const int64_t *kv = (const int64_t*) cexvalues.data(path, id);
+  for (uint64_t i = 0; i < e.count; ++i)
+    __seahorn_mem_init ((void*) kv[2*i], kv[2*i+1], sz);
+}
+
 void __seahorn_mem_store (void *src, void *dst, size_t sz)
 {
   sealog("[sea] __seahorn_mem_store from %p to %p\n", src, dst);
@@ -219,12 +235,12 @@ void* __sea_copy_extptr_slots_fp(void *dst, void*src) {
 }
 
 void* __sea_set_extptr_slot0_hm(void* ptr, size_t base) {
-  fatptrslot0[(size_t)ptr] = (size_t)base;
+  fatptrslot0.set((uintptr_t)ptr, base);
   return ptr;
 }
 
 void* __sea_set_extptr_slot1_hm(void *ptr, size_t size) {
-  fatptrslot1[(size_t)ptr] = (size_t)size;
+  fatptrslot1.set((uintptr_t)ptr, size);
   return ptr;
 }
 
@@ -233,21 +249,26 @@ void* __sea_recover_pointer_hm(void* cooked) {
 }
 
 size_t __sea_get_extptr_slot0_hm(void *ptr) {
-  assert(fatptrslot0.count((size_t)ptr) != 0);
-  return (size_t)fatptrslot0[(size_t)ptr];
+  size_t base = 0;
+  bool found = fatptrslot0.get((uintptr_t)ptr, base);
+  assert(found);
+  return base;
 }
 
 size_t __sea_get_extptr_slot1_hm(void *ptr) {
-  assert(fatptrslot1.count((size_t)ptr) != 0);
-  return fatptrslot1[(size_t)ptr];
+  size_t size = 0;
+  bool found = fatptrslot1.get((uintptr_t)ptr, size);
+  assert(found);
+  return size;
 }
 
 void* __sea_copy_extptr_slots_hm(void *dst, void *src) {
-  assert(fatptrslot0.count((size_t)src) != 0 && fatptrslot1.count((size_t)src) != 0);
-  size_t dst_int = (size_t)dst;
-  size_t src_int = (size_t)src;
-  fatptrslot0[dst_int] = fatptrslot0[src_int];
-  fatptrslot1[dst_int] = fatptrslot1[src_int];
+  size_t base = 0, size = 0;
+  bool found = fatptrslot0.get((uintptr_t)src, base) &&
+               fatptrslot1.get((uintptr_t)src, size);
+  assert(found);
+  fatptrslot0.set((uintptr_t)dst, base);
+  fatptrslot1.set((uintptr_t)dst, size);
   return dst;
 }
 
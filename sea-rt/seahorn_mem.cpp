@@ -1,4 +1,6 @@
 #include "seahorn/seahorn.h"
+#include "seahorn_shadow.h"
+#include "seahorn_values.h"
 #include <stdarg.h>
 #include <cstdint>
 #include <cstdio>
@@ -17,10 +19,11 @@ extern "C" {
 typedef uint64_t sea_addr_t;
   
 void sealog (const char *format, ...) {
+    static const bool verbose = std::getenv("SEAHORN_RT_VERBOSE") != nullptr;
+    if (!verbose) return;
     va_list args;
     va_start(args, format);
-    if (std::getenv("SEAHORN_RT_VERBOSE"))
-        vprintf(format, args);
+    vprintf(format, args);
     va_end(args);
 }
 
@@ -54,8 +57,19 @@ get_value_int(8)
 
 get_value_helper(intptr_t, ptr_internal)
 
-std::map<intptr_t, intptr_t, std::greater<intptr_t>> absptrmap;
-std::map<intptr_t, void*> abs_to_concr_ptr_map;
+/** Value tables of a harness generated with --horn-cex-values */
+seahorn_rt::ValueTables cexvalues;
+
+void *__seahorn_get_value_table(const char *path, int id) {
+  return const_cast<void *>(cexvalues.data(path, id));
+}
+
+int __seahorn_get_value_table_size(const char *path, int id) {
+  return (int)cexvalues.entry(path, id).count;
+}
+
+// abstract region -> physical memory
+seahorn_rt::ShadowRegions absptrmap;
 
 intptr_t __seahorn_get_value_ptr(int ctr, intptr_t *g_arr, int g_arr_sz, int ebits) {
     intptr_t absptr = __seahorn_get_value_ptr_internal(ctr, g_arr, g_arr_sz);
@@ -66,27 +80,16 @@ intptr_t __seahorn_get_value_ptr(int ctr, intptr_t *g_arr, int g_arr_sz, int ebi
 /** Implementations of the memory wrapping functions */
 
 intptr_t __seahorn_get_abs_base_address (void *addr) {
-  intptr_t ip = intptr_t (addr);
-  auto it = absptrmap.lower_bound (ip+1);
-  if (it == absptrmap.end()) return false;
-  intptr_t lb = it->first;
-  intptr_t ub = it->second;
-  if (ip >= lb && ip < ub) {
-    return lb;
-  } else {
-    return 0;
-  }
+  seahorn_rt::ShadowRegion *r = absptrmap.find (uintptr_t (addr));
+  return r ? intptr_t (r->start) : 0;
 }
 
 /* Hook for gdb-like tools */  
 void* __emv(void* p) {
-  if (intptr_t ab = __seahorn_get_abs_base_address(p)) {
-    auto it = abs_to_concr_ptr_map.find((intptr_t) ab);
-    if (it != abs_to_concr_ptr_map.end()) {
-      intptr_t pb =  (intptr_t) it->second;
-      intptr_t offset = ((intptr_t) p - ab);
-      return (void*) (pb + offset);
-    }
+  if (seahorn_rt::ShadowRegion *r = absptrmap.find((uintptr_t) p)) {
+    intptr_t pb =  (intptr_t) r->concrete;
+    intptr_t offset = ((intptr_t) p - (intptr_t) r->start);
+    return (void*) (pb + offset);
   }
   printf("Address %#lx not found in the emv map\n", (intptr_t) p);
   return p;
@@ -116,8 +119,7 @@ void __seahorn_mem_alloc(void* start, void* end, int64_t val, size_t sz){
   }
   
   
-  absptrmap[startp] = endp;  
-  abs_to_concr_ptr_map[startp] = p;
+  absptrmap.add(startp, endp, p);
   sealog("\tInitialized the whole region to %#lx (%td)\n",
 	 (intptr_t) val, (intptr_t) val);
   sealog("\tMap abstract %#lx to physical %#lx\n",startp, (intptr_t) p);  
@@ -127,10 +129,10 @@ void __seahorn_mem_init (void* addr, int64_t val, size_t sz) {
   sealog("[sea] __seahorn_mem_init %p with %#lx (%td) and sz=%d\n", addr,
 	 (intptr_t) val, (intptr_t) val, sz);
   
-  if (intptr_t base_addr = __seahorn_get_abs_base_address(addr)) {
-    auto it = abs_to_concr_ptr_map.find(base_addr);
-    if (it != abs_to_concr_ptr_map.end()) {
-      void *p = it->second;
+  if (seahorn_rt::ShadowRegion *r = absptrmap.find((uintptr_t) addr)) {
+    intptr_t base_addr = r->start;
+    if (r->concrete) {
+      void *p = r->concrete;
       intptr_t offset = ((intptr_t) addr - base_addr);
       memcpy((void*)((intptr_t) p + offset), &val, sz);
       sealog("\tinitialized physical address %#lx + %#lx\n", p, offset);
@@ -145,6 +147,14 @@ void __seahorn_mem_init (void* addr, int64_t val, size_t sz) {
     }
   }
 }
+
+/** Initializes memory from a table of (address, value) pairs */
+void __seahorn_mem_init_table (const char *path, int id, size_t sz) {
+  const seahorn_rt::ValueTableEntry &e = cexvalues.entry(path, id);
+  const int64_t *kv = (const int64_t*) cexvalues.data(path, id);
+  for (uint64_t i = 0; i < e.count; ++i)
+    __seahorn_mem_init ((void*) kv[2*i], kv[2*i+1], sz);
+}
   
 void __seahorn_mem_store (void *src, void *dst, size_t sz) {
   sealog("[sea] __seahorn_mem_store from %p to %p and sz=%d\n", src, dst, sz);
@@ -152,11 +162,11 @@ void __seahorn_mem_store (void *src, void *dst, size_t sz) {
   intptr_t p_src = (intptr_t) src;
   intptr_t p_dst = (intptr_t) dst;
   
-  if(intptr_t base_src = __seahorn_get_abs_base_address(src)) {
+  if(seahorn_rt::ShadowRegion *r_src = absptrmap.find((uintptr_t) src)) {
+    intptr_t base_src = r_src->start;
     sealog("\tFound abstract address for source %p -> %#lx\n", src, base_src);
-    auto it = abs_to_concr_ptr_map.find(base_src);
-    if (it != abs_to_concr_ptr_map.end()) {
-      intptr_t conc_base_src = (intptr_t) it->second;
+    if (r_src->concrete) {
+      intptr_t conc_base_src = (intptr_t) r_src->concrete;
       intptr_t offset = ((intptr_t) src - base_src);
       p_src = conc_base_src + offset;
       sealog("\tphysical src address %#lx + %#lx = %#lx\n",
@@ -170,11 +180,11 @@ void __seahorn_mem_store (void *src, void *dst, size_t sz) {
     sealog("\tSource is already a physical address.\n");
   }
   
-  if(intptr_t base_dst = __seahorn_get_abs_base_address(dst)) {
+  if(seahorn_rt::ShadowRegion *r_dst = absptrmap.find((uintptr_t) dst)) {
+    intptr_t base_dst = r_dst->start;
     sealog("\tFound abstract address for destination %p -> %#lx\n", dst, base_dst);
-    auto it = abs_to_concr_ptr_map.find(base_dst);
-    if (it != abs_to_concr_ptr_map.end()) {
-      intptr_t conc_base_dst = (intptr_t) it->second;
+    if (r_dst->concrete) {
+      intptr_t conc_base_dst = (intptr_t) r_dst->concrete;
       intptr_t offset = ((intptr_t) dst - base_dst);
       p_dst = conc_base_dst + offset;
       sealog("\tphysical dst address %#lx + %#lx = %#lx\n",
@@ -195,11 +205,11 @@ void __seahorn_mem_load (void *dst, void *src, size_t sz) {
   intptr_t p_src = (intptr_t) src;
   intptr_t p_dst = (intptr_t) dst;
   
-  if(intptr_t base_src = __seahorn_get_abs_base_address(src)) {
+  if(seahorn_rt::ShadowRegion *r_src = absptrmap.find((uintptr_t) src)) {
+    intptr_t base_src = r_src->start;
     sealog("\tFound abstract address for source %p -> %#lx\n", src, base_src);
-    auto it = abs_to_concr_ptr_map.find(base_src);
-    if (it != abs_to_concr_ptr_map.end()) {
-      intptr_t conc_base_src = (intptr_t) it->second;
+    if (r_src->concrete) {
+      intptr_t conc_base_src = (intptr_t) r_src->concrete;
       intptr_t offset = ((intptr_t) src - base_src);
       p_src = conc_base_src + offset;
       sealog("\tphysical src address %#lx + %#lx = %#lx\n",
@@ -212,11 +222,11 @@ void __seahorn_mem_load (void *dst, void *src, size_t sz) {
     sealog("\tSource is already a physical address\n");
   }
   
-  if(intptr_t base_dst = __seahorn_get_abs_base_address(dst)) {
+  if(seahorn_rt::ShadowRegion *r_dst = absptrmap.find((uintptr_t) dst)) {
+    intptr_t base_dst = r_dst->start;
     sealog("\tFound abstract address for destination %p -> %#lx\n", dst, base_dst);
-    auto it = abs_to_concr_ptr_map.find(base_dst);
-    if (it != abs_to_concr_ptr_map.end()) {
-      intptr_t conc_base_dst = (intptr_t) it->second;
+    if (r_dst->concrete) {
+      intptr_t conc_base_dst = (intptr_t) r_dst->concrete;
       intptr_t offset = ((intptr_t) dst - base_dst);
       p_dst = conc_base_dst + offset;
       sealog("\tphysical dst address %#lx + %#lx = %#lx\n",
@@ -0,0 +1,196 @@
+#ifndef _SEAHORN_SHADOW__H_
+#define _SEAHORN_SHADOW__H_
+/**
+ * Direct-mapped shadow memory used by the run-time libraries to
+ * attach metadata to (concrete or abstract) addresses.
+ *
+ * An address is split into a page number and a page offset. Page
+ * numbers of addresses below 2^48 are mapped through a two-level
+ * directory whose levels are reserved with mmap and only backed by
+ * physical memory when touched. Pages above 2^48 (e.g., abstract
+ * addresses picked by the solver) go through an ordered map.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <vector>
+#include <sys/mman.h>
+
+namespace seahorn_rt {
+
+const unsigned SHADOW_PAGE_BITS = 12;
+const size_t SHADOW_PAGE_SIZE = size_t(1) << SHADOW_PAGE_BITS;
+const unsigned SHADOW_L2_BITS = 18;
+const unsigned SHADOW_L1_BITS = 48 - SHADOW_PAGE_BITS - SHADOW_L2_BITS;
+
+inline void *shadowReserve(size_t sz) {
+  void *p = mmap(nullptr, sz, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (p == MAP_FAILED) {
+    printf("[sea] failed to reserve %zu bytes of shadow memory\n", sz);
+    exit(1);
+  }
+  return p;
+}
+
+/// Maps page numbers to lazily allocated, zero-initialized T
+template <typename T> class ShadowTable {
+  typedef T *Leaf[size_t(1) << SHADOW_L2_BITS];
+  Leaf **m_dir = nullptr;
+  std::map<uintptr_t, T *> m_far;
+
+  static bool isFar(uintptr_t pg) {
+    return uint64_t(pg) >> (SHADOW_L1_BITS + SHADOW_L2_BITS);
+  }
+
+public:
+  ShadowTable() = default;
+  ShadowTable(const ShadowTable &) = delete;
+  ShadowTable &operator=(const ShadowTable &) = delete;
+
+  /// Returns the entry of page \p pg or null if it was never created
+  T *find(uintptr_t pg) const {
+    if (isFar(pg)) {
+      auto it = m_far.find(pg);
+      return it == m_far.end() ? nullptr : it->second;
+    }
+    if (!m_dir)
+      return nullptr;
+    Leaf *leaf = m_dir[pg >> SHADOW_L2_BITS];
+    return leaf ? (*leaf)[pg & ((size_t(1) << SHADOW_L2_BITS) - 1)] : nullptr;
+  }
+
+  /// Returns the entry of page \p pg, creating it if needed
+  T &get(uintptr_t pg) {
+    if (isFar(pg)) {
+      T *&e = m_far[pg];
+      if (!e)
+        e = new T();
+      return *e;
+    }
+    if (!m_dir)
+      m_dir = static_cast<Leaf **>(
+          shadowReserve(sizeof(Leaf *) << SHADOW_L1_BITS));
+    Leaf *&leaf = m_dir[pg >> SHADOW_L2_BITS];
+    if (!leaf)
+      leaf = static_cast<Leaf *>(shadowReserve(sizeof(Leaf)));
+    T *&e = (*leaf)[pg & ((size_t(1) << SHADOW_L2_BITS) - 1)];
+    if (!e)
+      e = new T();
+    return *e;
+  }
+};
+
+/// Per-byte metadata of a single page together with a validity bitmap
+template <typename V> struct ShadowSlotPage {
+  uint64_t valid[SHADOW_PAGE_SIZE / 64];
+  V val[SHADOW_PAGE_SIZE];
+};
+
+/// Associates a value of type V with individual addresses
+template <typename V> class ShadowSlots {
+  typedef ShadowSlotPage<V> Page;
+  ShadowTable<Page> m_pages;
+  /// one-entry cache of the last page accessed
+  uintptr_t m_lastPg = ~uintptr_t(0);
+  Page *m_last = nullptr;
+
+  Page *page(uintptr_t pg, bool create) {
+    if (pg == m_lastPg)
+      return m_last;
+    Page *p = create ? &m_pages.get(pg) : m_pages.find(pg);
+    if (p) {
+      m_lastPg = pg;
+      m_last = p;
+    }
+    return p;
+  }
+
+public:
+  void set(uintptr_t addr, V v) {
+    Page *p = page(addr >> SHADOW_PAGE_BITS, true);
+    size_t off = addr & (SHADOW_PAGE_SIZE - 1);
+    p->valid[off / 64] |= uint64_t(1) << (off % 64);
+    p->val[off] = v;
+  }
+
+  /// Returns true and stores the value of \p addr in \p v if it is set
+  bool get(uintptr_t addr, V &v) {
+    Page *p = page(addr >> SHADOW_PAGE_BITS, false);
+    if (!p)
+      return false;
+    size_t off = addr & (SHADOW_PAGE_SIZE - 1);
+    if (!(p->valid[off / 64] & (uint64_t(1) << (off % 64))))
+      return false;
+    v = p->val[off];
+    return true;
+  }
+};
+
+/// A contiguous range of abstract addresses [start, end) and the
+/// concrete memory backing it, if any
+struct ShadowRegion {
+  uintptr_t start;
+  uintptr_t end;
+  void *concrete;
+};
+
+/// Finds the region that contains an address. Every page covered by a
+/// region refers to it, so a lookup is a directory walk followed by a
+/// scan of the (usually single) region of the page.
+class ShadowRegions {
+  typedef std::vector<ShadowRegion *> Page;
+  ShadowTable<Page> m_pages;
+  std::map<uintptr_t, ShadowRegion *> m_byStart;
+
+public:
+  /// Registers [start, end). Re-registering a start updates the
+  /// existing region.
+  ShadowRegion &add(uintptr_t start, uintptr_t end, void *concrete) {
+    ShadowRegion *&r = m_byStart[start];
+    uintptr_t oldEnd = start;
+    if (!r)
+      r = new ShadowRegion{start, end, concrete};
+    else {
+      oldEnd = r->end;
+      r->end = end;
+      r->concrete = concrete;
+    }
+    if (end <= oldEnd)
+      return *r;
+
+    // -- pages already referring to r are those below oldEnd
+    uintptr_t first = start >> SHADOW_PAGE_BITS;
+    if (oldEnd > start)
+      first = ((oldEnd - 1) >> SHADOW_PAGE_BITS) + 1;
+    for (uintptr_t pg = first, last = (end - 1) >> SHADOW_PAGE_BITS;
+         pg <= last; ++pg) {
+      Page &p = m_pages.get(pg);
+      // -- keep regions of a page sorted by decreasing start
+      auto it = p.begin();
+      while (it != p.end() && (*it)->start > start)
+        ++it;
+      p.insert(it, r);
+    }
+    return *r;
+  }
+
+  /// Returns the region with the greatest start that contains \p addr
+  ShadowRegion *find(uintptr_t addr) const {
+    const Page *p = m_pages.find(addr >> SHADOW_PAGE_BITS);
+    if (!p)
+      return nullptr;
+    for (ShadowRegion *r : *p)
+      if (r->start <= addr && addr < r->end)
+        return r;
+    return nullptr;
+  }
+};
+
+} // namespace seahorn_rt
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef _SEAHORN_VALUES__H_
+#define _SEAHORN_VALUES__H_
+/**
+ * Reader for the binary side file of counterexample values written by
+ * createCexHarness when --horn-cex-values is given.
+ *
+ * Layout (host byte order):
+ *   char     magic[8]       "SEACEXV1"
+ *   uint32_t num_tables
+ *   uint32_t reserved
+ *   num_tables x { uint64_t offset; uint64_t count;
+ *                  uint32_t elem_bytes; uint32_t reserved; }
+ *   table data, each table starting at an 8-byte aligned offset
+ *
+ * The file is mapped on first use and never unmapped.
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace seahorn_rt {
+
+struct ValueTableEntry {
+  uint64_t offset;
+  uint64_t count;
+  uint32_t elem_bytes;
+  uint32_t reserved;
+};
+
+class ValueTables {
+  const char *m_base = nullptr;
+  size_t m_size = 0;
+  uint32_t m_num = 0;
+
+  void open(const char *path) {
+    if (const char *env = std::getenv("SEAHORN_CEX_VALUES"))
+      path = env;
+
+    int fd = ::open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+      printf("[sea] cannot open counterexample values %s\n", path);
+      exit(1);
+    }
+    m_size = st.st_size;
+    void *p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED || m_size < 16 || memcmp(p, "SEACEXV1", 8) != 0) {
+      printf("[sea] %s is not a counterexample values file\n", path);
+      exit(1);
+    }
+    m_base = static_cast<const char *>(p);
+    memcpy(&m_num, m_base + 8, sizeof(m_num));
+
+    // -- every table must lie within the file
+    const uint64_t tables = 16 + uint64_t(m_num) * sizeof(ValueTableEntry);
+    bool ok = tables <= m_size;
+    for (uint32_t i = 0; ok && i < m_num; ++i) {
+      const ValueTableEntry &e =
+          reinterpret_cast<const ValueTableEntry *>(m_base + 16)[i];
+      ok = e.elem_bytes > 0 && e.offset >= tables && e.offset <= m_size &&
+           e.count <= (m_size - e.offset) / e.elem_bytes;
+    }
+    if (!ok) {
+      printf("[sea] %s is a corrupt counterexample values file\n", path);
+      exit(1);
+    }
+  }
+
+public:
+  /// Returns the entry of table \p id, mapping \p path if needed
+  const ValueTableEntry &entry(const char *path, int id) {
+    if (!m_base)
+      open(path);
+    if (id < 0 || uint32_t(id) >= m_num) {
+      printf("[sea] no counterexample value table %d\n", id);
+      exit(1);
+    }
+    return reinterpret_cast<const ValueTableEntry *>(m_base + 16)[id];
+  }
+
+  const void *data(const char *path, int id) {
+    return m_base + entry(path, id).offset;
+  }
+};
+
+} // namespace seahorn_rt
+
+#endif
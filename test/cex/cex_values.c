@@ -0,0 +1,21 @@
+// RUN: %sea exe-cex -O0 --verify --bit-precise --cex-values=%t.vals "%s" 2>&1 | OutputCheck %s
+// CHECK: ^__VERIFIER_error was executed$
+
+/*
+  Values of the harness are read from a side file of value tables
+*/
+
+#include "seahorn/seahorn.h"
+
+extern int nd_int(void);
+
+int main(int argc, char **argv) {
+  int x = nd_int();
+  int y = nd_int();
+  __VERIFIER_assume(x >= 1 && x <= 10);
+  __VERIFIER_assume(y > x && y <= 10);
+  if (x + y == 7) {
+    __VERIFIER_error();
+  }
+  return 0;
+}
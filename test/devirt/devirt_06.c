@@ -0,0 +1,31 @@
+// A bounce function with many targets has a join block with high fan-in
+// RUN: %sea pf -O0 --devirt-functions --devirt-functions-bounce=chain --horn-step=large --horn-at-most-one-predecessor --horn-at-most-one-encoding=seq "%s"  2>&1 | OutputCheck %s
+// RUN: %sea pf -O0 --devirt-functions --devirt-functions-bounce=switch --horn-step=large --horn-at-most-one-predecessor --horn-at-most-one-encoding=commander "%s"  2>&1 | OutputCheck %s
+// CHECK: ^unsat$
+
+#include "seahorn/seahorn.h"
+
+extern int nd_int(void);
+
+int f0(int x) { return x + 1; }
+int f1(int x) { return x + 2; }
+int f2(int x) { return x + 3; }
+int f3(int x) { return x + 4; }
+int f4(int x) { return x + 5; }
+int f5(int x) { return x + 6; }
+int f6(int x) { return x + 7; }
+int f7(int x) { return x + 8; }
+int f8(int x) { return x + 9; }
+int f9(int x) { return x + 10; }
+int f10(int x) { return x + 11; }
+int f11(int x) { return x + 12; }
+
+int main(int argc, char **argv) {
+  int (*fns[])(int) = {f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11};
+  int i = nd_int();
+  assume(i >= 0 && i < 12);
+  assume(argc < 100);
+  int y = fns[i](argc);
+  sassert(y > argc);
+  return 0;
+}
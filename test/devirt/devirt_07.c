@@ -0,0 +1,22 @@
+// Bounce functions dispatch with a single switch, which is then lowered
+// RUN: %sea clang -O0 -o %t.bc "%s"
+// RUN: %sea pp --devirt-functions --devirt-functions-bounce=switch -S -o %t.ll %t.bc
+// RUN: OutputCheck %s < %t.ll
+// CHECK: define internal .*@seahorn.bounce
+// CHECK: LeafBlock
+// CHECK-NOT: test\.
+
+extern int nd_int(void);
+
+int fa(void) { return 1; }
+int fb(void) { return 2; }
+int fc(void) { return 3; }
+
+int main(int argc, char **argv) {
+  int (*p)(void) = fa;
+  if (nd_int())
+    p = fb;
+  else if (nd_int())
+    p = fc;
+  return p();
+}
@@ -1,6 +1,7 @@
 /* Simple inheritance but transitive closure is needed */
 
 // RUN: %sea pf -O0 --devirt-functions-with-cha "%s"  2>&1 | OutputCheck %s
+// RUN: %sea pf -O0 --devirt-functions-with-cha --devirt-functions-bounce=switch "%s"  2>&1 | OutputCheck %s
 // RUN: %sea pf -O3 --devirt-functions-with-cha "%s"  2>&1 | OutputCheck %s
 // CHECK: ^unsat$
 
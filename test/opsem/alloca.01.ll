@@ -1,5 +1,7 @@
 ; RUN: %seabmc "%s" 2>&1 | %oc %s
 ; RUN: %seabmc --horn-bv2-lambdas --log=opsem3 "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-concrete-mem-cache "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-concrete-mem-cache --sea-opsem-allocator=static "%s" 2>&1 | %oc %s
 
 ; CHECK: ^unsat$
 ; ModuleID = 'alloca.01.ll'
@@ -0,0 +1,48 @@
+; Loads through a lambda memory initialized by 10k known writes. Compare the
+; BMC solver time (--horn-stats) between the two ITE construction modes.
+; RUN: %seabmc --horn-bv2-lambdas --horn-bv2-lambda-ite=linear --horn-stats "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-lambdas --horn-bv2-lambda-ite=tree --horn-stats "%s" 2>&1 | %oc %s
+
+; CHECK: ^unsat$
+target datalayout = "e-m:e-p:32:32-f64:32:64-f80:32-n8:16:32-S128"
+target triple = "i386-unknown-linux-gnu"
+
+@tbl = internal unnamed_addr global [10000 x i32] zeroinitializer, align 4
+@llvm.used = appending global [4 x i8*] [i8* bitcast (void ()* @seahorn.fail to i8*), i8* bitcast (void (i1)* @verifier.assume to i8*), i8* bitcast (void (i1)* @verifier.assume.not to i8*), i8* bitcast (void ()* @verifier.error to i8*)], section "llvm.metadata"
+
+declare void @verifier.assume(i1)
+
+declare void @verifier.assume.not(i1)
+
+declare void @seahorn.fail()
+
+; Function Attrs: noreturn
+declare void @verifier.error() #1
+
+declare i32 @nd_uint() local_unnamed_addr
+
+; Function Attrs: nounwind
+define i32 @main() local_unnamed_addr #0 {
+entry:
+  %0 = call i32 @nd_uint()
+  %1 = icmp ult i32 %0, 10000
+  call void @verifier.assume(i1 %1)
+  %2 = getelementptr inbounds [10000 x i32], [10000 x i32]* @tbl, i32 0, i32 %0
+  %3 = load i32, i32* %2, align 4
+  %4 = call i32 @nd_uint()
+  %5 = icmp ult i32 %4, 10000
+  call void @verifier.assume(i1 %5)
+  %6 = getelementptr inbounds [10000 x i32], [10000 x i32]* @tbl, i32 0, i32 %4
+  %7 = load i32, i32* %6, align 4
+  %8 = add i32 %3, %7
+  %9 = icmp ne i32 %8, 0
+  call void @verifier.assume(i1 %9)
+  br label %verifier.error
+
+verifier.error:                                   ; preds = %entry
+  call void @seahorn.fail()
+  ret i32 42
+}
+
+attributes #0 = { nounwind }
+attributes #1 = { noreturn }
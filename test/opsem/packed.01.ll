@@ -0,0 +1,66 @@
+; Unaligned accesses to a packed struct. Compare the size of the VC and
+; solving time (--horn-stats) of byte-by-byte and wide encodings
+; RUN: %seabmc --horn-bv2-word-size=4 --horn-stats "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-word-size=4 --horn-bv2-wide-unaligned --horn-stats "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-word-size=8 --horn-bv2-wide-unaligned "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-wide-unaligned --horn-bv2-concrete-mem-cache "%s" 2>&1 | %oc %s
+
+; CHECK: ^unsat$
+target datalayout = "e-m:e-p:32:32-f64:32:64-f80:32-n8:16:32-S128"
+target triple = "i386-unknown-linux-gnu"
+
+%struct.pkt = type <{ i8, i64, i16, i32 }>
+
+@llvm.used = appending global [4 x i8*] [i8* bitcast (void ()* @seahorn.fail to i8*), i8* bitcast (void (i1)* @verifier.assume to i8*), i8* bitcast (void (i1)* @verifier.assume.not to i8*), i8* bitcast (void ()* @verifier.error to i8*)], section "llvm.metadata"
+
+declare void @verifier.assume(i1)
+
+declare void @verifier.assume.not(i1)
+
+declare void @seahorn.fail()
+
+; Function Attrs: noreturn
+declare void @verifier.error() #1
+
+declare i64 @nd_u64() local_unnamed_addr
+
+declare i32 @nd_u32() local_unnamed_addr
+
+declare i16 @nd_u16() local_unnamed_addr
+
+; Function Attrs: nounwind
+define i32 @main() local_unnamed_addr #0 {
+entry:
+  %s = alloca %struct.pkt, align 1
+  %a = call i64 @nd_u64()
+  %b = call i16 @nd_u16()
+  %c = call i32 @nd_u32()
+  %f0 = getelementptr inbounds %struct.pkt, %struct.pkt* %s, i32 0, i32 0
+  store i8 7, i8* %f0, align 1
+  %f1 = getelementptr inbounds %struct.pkt, %struct.pkt* %s, i32 0, i32 1
+  store i64 %a, i64* %f1, align 1
+  %f2 = getelementptr inbounds %struct.pkt, %struct.pkt* %s, i32 0, i32 2
+  store i16 %b, i16* %f2, align 1
+  %f3 = getelementptr inbounds %struct.pkt, %struct.pkt* %s, i32 0, i32 3
+  store i32 %c, i32* %f3, align 1
+  %v0 = load i8, i8* %f0, align 1
+  %v1 = load i64, i64* %f1, align 1
+  %v2 = load i16, i16* %f2, align 1
+  %v3 = load i32, i32* %f3, align 1
+  %e0 = icmp eq i8 %v0, 7
+  %e1 = icmp eq i64 %v1, %a
+  %e2 = icmp eq i16 %v2, %b
+  %e3 = icmp eq i32 %v3, %c
+  %a01 = and i1 %e0, %e1
+  %a23 = and i1 %e2, %e3
+  %ok = and i1 %a01, %a23
+  call void @verifier.assume.not(i1 %ok)
+  br label %verifier.error
+
+verifier.error:                                   ; preds = %entry
+  call void @seahorn.fail()
+  ret i32 42
+}
+
+attributes #0 = { nounwind }
+attributes #1 = { noreturn }
@@ -1,6 +1,7 @@
 ; Confuse pointers to the stack. Write to them. Expect no aliasing
 ; RUN: %seabmc "%s" 2>&1 | %oc %s
 ; RUN: %seabmc --horn-bv2-lambdas --log=opsem3 "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-concrete-mem-cache "%s" 2>&1 | %oc %s
 
 ; CHECK: ^unsat$
 ; ModuleID = 'ptr.01.ll'
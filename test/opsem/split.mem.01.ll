@@ -0,0 +1,59 @@
+; Global and stack accesses at known addresses do not dispatch
+; RUN: %seabmc --horn-bv2-split-mem --horn-stats "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-split-mem --horn-bv2-word-size=1 --horn-stats "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-split-mem --sea-opsem-allocator=static --horn-stats "%s" 2>&1 | %oc %s
+
+; CHECK: ^unsat$
+; CHECK: opsem.split.direct
+; CHECK-NOT: opsem.split.dispatch
+; ModuleID = 'split.mem.01.ll'
+source_filename = "split.mem.01.c"
+target datalayout = "e-m:e-p:32:32-f64:32:64-f80:32-n8:16:32-S128"
+target triple = "i386-pc-linux-gnu"
+
+@g = global i32 0, align 4
+@h = global [2 x i32] zeroinitializer, align 4
+
+declare i32 @nd() local_unnamed_addr #0
+
+declare void @verifier.assume(i1)
+declare void @verifier.assume.not(i1)
+declare void @seahorn.fail()
+
+; Function Attrs: noreturn
+declare void @verifier.error() #1
+
+declare void @use(i32*, i32*, i32*) local_unnamed_addr #0
+
+define i32 @main() local_unnamed_addr #2 {
+entry:
+  %x = alloca i32, align 4
+  %y = alloca [2 x i32], align 4
+  %y0 = getelementptr inbounds [2 x i32], [2 x i32]* %y, i32 0, i32 0
+  call void @use(i32* %x, i32* %y0, i32* @g)
+  %nd1 = call i32 @nd()
+  store i32 %nd1, i32* %x, align 4
+  store i32 %nd1, i32* @g, align 4
+  store i32 7, i32* getelementptr inbounds ([2 x i32], [2 x i32]* @h, i32 0, i32 1), align 4
+  %y1 = getelementptr inbounds [2 x i32], [2 x i32]* %y, i32 0, i32 1
+  store i32 %nd1, i32* %y1, align 4
+  %a = load i32, i32* %x, align 4
+  %b = load i32, i32* @g, align 4
+  %c = load i32, i32* getelementptr inbounds ([2 x i32], [2 x i32]* @h, i32 0, i32 1), align 4
+  %d = load i32, i32* %y1, align 4
+  %ab = icmp ne i32 %a, %b
+  %c7 = icmp ne i32 %c, 7
+  %ad = icmp ne i32 %a, %d
+  %or1 = or i1 %ab, %c7
+  %or2 = or i1 %or1, %ad
+  call void @verifier.assume(i1 %or2)
+  br label %verifier.error
+
+verifier.error:
+  call void @seahorn.fail()
+  ret i32 42
+}
+
+attributes #0 = { "correctly-rounded-divide-sqrt-fp-math"="false" "disable-tail-calls"="false" "less-precise-fpmad"="false" "no-frame-pointer-elim"="true" "no-frame-pointer-elim-non-leaf" "no-infs-fp-math"="false" "no-nans-fp-math"="false" "no-signed-zeros-fp-math"="false" "no-trapping-math"="false" "stack-protector-buffer-size"="8" "target-cpu"="pentium4" "unsafe-fp-math"="false" "use-soft-float"="false" }
+attributes #1 = { noreturn }
+attributes #2 = { nounwind "correctly-rounded-divide-sqrt-fp-math"="false" "disable-tail-calls"="false" "less-precise-fpmad"="false" "no-frame-pointer-elim"="true" "no-frame-pointer-elim-non-leaf" "no-infs-fp-math"="false" "no-nans-fp-math"="false" "no-signed-zeros-fp-math"="false" "no-trapping-math"="false" "stack-protector-buffer-size"="8" "target-cpu"="pentium4" "unsafe-fp-math"="false" "use-soft-float"="false" }
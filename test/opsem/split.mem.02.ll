@@ -0,0 +1,54 @@
+; Out-of-bounds indexing off a global and an access that straddles two
+; globals read the neighbouring global, as with the raw memory model
+; RUN: %seabmc "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-split-mem "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-split-mem --horn-bv2-word-size=1 "%s" 2>&1 | %oc %s
+; RUN: %seabmc --horn-bv2-split-mem --sea-opsem-allocator=static "%s" 2>&1 | %oc %s
+
+; CHECK: ^unsat$
+; ModuleID = 'split.mem.02.ll'
+source_filename = "split.mem.02.c"
+target datalayout = "e-m:e-p:32:32-f64:32:64-f80:32-n8:16:32-S128"
+target triple = "i386-pc-linux-gnu"
+
+@a = global [2 x i32] zeroinitializer, align 4
+@b = global [2 x i32] zeroinitializer, align 4
+
+declare i32 @nd() local_unnamed_addr #0
+
+declare void @verifier.assume(i1)
+declare void @verifier.assume.not(i1)
+declare void @seahorn.fail()
+
+; Function Attrs: noreturn
+declare void @verifier.error() #1
+
+define i32 @main() local_unnamed_addr #2 {
+entry:
+  ; a[1] = 0x05060708, b[0] = 5
+  store i32 84281096, i32* getelementptr inbounds ([2 x i32], [2 x i32]* @a, i32 0, i32 1), align 4
+  store i32 5, i32* getelementptr inbounds ([2 x i32], [2 x i32]* @b, i32 0, i32 0), align 4
+  ; a[i] with i == 2 is b[0]
+  %i = call i32 @nd()
+  %i2 = icmp eq i32 %i, 2
+  call void @verifier.assume(i1 %i2)
+  %p = getelementptr [2 x i32], [2 x i32]* @a, i32 0, i32 %i
+  %x = load i32, i32* %p, align 4
+  ; the 4 bytes at a + 6 are 06 05 05 00
+  %q = getelementptr i8, i8* bitcast ([2 x i32]* @a to i8*), i32 6
+  %qi = bitcast i8* %q to i32*
+  %y = load i32, i32* %qi, align 1
+  %x5 = icmp ne i32 %x, 5
+  %y5 = icmp ne i32 %y, 329990
+  %or = or i1 %x5, %y5
+  call void @verifier.assume(i1 %or)
+  br label %verifier.error
+
+verifier.error:
+  call void @seahorn.fail()
+  ret i32 42
+}
+
+attributes #0 = { "correctly-rounded-divide-sqrt-fp-math"="false" "disable-tail-calls"="false" "less-precise-fpmad"="false" "no-frame-pointer-elim"="true" "no-frame-pointer-elim-non-leaf" "no-infs-fp-math"="false" "no-nans-fp-math"="false" "no-signed-zeros-fp-math"="false" "no-trapping-math"="false" "stack-protector-buffer-size"="8" "target-cpu"="pentium4" "unsafe-fp-math"="false" "use-soft-float"="false" }
+attributes #1 = { noreturn }
+attributes #2 = { nounwind "correctly-rounded-divide-sqrt-fp-math"="false" "disable-tail-calls"="false" "less-precise-fpmad"="false" "no-frame-pointer-elim"="true" "no-frame-pointer-elim-non-leaf" "no-infs-fp-math"="false" "no-nans-fp-math"="false" "no-signed-zeros-fp-math"="false" "no-trapping-math"="false" "stack-protector-buffer-size"="8" "target-cpu"="pentium4" "unsafe-fp-math"="false" "use-soft-float"="false" }
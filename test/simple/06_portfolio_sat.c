@@ -0,0 +1,16 @@
+// RUN: %sea pf -O0 --horn-portfolio="spacer.weak_abs=false" --horn-portfolio="" --horn-answer "%s" 2>&1 | OutputCheck %s
+// CHECK: ^sat$
+
+#include "seahorn/seahorn.h"
+
+extern int nd();
+
+int main(void) {
+  int x = 0, y = 0;
+  while (nd()) {
+    x++;
+    y += 2;
+  }
+  sassert(x == y);
+  return 0;
+}
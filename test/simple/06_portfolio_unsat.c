@@ -0,0 +1,16 @@
+// RUN: %sea pf -O0 --horn-portfolio="spacer.weak_abs=false" --horn-portfolio="spacer.iuc=2 spacer.iuc.arith=2" --horn-portfolio="" "%s" 2>&1 | OutputCheck %s
+// CHECK: ^unsat$
+
+#include "seahorn/seahorn.h"
+
+extern int nd();
+
+int main(void) {
+  int x = 0, y = 0;
+  while (nd()) {
+    x++;
+    y++;
+  }
+  sassert(x == y);
+  return 0;
+}
@@ -0,0 +1,17 @@
+// RUN: %sea pf -O0 --horn-simplify "%s" 2>&1 | OutputCheck %s
+// CHECK: ^sat$
+
+#include "seahorn/seahorn.h"
+
+extern int nd();
+
+int main(void) {
+  int x = 0, y = 0, z = 7;
+  while (nd()) {
+    x++;
+    y += 2;
+  }
+  sassert(x == y);
+  sassert(z == 7);
+  return 0;
+}
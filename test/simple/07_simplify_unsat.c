@@ -0,0 +1,17 @@
+// RUN: %sea pf -O0 --horn-simplify "%s" 2>&1 | OutputCheck %s
+// CHECK: ^unsat$
+
+#include "seahorn/seahorn.h"
+
+extern int nd();
+
+int main(void) {
+  int x = 0, y = 0, z = 7;
+  while (nd()) {
+    x++;
+    y++;
+  }
+  sassert(x == y);
+  sassert(z == 7);
+  return 0;
+}
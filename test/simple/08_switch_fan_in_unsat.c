@@ -0,0 +1,37 @@
+// A join block with many predecessors, as produced by a lowered switch
+// RUN: %sea pf -O0 --horn-step=large --horn-at-most-one-predecessor --horn-at-most-one-encoding=naive "%s" 2>&1 | OutputCheck %s
+// RUN: %sea pf -O0 --horn-step=large --horn-at-most-one-predecessor --horn-at-most-one-encoding=seq "%s" 2>&1 | OutputCheck %s
+// RUN: %sea pf -O0 --horn-step=large --horn-at-most-one-predecessor --horn-at-most-one-encoding=commander "%s" 2>&1 | OutputCheck %s
+// RUN: %sea pf -O0 --horn-step=large --horn-at-most-one-predecessor --horn-at-most-one-encoding=popcount "%s" 2>&1 | OutputCheck %s
+// CHECK: ^unsat$
+
+#include "seahorn/seahorn.h"
+
+extern int nd(void);
+
+int main(void) {
+  int x = 0;
+  int i;
+  for (i = 0; i < 4; i++) {
+    switch (nd()) {
+    case 0: x += 1; break;
+    case 1: x += 2; break;
+    case 2: x += 3; break;
+    case 3: x += 4; break;
+    case 4: x += 5; break;
+    case 5: x += 6; break;
+    case 6: x += 7; break;
+    case 7: x += 8; break;
+    case 8: x += 9; break;
+    case 9: x += 10; break;
+    case 10: x += 11; break;
+    case 11: x += 12; break;
+    case 12: x += 13; break;
+    case 13: x += 14; break;
+    case 14: x += 15; break;
+    default: x += 16; break;
+    }
+  }
+  sassert(x >= 4 && x <= 64);
+  return 0;
+}
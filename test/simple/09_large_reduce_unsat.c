@@ -0,0 +1,24 @@
+// Blocks that cannot execute are removed from large-step constraints
+// RUN: %sea pf -O0 --horn-step=large --horn-large-reduce "%s" 2>&1 | OutputCheck %s
+// RUN: %sea pf -O0 --horn-step=large --horn-large-reduce --horn-large-reduce-reset=1 "%s" 2>&1 | OutputCheck %s
+// CHECK: ^unsat$
+
+#include "seahorn/seahorn.h"
+
+extern int nd(void);
+
+int main(void) {
+  int x = nd();
+  int y = 0;
+  assume(x > 0);
+  while (nd()) {
+    if (x < 0)
+      y = -1; // never executed
+    else if (x > 5)
+      y += 2;
+    else
+      y += 1;
+  }
+  sassert(y >= 0);
+  return 0;
+}
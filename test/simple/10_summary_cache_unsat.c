@@ -0,0 +1,29 @@
+// RUN: rm -rf %t.cache
+// RUN: %sea pf -O0 --horn-inter-proc --horn-summary-cache=%t.cache --horn-stats "%s" 2>&1 | OutputCheck %s --check-prefix=STORE
+// RUN: ls %t.cache | OutputCheck %s --check-prefix=DIR
+// RUN: %sea pf -O0 --horn-inter-proc --horn-summary-cache=%t.cache --horn-stats "%s" 2>&1 | OutputCheck %s --check-prefix=LOAD
+// STORE: ^unsat$
+// STORE: ^BRUNCH_STAT HornSummaryCacheStored [1-9]
+// DIR: \.smt2$
+// LOAD: ^unsat$
+// LOAD: ^BRUNCH_STAT HornSummaryCacheHits [1-9]
+
+#include "seahorn/seahorn.h"
+
+extern int nd();
+
+__attribute__((noinline)) int sum(int n) {
+  int s = 0;
+  for (int i = 0; i < n; i++)
+    s += 2;
+  return s;
+}
+
+int main(void) {
+  int n = nd();
+  assume(n >= 0 && n <= 1000);
+  int s = sum(n);
+  sassert(s >= 0);
+  sassert(s == 2 * n);
+  return 0;
+}
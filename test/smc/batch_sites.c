@@ -0,0 +1,43 @@
+// RUN: %sea smc --smc-batch --bmc=mono -O3 --inline --dsa=sea-cs "%s" 2>&1 | OutputCheck %s
+// CHECK: ^smc site [0-9]+: sat$
+// CHECK: ^sat$
+
+#include <stdio.h>
+#include <stdlib.h>
+
+extern int nd_int(void);
+
+typedef struct Foo {
+  int tag;
+  int x;
+} Foo;
+
+typedef struct Bar {
+  struct Foo foo;
+  int y;
+} Bar;
+
+Foo *mk_foo(int x) {
+  Foo *res = (Foo *)malloc(sizeof(struct Foo));
+  res->tag = 1;
+  res->x = x;
+  return res;
+}
+
+Bar *mk_bar(int x, int y) {
+  Bar *res = (Bar *)malloc(sizeof(struct Bar));
+  res->foo.tag = 2;
+  res->foo.x = x;
+  res->y = y;
+  return res;
+}
+
+int main(void) {
+  Foo *f = mk_foo(2);
+  Bar *b = mk_bar(3, 4);
+  // -- reading y of a Foo is out of bounds
+  Foo *v = nd_int() ? f : (Foo *)b;
+  Bar *vb = (Bar *)v;
+  printf("x=%d, y=%d\n", v->x, vb->y);
+  return 0;
+}
@@ -1,4 +1,5 @@
 // RUN: %sea smc -O3 --inline --dsa=sea-cs "%s" 2>&1 | OutputCheck %s
+// RUN: %sea smc --smc-batch -O3 --inline --dsa=sea-cs "%s" 2>&1 | OutputCheck %s
 // CHECK: ^unsat$
 
 #include <stdio.h>
@@ -23,6 +23,7 @@
 
 #include "seahorn/HornCex.hh"
 #include "seahorn/HornSolver.hh"
+#include "seahorn/HornSummaryCache.hh"
 #include "seahorn/HornWrite.hh"
 #include "seahorn/HornifyModule.hh"
 #include "seahorn/Houdini.hh"
@@ -209,6 +210,7 @@ int main(int argc, char **argv) {
   llvm::cl::AddExtraVersionPrinter(print_seahorn_version);
   llvm::cl::ParseCommandLineOptions(
       argc, argv, "SeaHorn -- LLVM bitcode to Horn/SMT2 transformation\n");
+  seahorn::setHornSummaryCacheOptions(argc, argv);
 
   llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
   llvm::PrettyStackTraceProgram PSTP(argc, argv);
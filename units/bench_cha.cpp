@@ -0,0 +1,58 @@
+/**
+ * Times the class hierarchy closure of ClassHierarchyAnalysis on a
+ * synthetic hierarchy. Usage: bench_cha [num_classes]
+ */
+#include "seahorn/Analysis/ClassHierarchyAnalysis.hh"
+
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace seahorn;
+
+int main(int argc, char **argv) {
+  const unsigned num_classes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 20000;
+  const unsigned max_bases = 2;
+
+  // -- every class derives from up to max_bases earlier classes. A base
+  // -- class is modelled as a struct field of the derived class
+  LLVMContext ctx;
+  Module m("cha", ctx);
+  std::mt19937 gen(7);
+  std::vector<StructType *> classes;
+  for (unsigned i = 0; i < num_classes; ++i) {
+    StructType *st = StructType::create(ctx, "class.C" + std::to_string(i));
+    std::vector<Type *> fields;
+    if (i > 0) {
+      std::uniform_int_distribution<unsigned> num_bases(1, max_bases);
+      std::uniform_int_distribution<unsigned> base(0, i - 1);
+      for (unsigned b = 0, e = num_bases(gen); b < e; ++b)
+        fields.push_back(classes[base(gen)]);
+    }
+    fields.push_back(Type::getInt32Ty(ctx));
+    st->setBody(fields);
+    new GlobalVariable(m, st, false, GlobalValue::ExternalLinkage, nullptr,
+                       "g." + st->getName().str());
+    classes.push_back(st);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  ClassHierarchyAnalysis cha(m);
+  cha.calculate();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  outs() << "CHA closure of " << num_classes << " classes took "
+         << elapsed.count() << "s\n";
+  cha.printStats(outs());
+  return 0;
+}
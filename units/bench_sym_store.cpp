@@ -0,0 +1,48 @@
+/**
+ * Times snapshots of a SymStore taken the way BmcEngine::encode() takes
+ * them: a few writes per cut-point, followed by a copy of the store.
+ * Usage: bench_sym_store [num_cutpoints]
+ */
+#include "seahorn/SymStore.hh"
+
+#include "seahorn/Expr/ExprOpBinder.hh"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace seahorn;
+
+int main(int argc, char **argv) {
+  const unsigned num_regs = 20000;
+  const unsigned num_cps = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2000;
+  const unsigned writes_per_cp = 10;
+
+  ExprFactory efac;
+  std::vector<Expr> regs;
+  for (unsigned i = 0; i < num_regs; ++i)
+    regs.push_back(
+        bind::intConst(mkTerm<std::string>("r" + std::to_string(i), efac)));
+
+  SymStore s(efac);
+  for (Expr r : regs)
+    s.read(r);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<SymStore> states;
+  for (unsigned cp = 0; cp < num_cps; ++cp) {
+    for (unsigned i = 0; i < writes_per_cp; ++i)
+      s.havoc(regs[(cp * writes_per_cp + i) % num_regs]);
+    states.push_back(s);
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  llvm::outs() << num_cps << " snapshots of a store with "
+               << states.back().size() << " registers took "
+               << elapsed.count() << "s\n";
+  return 0;
+}
@@ -0,0 +1,68 @@
+/**==-- Cardinality Encoding Tests --==*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "seahorn/CardinalityEncoding.hh"
+#include "seahorn/Expr/Expr.hh"
+#include "seahorn/Expr/ExprOpBinder.hh"
+#include "seahorn/Expr/Smt/EZ3.hh"
+
+#include "boost/logic/tribool.hpp"
+
+using namespace expr;
+using namespace seahorn;
+
+namespace {
+/// Checks \p enc against every assignment of \p n literals
+void checkAtMostK(unsigned n, unsigned k, card::Encoding enc) {
+  ExprFactory efac;
+  EZ3 z3(efac);
+
+  ExprVector lits;
+  for (unsigned i = 0; i < n; ++i)
+    lits.push_back(bind::boolConst(
+        variant::variant(i, mkTerm<std::string>("p", efac))));
+  Expr name = mkTerm<std::string>("amo", efac);
+  Expr amo = k == 1 ? card::mkAtMostOne(lits, name, enc)
+                    : card::mkAtMostK(lits, k, name, enc);
+
+  for (unsigned m = 0; m < (1u << n); ++m) {
+    ExprVector assign;
+    unsigned count = 0;
+    for (unsigned i = 0; i < n; ++i)
+      if (m & (1u << i)) {
+        assign.push_back(lits[i]);
+        ++count;
+      } else
+        assign.push_back(mk<NEG>(lits[i]));
+    boost::tribool res =
+        z3_is_sat(z3, mk<AND>(amo, op::boolop::land(assign)));
+    CHECK(static_cast<bool>(res == (count <= k)));
+  }
+}
+} // namespace
+
+TEST_CASE("card.at_most_one") {
+  for (auto enc : {card::Encoding::NAIVE, card::Encoding::SEQ_COUNTER,
+                   card::Encoding::COMMANDER, card::Encoding::POPCOUNT})
+    for (unsigned n : {1, 2, 3, 7, 10})
+      checkAtMostK(n, 1, enc);
+}
+
+TEST_CASE("card.at_most_k") {
+  for (auto enc : {card::Encoding::SEQ_COUNTER, card::Encoding::POPCOUNT})
+    for (unsigned n : {1, 4, 7})
+      for (unsigned k : {0, 2, 3, 7})
+        checkAtMostK(n, k, enc);
+}
+
+TEST_CASE("card.duplicates") {
+  ExprFactory efac;
+  EZ3 z3(efac);
+  Expr p = bind::boolConst(mkTerm<std::string>("p", efac));
+  Expr q = bind::boolConst(mkTerm<std::string>("q", efac));
+  Expr name = mkTerm<std::string>("amo", efac);
+  Expr amo = card::mkAtMostOne({p, q, p}, name, card::Encoding::NAIVE);
+  boost::tribool res = z3_is_sat(z3, mk<AND>(amo, p));
+  CHECK(static_cast<bool>(res));
+}
@@ -0,0 +1,199 @@
+/**==-- Concrete Counterexample Interpreter Tests --==*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "seahorn/CexInterpreter.hh"
+
+#include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+using namespace llvm;
+using namespace seahorn;
+using Status = CexInterpreter::Status;
+
+static const char *sumIR = R"IR(
+target datalayout = "e-m:e-p:32:32-i64:64-n8:16:32-S128"
+target triple = "i386-pc-linux-gnu"
+
+@g = global i32 0
+@gp = global i32* @g
+
+declare i32 @nd()
+declare void @verifier.error()
+
+define i32 @main() {
+entry:
+  br label %loop
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i1, %body ]
+  %s = phi i32 [ 0, %entry ], [ %s1, %body ]
+  %c = icmp slt i32 %i, 3
+  br i1 %c, label %body, label %exit
+body:
+  %v = call i32 @nd()
+  %s1 = add i32 %s, %v
+  %i1 = add i32 %i, 1
+  br label %loop
+exit:
+  %p = load i32*, i32** @gp
+  store i32 %s, i32* %p
+  %x = load i32, i32* @g
+  %e = icmp sgt i32 %x, 10
+  br i1 %e, label %err, label %ok
+err:
+  call void @verifier.error()
+  unreachable
+ok:
+  ret i32 0
+}
+)IR";
+
+static const char *memIR = R"IR(
+target datalayout = "e-m:e-p:32:32-i64:64-n8:16:32-S128"
+target triple = "i386-pc-linux-gnu"
+
+%struct.S = type { i8, i32, [4 x i16] }
+
+declare void @verifier.assume(i1)
+declare void @verifier.error()
+declare void @llvm.memcpy.p0i8.p0i8.i32(i8*, i8*, i32, i32, i1)
+
+define void @main() {
+entry:
+  %a = alloca %struct.S
+  %b = alloca %struct.S
+  %f = getelementptr %struct.S, %struct.S* %a, i32 0, i32 2, i32 IDX
+  store i16 -7, i16* %f
+  %pa = bitcast %struct.S* %a to i8*
+  %pb = bitcast %struct.S* %b to i8*
+  call void @llvm.memcpy.p0i8.p0i8.i32(i8* %pb, i8* %pa, i32 16, i32 4, i1 false)
+  %g = getelementptr %struct.S, %struct.S* %b, i32 0, i32 2, i32 3
+  %v = load i16, i16* %g
+  %w = sext i16 %v to i32
+  %c = icmp eq i32 %w, -7
+  call void @verifier.assume(i1 %c)
+  call void @verifier.error()
+  unreachable
+}
+)IR";
+
+static const char *layoutIR = R"IR(
+target datalayout = "e-m:e-p:32:32-i64:64-n8:16:32-S128"
+target triple = "i386-pc-linux-gnu"
+
+declare void @verifier.error()
+
+@gp = global i32* null
+@fp = global void ()* @f
+
+define void @f() {
+  ret void
+}
+
+define void ()* @keep() {
+  ret void ()* @verifier.error
+}
+
+define void @main() {
+entry:
+  %f = load void ()*, void ()** @fp
+  %a = ptrtoint void ()* %f to i32
+  %g = ptrtoint void ()** @fp to i32
+  %c1 = icmp eq i32 %a, 134512640
+  %c2 = icmp eq i32 %g, 134512648
+  %c = and i1 %c1, %c2
+  br i1 %c, label %err, label %ok
+err:
+  call void @verifier.error()
+  unreachable
+ok:
+  ret void
+}
+)IR";
+
+static std::unique_ptr<Module> parse(LLVMContext &ctx, const std::string &ir) {
+  SMDiagnostic err;
+  std::unique_ptr<Module> m = parseAssemblyString(ir, err, ctx);
+  if (!m) {
+    err.print("units_cex_interp", errs());
+    report_fatal_error("cannot parse test module");
+  }
+  return m;
+}
+
+/// Runs main of \p m with \p vals as return values of @nd
+static CexInterpreter::Result
+runMain(Module &m, std::vector<int> vals,
+        std::vector<const char *> path = std::vector<const char *>()) {
+  TargetLibraryInfoImpl tlii(Triple(m.getTargetTriple()));
+  TargetLibraryInfo tli(tlii);
+  CexInterpreter interp(m, m.getDataLayout(), tli);
+
+  if (const Function *nd = m.getFunction("nd"))
+    for (int v : vals)
+      interp.addValue(*nd, APInt(32, v, true));
+
+  Function &main = *m.getFunction("main");
+  std::vector<const BasicBlock *> bbs;
+  for (const char *name : path)
+    for (const BasicBlock &bb : main)
+      if (bb.getName() == name)
+        bbs.push_back(&bb);
+  interp.setPath(bbs);
+
+  CexInterpreter::Result res = interp.run(main);
+  return res;
+}
+
+static std::string withIdx(const char *ir, const char *idx) {
+  std::string s(ir);
+  s.replace(s.find("IDX"), 3, idx);
+  return s;
+}
+
+TEST_CASE("cex_interp.nondet") {
+  LLVMContext ctx;
+  auto m = parse(ctx, sumIR);
+
+  CHECK(runMain(*m, {4, 5, 6}).status == Status::Error);
+  CHECK(runMain(*m, {1, 2, 3}).status == Status::Exit);
+  // -- the trace has fewer values than the execution needs
+  CHECK(runMain(*m, {4, 5}).status == Status::Diverged);
+}
+
+TEST_CASE("cex_interp.path") {
+  LLVMContext ctx;
+  auto m = parse(ctx, sumIR);
+
+  std::vector<const char *> path = {"entry", "loop", "body", "loop", "body",
+                                    "loop",  "body", "loop", "exit", "err"};
+  CHECK(runMain(*m, {4, 5, 6}, path).status == Status::Error);
+  // -- the values take the execution to ok instead of err
+  CHECK(runMain(*m, {1, 2, 3}, path).status == Status::Diverged);
+}
+
+TEST_CASE("cex_interp.memory") {
+  LLVMContext ctx;
+
+  CHECK(runMain(*parse(ctx, withIdx(memIR, "3")), {}).status == Status::Error);
+  // -- the copied field is not the one that was written
+  CHECK(runMain(*parse(ctx, withIdx(memIR, "2")), {}).status ==
+        Status::AssumeViolated);
+  // -- out of the bounds of %a
+  CHECK(runMain(*parse(ctx, withIdx(memIR, "4")), {}).status == Status::Fault);
+}
+
+TEST_CASE("cex_interp.layout") {
+  LLVMContext ctx;
+  // -- as in the static allocator, verifier.error has no address and @f is
+  // -- first in the text segment; @gp and @fp follow, word aligned
+  CHECK(runMain(*parse(ctx, layoutIR), {}).status == Status::Error);
+}
@@ -0,0 +1,139 @@
+/**==-- Class Hierarchy Analysis Tests --==*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "seahorn/Analysis/ClassHierarchyAnalysis.hh"
+
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+
+using namespace llvm;
+using namespace seahorn;
+
+using succ_map_t = std::map<std::string, std::set<std::string>>;
+
+/// Makes \p st visible to Module::getIdentifiedStructTypes
+static void anchor(Module &m, StructType *st) {
+  new GlobalVariable(m, st, false, GlobalValue::ExternalLinkage, nullptr,
+                     "g." + st->getName().str());
+}
+
+/// Parses the output of ClassHierarchyAnalysis::printClassHierarchy
+static succ_map_t parseClassHierarchy(const ClassHierarchyAnalysis &cha) {
+  std::string str;
+  raw_string_ostream o(str);
+  cha.printClassHierarchy(o);
+  o.flush();
+
+  succ_map_t res;
+  std::istringstream in(str);
+  std::string line;
+  while (std::getline(in, line)) {
+    auto arrow = line.find(" --> {");
+    if (arrow == std::string::npos)
+      continue;
+    std::set<std::string> &succs = res[line.substr(0, arrow)];
+    std::string elems = line.substr(arrow + 6, line.size() - arrow - 7);
+    std::istringstream es(elems);
+    std::string e;
+    while (std::getline(es, e, ','))
+      if (!e.empty())
+        succs.insert(e);
+  }
+  return res;
+}
+
+/// Creates a synthetic class hierarchy with \p n classes in which
+/// every class derives from up to \p max_bases earlier classes. A
+/// base class is modelled as a struct field of the derived class.
+static std::vector<StructType *> mkHierarchy(Module &m, unsigned n,
+                                             unsigned max_bases,
+                                             unsigned seed) {
+  LLVMContext &ctx = m.getContext();
+  std::mt19937 gen(seed);
+  std::vector<StructType *> classes;
+  classes.reserve(n);
+  for (unsigned i = 0; i < n; ++i) {
+    StructType *st = StructType::create(ctx, "class.C" + std::to_string(i));
+    std::vector<Type *> fields;
+    if (i > 0) {
+      std::uniform_int_distribution<unsigned> num_bases(1, max_bases);
+      std::uniform_int_distribution<unsigned> base(0, i - 1);
+      for (unsigned b = 0, e = num_bases(gen); b < e; ++b)
+        fields.push_back(classes[base(gen)]);
+    }
+    fields.push_back(Type::getInt32Ty(ctx));
+    st->setBody(fields);
+    anchor(m, st);
+    classes.push_back(st);
+  }
+  return classes;
+}
+
+/// Reference closure by depth-first search from every node
+static succ_map_t naiveClosure(const std::vector<StructType *> &classes) {
+  std::map<std::string, std::set<std::string>> edges;
+  for (StructType *st : classes) {
+    edges[st->getName().str()];
+    for (Type *sub : st->subtypes())
+      if (auto *sub_st = dyn_cast<StructType>(sub))
+        edges[sub_st->getName().str()].insert(st->getName().str());
+  }
+
+  succ_map_t res;
+  for (auto &kv : edges) {
+    std::set<std::string> &reach = res[kv.first];
+    std::vector<std::string> todo(kv.second.begin(), kv.second.end());
+    while (!todo.empty()) {
+      std::string n = todo.back();
+      todo.pop_back();
+      if (!reach.insert(n).second)
+        continue;
+      for (auto &s : edges[n])
+        todo.push_back(s);
+    }
+  }
+  return res;
+}
+
+TEST_CASE("cha.closure.diamond") {
+  LLVMContext ctx;
+  Module m("cha", ctx);
+  Type *i32 = Type::getInt32Ty(ctx);
+
+  StructType *a = StructType::create(ctx, {i32}, "class.A");
+  StructType *b = StructType::create(ctx, {a, i32}, "class.B");
+  StructType *c = StructType::create(ctx, {a, i32}, "class.C");
+  StructType *d = StructType::create(ctx, {b, c}, "class.D");
+  for (StructType *st : {a, b, c, d})
+    anchor(m, st);
+
+  ClassHierarchyAnalysis cha(m);
+  cha.calculate();
+  succ_map_t succs = parseClassHierarchy(cha);
+
+  CHECK(succs["class.A"] ==
+        std::set<std::string>({"class.B", "class.C", "class.D"}));
+  CHECK(succs["class.B"] == std::set<std::string>({"class.D"}));
+  CHECK(succs["class.C"] == std::set<std::string>({"class.D"}));
+  CHECK(succs["class.D"].empty());
+}
+
+TEST_CASE("cha.closure.random") {
+  LLVMContext ctx;
+  Module m("cha", ctx);
+  auto classes = mkHierarchy(m, 300, 3, 42);
+
+  ClassHierarchyAnalysis cha(m);
+  cha.calculate();
+  CHECK(parseClassHierarchy(cha) == naiveClosure(classes));
+}
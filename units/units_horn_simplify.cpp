@@ -0,0 +1,210 @@
+/**==-- Horn Clause Simplification Tests --==*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "seahorn/Expr/Expr.hh"
+#include "seahorn/Expr/ExprOpBinder.hh"
+#include "seahorn/Expr/Smt/EZ3.hh"
+#include "seahorn/HornClauseDB.hh"
+#include "seahorn/HornDbModel.hh"
+#include "seahorn/HornSimplify.hh"
+
+#include "boost/logic/tribool.hpp"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace expr;
+using namespace seahorn;
+
+namespace {
+struct Vocabulary {
+  ExprFactory &efac;
+  Expr intTy, boolTy;
+  Expr x, y, x1;
+  Expr P0, P1, L, U, D, Err;
+
+  Expr rel(const std::string &name, ExprVector sig) {
+    sig.push_back(boolTy);
+    return bind::fdecl(mkTerm<std::string>(name, efac), sig);
+  }
+  Expr num(unsigned n) { return mkTerm<expr::mpz_class>(n, efac); }
+
+  Vocabulary(ExprFactory &e)
+      : efac(e), intTy(mk<INT_TY>(e)), boolTy(mk<BOOL_TY>(e)) {
+    x = bind::intConst(mkTerm<std::string>("x", efac));
+    y = bind::intConst(mkTerm<std::string>("y", efac));
+    x1 = bind::intConst(mkTerm<std::string>("x1", efac));
+    P0 = rel("P0", {intTy});
+    P1 = rel("P1", {intTy, intTy});
+    L = rel("L", {intTy, intTy});
+    U = rel("U", {intTy});
+    D = rel("D", {intTy});
+    Err = rel("Err", {});
+  }
+};
+
+/// A loop that counts x from 0 to 10, while y stays 5. The error is
+/// reached if x goes past \p bound. U is outside the cone of the query,
+/// and D is never derived.
+void mkLoop(Vocabulary &v, HornClauseDB &db, unsigned bound) {
+  for (Expr r : {v.P0, v.P1, v.L, v.U, v.D, v.Err})
+    db.registerRelation(r);
+  ExprVector vars = {v.x, v.y, v.x1};
+
+  db.addRule(vars, mk<IMPL>(mk<EQ>(v.x, v.num(0)), bind::fapp(v.P0, v.x)));
+  db.addRule(vars, mk<IMPL>(mk<AND>(bind::fapp(v.P0, v.x),
+                                    mk<EQ>(v.y, v.num(5))),
+                            bind::fapp(v.P1, v.x, v.y)));
+  db.addRule(vars, mk<IMPL>(bind::fapp(v.P1, v.x, v.y),
+                            bind::fapp(v.L, v.x, v.y)));
+  db.addRule(vars,
+             mk<IMPL>(mk<AND>(bind::fapp(v.L, v.x, v.y),
+                              mk<LT>(v.x, v.num(10)),
+                              mk<EQ>(v.x1, mk<PLUS>(v.x, v.num(1)))),
+                      bind::fapp(v.L, v.x1, v.y)));
+  db.addRule(vars, mk<IMPL>(mk<AND>(bind::fapp(v.L, v.x, v.y),
+                                    mk<GT>(v.x, v.num(bound)),
+                                    mk<EQ>(v.y, v.num(5))),
+                            bind::fapp(v.Err)));
+  db.addRule(vars, mk<IMPL>(mk<EQ>(v.x, v.num(1)), bind::fapp(v.U, v.x)));
+  db.addRule(vars, mk<IMPL>(bind::fapp(v.D, v.x), bind::fapp(v.D, v.x)));
+  db.addRule(vars, mk<IMPL>(bind::fapp(v.D, v.x), bind::fapp(v.Err)));
+  db.addQuery(bind::fapp(v.Err));
+}
+
+void loadFixedPoint(HornClauseDB &db, ZFixedPoint<EZ3> &fp, EZ3 &z3) {
+  ZParams<EZ3> params(z3);
+  params.set(":engine", "spacer");
+  params.set(":xform.slice", false);
+  params.set(":xform.inline-linear", false);
+  params.set(":xform.inline-eager", false);
+  fp.set(params);
+  db.loadZFixedPoint(fp, false);
+}
+
+/// true if \p model satisfies every rule of \p db
+bool isModel(HornClauseDB &db, HornDbModel &model, EZ3 &z3) {
+  for (const HornRule &r : db.getRules()) {
+    ExprVector apps;
+    get_all_pred_apps(r.get(), db, std::back_inserter(apps));
+    ExprMap sub;
+    for (Expr app : apps)
+      sub[app] = model.getDef(app);
+    Expr body = replace(r.body(), sub);
+    Expr head = replace(r.head(), sub);
+    if (z3_is_sat(z3, mk<AND>(body, mk<NEG>(head))) != false) {
+      llvm::errs() << "not a model of " << *r.get() << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+TEST_CASE("horn_simplify.model") {
+  ExprFactory efac;
+  Vocabulary v(efac);
+  EZ3 z3(efac);
+
+  HornClauseDB db(efac);
+  mkLoop(v, db, 10);
+
+  HornClauseDB sdb(efac);
+  HornSimplifyModelConverter mc(z3);
+  HornSimplifyStats stats = simplifyHornClauseDB(db, sdb, mc);
+
+  CHECK(stats.m_rulesAfter < stats.m_rulesBefore);
+  CHECK(stats.m_argsAfter < stats.m_argsBefore);
+  CHECK(!sdb.hasRelation(v.U));
+  CHECK(!sdb.hasRelation(v.D));
+
+  ZFixedPoint<EZ3> fp(z3);
+  loadFixedPoint(sdb, fp, z3);
+  boost::tribool res = fp.query();
+  CHECK(static_cast<bool>(!res));
+
+  HornDbModel smodel, model;
+  initDBModelFromFP(smodel, sdb, fp);
+  CHECK(mc.convert(smodel, model));
+  CHECK(isModel(db, model, z3));
+}
+
+TEST_CASE("horn_simplify.cex") {
+  ExprFactory efac;
+  Vocabulary v(efac);
+  EZ3 z3(efac);
+
+  HornClauseDB db(efac);
+  mkLoop(v, db, 9);
+
+  HornClauseDB sdb(efac);
+  HornSimplifyModelConverter mc(z3);
+  simplifyHornClauseDB(db, sdb, mc);
+
+  ZFixedPoint<EZ3> fp(z3);
+  loadFixedPoint(sdb, fp, z3);
+  boost::tribool res = fp.query();
+  CHECK(static_cast<bool>(res));
+
+  ExprVector srules, rules;
+  fp.getCexRules(srules);
+  CHECK(mc.convertCex(srules, rules));
+  CHECK(rules.size() >= srules.size());
+  for (Expr r : rules) {
+    Expr head = isOpX<IMPL>(r) ? r->arg(1) : r;
+    CHECK(db.hasRelation(bind::fname(head)));
+  }
+}
+
+TEST_CASE("horn_simplify.prune") {
+  ExprFactory efac;
+  Vocabulary v(efac);
+  EZ3 z3(efac);
+
+  // -- a memory that is only passed along, and a counter z that always
+  // -- equals x
+  Expr arrTy = mk<ARRAY_TY>(v.intTy, v.intTy);
+  Expr m = bind::mkConst(mkTerm<std::string>("m", efac), arrTy);
+  Expr z = bind::intConst(mkTerm<std::string>("z", efac));
+  Expr z1 = bind::intConst(mkTerm<std::string>("z1", efac));
+  Expr Init = v.rel("Init", {v.intTy, arrTy, v.intTy});
+  Expr Loop = v.rel("Loop", {v.intTy, arrTy, v.intTy});
+
+  HornClauseDB db(efac);
+  for (Expr r : {Init, Loop, v.Err})
+    db.registerRelation(r);
+  ExprVector vars = {v.x, v.x1, m, z, z1};
+  db.addRule(vars, mk<IMPL>(mk<AND>(mk<EQ>(v.x, v.num(0)),
+                                    mk<EQ>(z, v.num(0))),
+                            bind::fapp(Init, v.x, m, z)));
+  db.addRule(vars, mk<IMPL>(bind::fapp(Init, v.x, m, z),
+                            bind::fapp(Loop, v.x, m, z)));
+  db.addRule(vars,
+             mk<IMPL>(mk<AND>(bind::fapp(Loop, v.x, m, z),
+                              mk<LT>(v.x, v.num(10)),
+                              mk<AND>(mk<EQ>(v.x1, mk<PLUS>(v.x, v.num(1))),
+                                      mk<EQ>(z1, mk<PLUS>(z, v.num(1))))),
+                      bind::fapp(Loop, v.x1, m, z1)));
+  db.addRule(vars, mk<IMPL>(mk<AND>(bind::fapp(Loop, v.x, m, z),
+                                    mk<GT>(z, v.num(10))),
+                            bind::fapp(v.Err)));
+  db.addQuery(bind::fapp(v.Err));
+
+  HornClauseDB sdb(efac);
+  HornSimplifyModelConverter mc(z3);
+  HornSimplifyStats stats = simplifyHornClauseDB(db, sdb, mc);
+
+  CHECK(stats.m_argsAfter == 1);
+  for (Expr rel : sdb.getRelations())
+    for (unsigned k = 0, sz = bind::domainSz(rel); k < sz; ++k)
+      CHECK(bind::domainTy(rel, k) != arrTy);
+
+  ZFixedPoint<EZ3> fp(z3);
+  loadFixedPoint(sdb, fp, z3);
+  boost::tribool res = fp.query();
+  CHECK(static_cast<bool>(!res));
+
+  HornDbModel smodel, model;
+  initDBModelFromFP(smodel, sdb, fp);
+  CHECK(mc.convert(smodel, model));
+  CHECK(isModel(db, model, z3));
+}
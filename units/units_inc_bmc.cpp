@@ -0,0 +1,115 @@
+/**==-- Incremental BMC Engine Tests --==*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "seahorn/Analysis/CutPointGraph.hh"
+#include "seahorn/Bmc.hh"
+#include "seahorn/UfoOpSem.hh"
+
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace seahorn;
+
+static const char *loopIR = R"IR(
+define i32 @main() {
+entry:
+  br label %loop
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i1, %body ]
+  %c = icmp slt i32 %i, 1
+  br i1 %c, label %body, label %exit
+body:
+  %i1 = add i32 %i, 1
+  br label %loop
+exit:
+  ret i32 %i
+}
+)IR";
+
+namespace {
+/// Validates two traces of main that share a prefix with one engine
+struct TwoTraces : public ModulePass {
+  static char ID;
+
+  boost::tribool m_res[2];
+  unsigned m_encoded[2];
+  unsigned m_reused[2];
+
+  TwoTraces() : ModulePass(ID) {}
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesAll();
+    AU.addRequired<CutPointGraph>();
+  }
+
+  bool runOnModule(Module &M) override {
+    Function &F = *M.getFunction("main");
+    const CutPointGraph &cpg = getAnalysis<CutPointGraph>(F);
+    auto cp = [&](const char *name) {
+      for (const BasicBlock &bb : F)
+        if (bb.getName() == name)
+          return &cpg.getCp(bb);
+      return static_cast<const CutPoint *>(nullptr);
+    };
+    const CutPoint *entry = cp("entry"), *loop = cp("loop"), *exit = cp("exit");
+
+    ExprFactory efac;
+    EZ3 zctx(efac);
+    UfoOpSem sem(efac, *this, M.getDataLayout());
+    IncBmcEngine bmc(sem, zctx);
+
+    // -- one iteration of the loop, feasible
+    std::vector<const CutPoint *> once = {entry, loop, loop, exit};
+    // -- two iterations, infeasible since the loop runs once
+    std::vector<const CutPoint *> twice = {entry, loop, loop, loop, exit};
+
+    bmc.setTrace(once);
+    m_res[0] = bmc.solve();
+    m_encoded[0] = bmc.numEncodedEdges();
+    m_reused[0] = bmc.numReusedEdges();
+
+    bmc.setTrace(twice);
+    m_res[1] = bmc.solve();
+    m_encoded[1] = bmc.numEncodedEdges() - m_encoded[0];
+    m_reused[1] = bmc.numReusedEdges() - m_reused[0];
+    return false;
+  }
+};
+char TwoTraces::ID = 0;
+} // namespace
+
+TEST_CASE("inc_bmc.shared_prefix") {
+  LLVMContext ctx;
+  SMDiagnostic err;
+  std::unique_ptr<Module> m = parseAssemblyString(loopIR, err, ctx);
+  if (!m) {
+    err.print("units_inc_bmc", errs());
+    report_fatal_error("cannot parse test module");
+  }
+
+  TwoTraces *pass = new TwoTraces();
+  legacy::PassManager pm;
+  pm.add(pass);
+  pm.run(*m);
+
+  CHECK(bool(pass->m_res[0]));
+  CHECK(pass->m_encoded[0] == 3);
+  CHECK(pass->m_reused[0] == 0);
+
+  // -- the second trace takes the loop edge a second time: only that
+  // -- occurrence is encoded
+  CHECK(bool(!pass->m_res[1]));
+  CHECK(pass->m_encoded[1] == 1);
+  CHECK(pass->m_reused[1] == 3);
+}
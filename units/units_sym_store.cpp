@@ -0,0 +1,88 @@
+/**==-- Symbolic Store Tests --==*/
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "seahorn/Support/PersistentMap.hh"
+#include "seahorn/SymStore.hh"
+
+#include "seahorn/Expr/ExprOpBinder.hh"
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace seahorn;
+
+namespace {
+/// a hash under which every key collides
+struct ConstHash {
+  size_t operator()(unsigned) const { return 7; }
+};
+
+template <typename M> std::map<unsigned, unsigned> toStdMap(const M &m) {
+  std::map<unsigned, unsigned> res;
+  for (auto &kv : m)
+    res[kv.first] = kv.second;
+  return res;
+}
+
+/// Applies the same random writes to a persistent map and to a
+/// std::map, taking snapshots of both along the way, and checks that
+/// every snapshot keeps its contents
+template <typename M> void checkRandom(unsigned num_keys, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned> key(0, num_keys);
+
+  M m;
+  std::map<unsigned, unsigned> ref;
+  std::vector<std::pair<M, std::map<unsigned, unsigned>>> snapshots;
+
+  for (unsigned i = 0; i < 20 * num_keys; ++i) {
+    unsigned k = key(rng);
+    CHECK(m.insert_or_assign(k, i) == (ref.count(k) == 0));
+    ref[k] = i;
+    if (i % 97 == 0)
+      snapshots.push_back({m, ref});
+  }
+
+  CHECK(m.size() == ref.size());
+  CHECK(toStdMap(m) == ref);
+  for (unsigned k = 0; k <= num_keys + 1; ++k) {
+    const unsigned *v = m.lookup(k);
+    CHECK((v ? *v : -1u) == (ref.count(k) ? ref[k] : -1u));
+  }
+  for (auto &s : snapshots) {
+    CHECK(s.first.size() == s.second.size());
+    CHECK(toStdMap(s.first) == s.second);
+  }
+}
+} // namespace
+
+TEST_CASE("persistent_map.random") {
+  checkRandom<PersistentMap<unsigned, unsigned>>(5000, 42);
+}
+
+TEST_CASE("persistent_map.collisions") {
+  checkRandom<PersistentMap<unsigned, unsigned, ConstHash>>(100, 7);
+}
+
+TEST_CASE("sym_store.snapshot") {
+  ExprFactory efac;
+  Expr x = bind::intConst(mkTerm<std::string>("x", efac));
+  Expr y = bind::intConst(mkTerm<std::string>("y", efac));
+
+  SymStore s(efac);
+  s.write(x, mkTerm<expr::mpz_class>(1UL, efac));
+  SymStore snap(s);
+  s.write(x, mkTerm<expr::mpz_class>(2UL, efac));
+  s.write(y, mkTerm<expr::mpz_class>(3UL, efac));
+
+  CHECK(s.size() == 2);
+  CHECK(snap.size() == 1);
+  CHECK(s.at(x) == mkTerm<expr::mpz_class>(2UL, efac));
+  CHECK(snap.at(x) == mkTerm<expr::mpz_class>(1UL, efac));
+  CHECK(!snap.isDefined(y));
+  CHECK(snap.eval(mk<PLUS>(x, y)) ==
+        mk<PLUS>(mkTerm<expr::mpz_class>(1UL, efac), y));
+}
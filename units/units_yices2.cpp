@@ -262,4 +262,25 @@ TEST_CASE("yices2-int-bv.test") {
 }
 
 
+TEST_CASE("yices2-deep-bv.test") {
+  expr::ExprFactory efac;
+
+  // -- a chain of additions deep enough to overflow the stack of a
+  // -- recursive encoder
+  Expr x = op::bv::bvConst(mkTerm<string>("x", efac), 32);
+  Expr one = op::bv::bvnum(expr::mpz_class(1), 32, efac);
+  Expr sum = x;
+  const unsigned depth = 100000;
+  for (unsigned i = 0; i < depth; ++i)
+    sum = mk<BADD>(sum, one);
+
+  ExprVector fs;
+  fs.push_back(mk<EQ>(x, op::bv::bvnum(expr::mpz_class(0), 32, efac)));
+  fs.push_back(mk<EQ>(sum, op::bv::bvnum(expr::mpz_class(depth), 32, efac)));
+
+  seahorn::solver::yices_solver_impl yices_solver(efac);
+  CHECK(yices_solver.add(fs));
+  CHECK(yices_solver.check() == seahorn::solver::SolverResult::SAT);
+}
+
 #endif 